@@ -26,6 +26,13 @@ public class GizmoSystem : ModuleRules
 				"Slate",
 				"SlateCore",
 				"InputCore",
+				"ApplicationCore",
+				"RenderCore",
+				"RHI",
+				"Projects",
+				"NetCore",
+				"Sockets",
+				"Networking",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
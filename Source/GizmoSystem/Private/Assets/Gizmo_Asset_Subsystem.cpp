@@ -0,0 +1,81 @@
+#include "Assets/Gizmo_Asset_Subsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Components/StaticMeshComponent.h"
+#include "Materials/MaterialInterface.h"
+
+void UGizmoAssetSubsystem::Deinitialize()
+{
+	for (const TSharedPtr<FStreamableHandle>& EachHandle : this->Handles)
+	{
+		if (EachHandle.IsValid())
+		{
+			EachHandle->ReleaseHandle();
+		}
+	}
+
+	this->Handles.Empty();
+
+	Super::Deinitialize();
+}
+
+UGizmoAssetSubsystem* UGizmoAssetSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UGizmoAssetSubsystem>() : nullptr;
+}
+
+void UGizmoAssetSubsystem::RequestAssets(const TArray<FSoftObjectPath>& Paths, FStreamableDelegate OnLoaded)
+{
+	TArray<FSoftObjectPath> MissingPaths;
+
+	for (const FSoftObjectPath& EachPath : Paths)
+	{
+		if (!EachPath.IsNull() && !EachPath.ResolveObject())
+		{
+			MissingPaths.AddUnique(EachPath);
+		}
+	}
+
+	if (MissingPaths.IsEmpty())
+	{
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+
+	// Paths already in flight are merged by the streamable manager, so gizmos spawned during the load share one request.
+	TSharedPtr<FStreamableHandle> Handle = this->StreamableManager.RequestAsyncLoad(MissingPaths, OnLoaded, FStreamableManager::AsyncLoadHighPriority);
+
+	if (Handle.IsValid())
+	{
+		this->Handles.Add(Handle);
+	}
+
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Assets : Async load request failed, gizmo handles keep their current visuals."));
+	}
+}
+
+void UGizmoAssetSubsystem::Preload(const TArray<FSoftObjectPath>& Paths)
+{
+	this->RequestAssets(Paths, FStreamableDelegate());
+}
+
+void UGizmoAssetSubsystem::ApplyToHandle(UStaticMeshComponent* Handle, const TSoftObjectPtr<UStaticMesh>& Mesh, const TSoftObjectPtr<UMaterialInterface>& Material)
+{
+	if (!IsValid(Handle))
+	{
+		return;
+	}
+
+	if (!IsValid(Handle->GetStaticMesh()) && IsValid(Mesh.Get()))
+	{
+		Handle->SetStaticMesh(Mesh.Get());
+	}
+
+	if (Handle->GetNumOverrideMaterials() == 0 && IsValid(Material.Get()))
+	{
+		Handle->SetMaterial(0, Material.Get());
+	}
+}
@@ -0,0 +1,858 @@
+#include "Commandlets/Gizmo_Benchmark_Commandlet.h"
+
+#include "Math/Gizmo_Math_Base.h"
+#include "Math/Gizmo_Math_Move.h"
+#include "Math/Gizmo_Math_Rotate.h"
+#include "Input/Gizmo_Input_Recorder.h"
+#include "Net/Gizmo_Control_Subsystem.h"
+#include "Snap/Gizmo_Snap_Hash.h"
+#include "Trace/CustomCollision.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Components/ChildActorComponent.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTime.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+static const FIntPoint GizmoBenchmarkViewSize = FIntPoint(1920, 1080);
+static constexpr int32 GizmoBenchmarkSamplesPerFrame = 4;
+static constexpr float GizmoBenchmarkDeltaTime = 1.f / 60.f;
+
+// A snap query has to stay under this, whatever the baseline says.
+static constexpr double GizmoBenchmarkSnapQueryBudgetMs = 0.1;
+
+// A control batch that is not acknowledged within this long fails the scenario.
+static constexpr double GizmoBenchmarkControlTimeout = 5;
+
+// Transforms the control channel has to apply per second, parsing and acks included.
+static constexpr double GizmoBenchmarkControlMinTransformsPerSecond = 20000;
+
+// Allocations of the current thread since GizmoBeginCountingAllocs. Only the thread that asked is counted, so worker threads can not race on it.
+static thread_local bool bGizmoCountAllocs = false;
+static thread_local int64 GizmoNumAllocs = 0;
+
+// Forwards everything to the real allocator. Installed once and never removed, so threads that still hold the previous GMalloc keep a valid allocator.
+class FGizmoCountingMalloc final : public FMalloc
+{
+public:
+
+	FGizmoCountingMalloc(FMalloc* InInner) : Inner(InInner)
+	{
+
+	}
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		if (bGizmoCountAllocs)
+		{
+			GizmoNumAllocs++;
+		}
+
+		return this->Inner->Malloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (bGizmoCountAllocs && Count > 0)
+		{
+			GizmoNumAllocs++;
+		}
+
+		return this->Inner->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override
+	{
+		this->Inner->Free(Original);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return this->Inner->QuantizeSize(Count, Alignment);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return this->Inner->GetAllocationSize(Original, SizeOut);
+	}
+
+	virtual void Trim(bool bTrimThreadCaches) override
+	{
+		this->Inner->Trim(bTrimThreadCaches);
+	}
+
+	virtual void SetupTLSCachesOnCurrentThread() override
+	{
+		this->Inner->SetupTLSCachesOnCurrentThread();
+	}
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+	{
+		this->Inner->ClearAndDisableTLSCachesOnCurrentThread();
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return this->Inner->IsInternallyThreadSafe();
+	}
+
+	virtual bool ValidateHeap() override
+	{
+		return this->Inner->ValidateHeap();
+	}
+
+	virtual void UpdateStats() override
+	{
+		this->Inner->UpdateStats();
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return TEXT("GizmoCountingMalloc");
+	}
+
+	FMalloc* Inner = nullptr;
+};
+
+static void GizmoInstallCountingMalloc()
+{
+	static FGizmoCountingMalloc* CountingMalloc = nullptr;
+
+	if (CountingMalloc)
+	{
+		return;
+	}
+
+	// FMalloc news itself through the system allocator, so this does not go through the GMalloc it wraps.
+	CountingMalloc = new FGizmoCountingMalloc(GMalloc);
+	FPlatformAtomics::InterlockedExchangePtr((void**)&GMalloc, CountingMalloc);
+}
+
+static void GizmoBeginCountingAllocs()
+{
+	GizmoNumAllocs = 0;
+	bGizmoCountAllocs = true;
+}
+
+static int64 GizmoEndCountingAllocs()
+{
+	bGizmoCountAllocs = false;
+	return GizmoNumAllocs;
+}
+
+// Accumulates the measured frames of one scenario.
+struct FGizmoBenchmarkCounter
+{
+	double Seconds = 0;
+	int64 NumAllocs = 0;
+	int64 NumTransformUpdates = 0;
+	int32 NumFrames = 0;
+
+	FGizmoBenchmarkResult ToResult(const FString& Name) const
+	{
+		FGizmoBenchmarkResult Result;
+		Result.Name = Name;
+
+		if (this->NumFrames > 0)
+		{
+			Result.MsPerFrame = this->Seconds * 1000 / this->NumFrames;
+			Result.AllocsPerFrame = (double)this->NumAllocs / this->NumFrames;
+			Result.TransformUpdatesPerFrame = (double)this->NumTransformUpdates / this->NumFrames;
+		}
+
+		return Result;
+	}
+};
+
+// Scripted cursor path. A circle around the screen center, so both move and rotate see every direction.
+static FVector2D GizmoBenchmarkMousePosition(int32 Frame)
+{
+	const double Angle = Frame * (UE_DOUBLE_PI / 60);
+	return FVector2D(GizmoBenchmarkViewSize) * 0.5 + FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * 200;
+}
+
+UGizmoBenchmarkCommandlet::UGizmoBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+UWorld* UGizmoBenchmarkCommandlet::CreateBenchmarkWorld()
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("GizmoBenchmark"));
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+
+	// There is no game mode, so begin play is dispatched directly. Actors spawned after this begin play on spawn.
+	AWorldSettings* WorldSettings = World->GetWorldSettings();
+
+	if (IsValid(WorldSettings))
+	{
+		WorldSettings->NotifyBeginPlay();
+	}
+
+	return World;
+}
+
+void UGizmoBenchmarkCommandlet::DestroyBenchmarkWorld(UWorld* World)
+{
+	if (!IsValid(World))
+	{
+		return;
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+FGizmoBenchmarkResult UGizmoBenchmarkCommandlet::RunGizmoScenario(const FString& Name, UClass* GizmoClass, int32 NumTargets, bool bMoveLocal)
+{
+	// Counter outlives the targets' delegates, the world is destroyed before returning.
+	FGizmoBenchmarkCounter Counter;
+	UWorld* World = this->CreateBenchmarkWorld();
+
+	// Targets live on one holder actor, laid out on a square grid around the origin.
+	AActor* TargetHolder = World->SpawnActor<AActor>();
+	TArray<USceneComponent*> Targets;
+	Targets.Reserve(NumTargets);
+
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((double)NumTargets));
+
+	for (int32 TargetIndex = 0; TargetIndex < NumTargets; TargetIndex++)
+	{
+		USceneComponent* EachTarget = NewObject<USceneComponent>(TargetHolder);
+		EachTarget->SetMobility(EComponentMobility::Movable);
+		EachTarget->RegisterComponent();
+		EachTarget->SetWorldLocation(FVector((double)(TargetIndex % GridSize - GridSize / 2), (double)(TargetIndex / GridSize - GridSize / 2), 0) * 100);
+		EachTarget->TransformUpdated.AddLambda([&Counter](USceneComponent*, EUpdateTransformFlags, ETeleportType)
+			{
+				Counter.NumTransformUpdates++;
+			});
+
+		Targets.Add(EachTarget);
+	}
+
+	AGizmoMathBase* GizmoBase = World->SpawnActor<AGizmoMathBase>();
+	GizmoBase->GizmoType->SetChildActorClass(GizmoClass);
+	GizmoBase->GizmoTarget = Targets[0];
+	GizmoBase->GizmoTargets = Targets;
+
+	AActor* ChildGizmo = GizmoBase->GizmoType->GetChildActor();
+
+	if (AGizmoMathMove* GizmoMove = Cast<AGizmoMathMove>(ChildGizmo))
+	{
+		GizmoMove->bMoveLocal = bMoveLocal;
+		GizmoMove->AxisEnum = ESelectedAxis::X_Axis;
+	}
+
+	else if (AGizmoMathRotate* GizmoRotate = Cast<AGizmoMathRotate>(ChildGizmo))
+	{
+		GizmoRotate->AxisEnum = ESelectedAxis::Z_Axis;
+	}
+
+	FGizmoInputFrame Frame;
+	Frame.View.Build(FVector(-600, -300, 400), FRotator(-30, 25, 0), 90, GizmoBenchmarkViewSize);
+
+	const TArray<FKey> PressedKeys = { EKeys::LeftMouseButton };
+
+	for (int32 FrameIndex = 0; FrameIndex < this->NumWarmupFrames + this->NumFrames; FrameIndex++)
+	{
+		const FVector2D Previous = GizmoBenchmarkMousePosition(FrameIndex);
+		const FVector2D Next = GizmoBenchmarkMousePosition(FrameIndex + 1);
+
+		Frame.MousePosition = Next;
+		Frame.MouseDelta = Next - Previous;
+		Frame.Samples.Reset();
+
+		for (int32 SampleIndex = 1; SampleIndex <= GizmoBenchmarkSamplesPerFrame; SampleIndex++)
+		{
+			Frame.Samples.Add(FMath::Lerp(Previous, Next, (double)SampleIndex / GizmoBenchmarkSamplesPerFrame));
+		}
+
+		GizmoBase->InjectInput(Frame, PressedKeys);
+
+		const bool bMeasure = FrameIndex >= this->NumWarmupFrames;
+
+		if (!bMeasure)
+		{
+			World->Tick(LEVELTICK_All, GizmoBenchmarkDeltaTime);
+			Counter.NumTransformUpdates = 0;
+			continue;
+		}
+
+		GizmoBeginCountingAllocs();
+
+		const double StartTime = FPlatformTime::Seconds();
+		World->Tick(LEVELTICK_All, GizmoBenchmarkDeltaTime);
+		Counter.Seconds += FPlatformTime::Seconds() - StartTime;
+
+		Counter.NumAllocs += GizmoEndCountingAllocs();
+		Counter.NumFrames++;
+
+		GFrameCounter++;
+	}
+
+	this->DestroyBenchmarkWorld(World);
+	return Counter.ToResult(Name);
+}
+
+FGizmoBenchmarkResult UGizmoBenchmarkCommandlet::RunExtentsScenario(const FString& Name, int32 NumCorners)
+{
+	FGizmoBenchmarkCounter Counter;
+	UWorld* World = this->CreateBenchmarkWorld();
+
+	AActor* CollisionHolder = World->SpawnActor<AActor>();
+	UCustomCollision* Collision = NewObject<UCustomCollision>(CollisionHolder);
+	Collision->RegisterComponent();
+	Collision->GetBodySetup();
+
+	// Fibonacci sphere, so every corner is on the hull.
+	TArray<FVector> BaseCorners;
+	BaseCorners.Reserve(NumCorners);
+
+	for (int32 CornerIndex = 0; CornerIndex < NumCorners; CornerIndex++)
+	{
+		const double Height = 1 - (2 * (CornerIndex + 0.5) / NumCorners);
+		const double Radius = FMath::Sqrt(1 - Height * Height);
+		const double Angle = CornerIndex * UE_DOUBLE_PI * (3 - FMath::Sqrt(5.0));
+
+		BaseCorners.Add(FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, Height) * 100);
+	}
+
+	TArray<FVector> Corners;
+
+	for (int32 FrameIndex = 0; FrameIndex < this->NumWarmupFrames + this->NumFrames; FrameIndex++)
+	{
+		// Different extents each frame, like a user dragging a corner.
+		const double Scale = 1 + 0.25 * FMath::Sin(FrameIndex * 0.1);
+
+		Corners.Reset(NumCorners);
+
+		for (const FVector& EachCorner : BaseCorners)
+		{
+			Corners.Add(EachCorner * Scale);
+		}
+
+		if (FrameIndex < this->NumWarmupFrames)
+		{
+			Collision->SetExtents(Corners);
+			continue;
+		}
+
+		GizmoBeginCountingAllocs();
+
+		const double StartTime = FPlatformTime::Seconds();
+		Collision->SetExtents(Corners);
+		Counter.Seconds += FPlatformTime::Seconds() - StartTime;
+
+		Counter.NumAllocs += GizmoEndCountingAllocs();
+		Counter.NumFrames++;
+	}
+
+	this->DestroyBenchmarkWorld(World);
+	return Counter.ToResult(Name);
+}
+
+FGizmoBenchmarkResult UGizmoBenchmarkCommandlet::RunSnapScenario(const FString& Name, int32 NumPoints)
+{
+	FGizmoBenchmarkCounter Counter;
+
+	// The hash alone, the query does not touch the world. Sources of 64 points each, scattered over a 200 m square.
+	static constexpr int32 PointsPerSource = 64;
+
+	FGizmoSnapHash Hash;
+	FRandomStream Random(NumPoints);
+	TArray<FVector> Points;
+
+	for (int32 SourceIndex = 0; SourceIndex * PointsPerSource < NumPoints; SourceIndex++)
+	{
+		const FVector SourceCenter(Random.FRandRange(-10000, 10000), Random.FRandRange(-10000, 10000), 0);
+
+		Points.Reset(PointsPerSource);
+
+		for (int32 PointIndex = 0; PointIndex < PointsPerSource; PointIndex++)
+		{
+			Points.Add(SourceCenter + Random.GetUnitVector() * 100);
+		}
+
+		Hash.SetSource(SourceIndex + 1, Points);
+	}
+
+	// The first sources stand in for the dragged selection.
+	TSet<uint32> ExcludedSources = { 1, 2, 3, 4 };
+
+	FGizmoViewState View;
+	View.Build(FVector(-600, -300, 400), FRotator(-30, 25, 0), 90, GizmoBenchmarkViewSize);
+
+	// Same call as AGizmoMathMove::Snap_Offset.
+	TArray<FGizmoSnapCandidate> Candidates;
+
+	for (int32 FrameIndex = 0; FrameIndex < this->NumWarmupFrames + this->NumFrames; FrameIndex++)
+	{
+		const FVector2D MousePosition = GizmoBenchmarkMousePosition(FrameIndex);
+
+		if (FrameIndex < this->NumWarmupFrames)
+		{
+			Hash.QueryScreen(View, MousePosition, 12, 100000, 1, ExcludedSources, Candidates);
+			continue;
+		}
+
+		GizmoBeginCountingAllocs();
+
+		const double StartTime = FPlatformTime::Seconds();
+		Hash.QueryScreen(View, MousePosition, 12, 100000, 1, ExcludedSources, Candidates);
+		Counter.Seconds += FPlatformTime::Seconds() - StartTime;
+
+		Counter.NumAllocs += GizmoEndCountingAllocs();
+		Counter.NumFrames++;
+	}
+
+	FGizmoBenchmarkResult Result = Counter.ToResult(Name);
+	Result.MaxMsPerFrame = GizmoBenchmarkSnapQueryBudgetMs;
+
+	return Result;
+}
+
+FGizmoBenchmarkResult UGizmoBenchmarkCommandlet::RunReplayScenario(const FString& Name, const FString& RecordingPath, int32& Out_NumMismatches)
+{
+	Out_NumMismatches = 0;
+
+	FGizmoInputRecording Recording;
+
+	if (!FGizmoInputRecorder::Read(RecordingPath, Recording) || Recording.Frames.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : Recording %s could not be read."), *RecordingPath);
+		Out_NumMismatches = 1;
+		return FGizmoBenchmarkResult();
+	}
+
+	FGizmoBenchmarkCounter Counter;
+	UWorld* World = this->CreateBenchmarkWorld();
+	FGizmoInputReplayer Replayer(Recording);
+
+	if (!Replayer.Begin(World))
+	{
+		this->DestroyBenchmarkWorld(World);
+		Out_NumMismatches = 1;
+		return FGizmoBenchmarkResult();
+	}
+
+	for (USceneComponent* EachTarget : Replayer.GetTargetPool())
+	{
+		EachTarget->TransformUpdated.AddLambda([&Counter](USceneComponent*, EUpdateTransformFlags, ETeleportType)
+			{
+				Counter.NumTransformUpdates++;
+			});
+	}
+
+	// Every frame is played so the result matches the recording. Warmup frames are only left out of the measurement.
+
+	for (int32 FrameIndex = 0; FrameIndex < Recording.Frames.Num(); FrameIndex++)
+	{
+		const float DeltaTime = Replayer.ApplyFrame(FrameIndex);
+
+		if (FrameIndex < this->NumWarmupFrames)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+			Counter.NumTransformUpdates = 0;
+			continue;
+		}
+
+		GizmoBeginCountingAllocs();
+
+		const double StartTime = FPlatformTime::Seconds();
+		World->Tick(LEVELTICK_All, DeltaTime);
+		Counter.Seconds += FPlatformTime::Seconds() - StartTime;
+
+		Counter.NumAllocs += GizmoEndCountingAllocs();
+		Counter.NumFrames++;
+
+		GFrameCounter++;
+	}
+
+	Replayer.Finish();
+	Out_NumMismatches = Replayer.GetNumMismatches();
+
+	this->DestroyBenchmarkWorld(World);
+	return Counter.ToResult(Name);
+}
+
+FGizmoBenchmarkResult UGizmoBenchmarkCommandlet::RunControlScenario(const FString& Name, int32 NumTargets)
+{
+	FGizmoBenchmarkCounter Counter;
+	UWorld* World = this->CreateBenchmarkWorld();
+	UGizmoControlSubsystem* ControlSubsystem = World->GetSubsystem<UGizmoControlSubsystem>();
+
+	FGizmoBenchmarkResult FailedResult;
+	FailedResult.Name = Name;
+	FailedResult.bFailed = true;
+
+	if (!ControlSubsystem || !ControlSubsystem->StartControlServer(0))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s could not start the control server."), *Name);
+		this->DestroyBenchmarkWorld(World);
+		return FailedResult;
+	}
+
+	AActor* TargetHolder = World->SpawnActor<AActor>();
+	TArray<USceneComponent*> Targets;
+	Targets.Reserve(NumTargets);
+
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((double)NumTargets));
+
+	for (int32 TargetIndex = 0; TargetIndex < NumTargets; TargetIndex++)
+	{
+		USceneComponent* EachTarget = NewObject<USceneComponent>(TargetHolder);
+		EachTarget->SetMobility(EComponentMobility::Movable);
+		EachTarget->RegisterComponent();
+		EachTarget->TransformUpdated.AddLambda([&Counter](USceneComponent*, EUpdateTransformFlags, ETeleportType)
+			{
+				Counter.NumTransformUpdates++;
+			});
+
+		Targets.Add(EachTarget);
+	}
+
+	FGizmoControlClient Client;
+
+	if (!Client.Connect(ControlSubsystem->GetControlPort()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s could not connect to port %d."), *Name, ControlSubsystem->GetControlPort());
+		this->DestroyBenchmarkWorld(World);
+		return FailedResult;
+	}
+
+	// Ticks until the server has answered Count messages or the timeout is hit.
+	TArray<FGizmoControlAck> Acks;
+
+	auto TickUntilAcks = [&](int32 Count)
+		{
+			const double EndTime = FPlatformTime::Seconds() + GizmoBenchmarkControlTimeout;
+
+			while (Acks.Num() < Count && FPlatformTime::Seconds() < EndTime)
+			{
+				World->Tick(LEVELTICK_All, GizmoBenchmarkDeltaTime);
+				Client.ReceiveAcks(Acks, Count - Acks.Num(), 0.002);
+			}
+
+			return Acks.Num() >= Count;
+		};
+
+	// Request id of a resolve is the target index plus one.
+	TArray<uint8> Buffer;
+
+	for (int32 TargetIndex = 0; TargetIndex < NumTargets; TargetIndex++)
+	{
+		FGizmoControlProtocol::WriteResolve(Buffer, TargetIndex + 1, Targets[TargetIndex]->GetPathName());
+	}
+
+	Client.Send(Buffer);
+
+	if (!TickUntilAcks(NumTargets))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s resolved %d of %d targets."), *Name, Acks.Num(), NumTargets);
+		this->DestroyBenchmarkWorld(World);
+		return FailedResult;
+	}
+
+	TArray<uint32> Ids;
+	Ids.SetNumZeroed(NumTargets);
+
+	for (const FGizmoControlAck& EachAck : Acks)
+	{
+		// Malformed acks echo whatever request id could be read, which may be none of ours.
+		if (EachAck.RequestId == 0 || EachAck.RequestId > (uint32)NumTargets || EachAck.Status != EGizmoControlStatus::Ok)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s got status %d for resolve request %u."), *Name, (int32)EachAck.Status, EachAck.RequestId);
+			this->DestroyBenchmarkWorld(World);
+			return FailedResult;
+		}
+
+		Ids[EachAck.RequestId - 1] = EachAck.Value;
+	}
+
+	TArray<FTransform> Transforms;
+	Transforms.SetNum(NumTargets);
+
+	bool bCompleted = true;
+
+	// One batch per frame. A frame is measured from the send until its ack is back, so it covers parsing, the game thread pass and the writes.
+	for (int32 FrameIndex = 0; FrameIndex < this->NumWarmupFrames + this->NumFrames; FrameIndex++)
+	{
+		const FVector Offset(0, 0, FMath::Sin(FrameIndex * 0.1) * 100);
+
+		for (int32 TargetIndex = 0; TargetIndex < NumTargets; TargetIndex++)
+		{
+			Transforms[TargetIndex].SetLocation(FVector((double)(TargetIndex % GridSize - GridSize / 2), (double)(TargetIndex / GridSize - GridSize / 2), 0) * 100 + Offset);
+		}
+
+		Buffer.Reset();
+		FGizmoControlProtocol::WriteTransforms(Buffer, EGizmoControlMessage::Set_Transforms, NumTargets + FrameIndex + 1, Ids, Transforms);
+		Acks.Reset();
+
+		const bool bMeasure = FrameIndex >= this->NumWarmupFrames;
+
+		if (!bMeasure)
+		{
+			Client.Send(Buffer);
+			TickUntilAcks(1);
+			Counter.NumTransformUpdates = 0;
+			continue;
+		}
+
+		GizmoBeginCountingAllocs();
+
+		const double StartTime = FPlatformTime::Seconds();
+		Client.Send(Buffer);
+		const bool bAcknowledged = TickUntilAcks(1);
+		Counter.Seconds += FPlatformTime::Seconds() - StartTime;
+
+		Counter.NumAllocs += GizmoEndCountingAllocs();
+		Counter.NumFrames++;
+
+		GFrameCounter++;
+
+		if (!bAcknowledged || Acks[0].Status != EGizmoControlStatus::Ok)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s batch %d was not applied."), *Name, FrameIndex);
+			bCompleted = false;
+			break;
+		}
+	}
+
+	if (Counter.Seconds > 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Gizmo Benchmark : %s applied %.0f transforms per second."), *Name, Counter.NumTransformUpdates / Counter.Seconds);
+	}
+
+	Client.Close();
+
+	this->DestroyBenchmarkWorld(World);
+
+	// The throughput floor as a frame budget, so Main checks it like any other.
+	FGizmoBenchmarkResult Result = Counter.ToResult(Name);
+	Result.MaxMsPerFrame = NumTargets * 1000.0 / GizmoBenchmarkControlMinTransformsPerSecond;
+	Result.bFailed = !bCompleted;
+
+	return Result;
+}
+
+FString UGizmoBenchmarkCommandlet::GetBaselinePath() const
+{
+	TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("GizmoSystem"));
+
+	if (!Plugin.IsValid())
+	{
+		return FString();
+	}
+
+	return FPaths::Combine(Plugin->GetBaseDir(), TEXT("Config"), TEXT("GizmoBenchmarkBaseline.csv"));
+}
+
+bool UGizmoBenchmarkCommandlet::LoadBaseline(TMap<FString, FGizmoBenchmarkResult>& Out_Baseline) const
+{
+	Out_Baseline.Reset();
+
+	TArray<FString> Lines;
+
+	if (!FFileHelper::LoadFileToStringArray(Lines, *this->GetBaselinePath()))
+	{
+		return false;
+	}
+
+	// Empty cells were never measured and fail the run. They are filled on the reference machine with -WriteBaseline.
+	auto ParseCell = [](const FString& Cell)
+		{
+			return Cell.TrimStartAndEnd().IsEmpty() ? -1.0 : FCString::Atod(*Cell);
+		};
+
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); LineIndex++)
+	{
+		TArray<FString> Cells;
+		Lines[LineIndex].ParseIntoArray(Cells, TEXT(","), false);
+
+		if (Cells.Num() < 4 || Cells[0].TrimStartAndEnd().IsEmpty())
+		{
+			continue;
+		}
+
+		FGizmoBenchmarkResult Entry;
+		Entry.Name = Cells[0].TrimStartAndEnd();
+		Entry.MsPerFrame = ParseCell(Cells[1]);
+		Entry.AllocsPerFrame = ParseCell(Cells[2]);
+		Entry.TransformUpdatesPerFrame = ParseCell(Cells[3]);
+
+		Out_Baseline.Add(Entry.Name, Entry);
+	}
+
+	return true;
+}
+
+bool UGizmoBenchmarkCommandlet::SaveBaseline(const TArray<FGizmoBenchmarkResult>& Results) const
+{
+	FString Content = TEXT("Scenario,MsPerFrame,AllocsPerFrame,TransformUpdatesPerFrame\n");
+
+	for (const FGizmoBenchmarkResult& EachResult : Results)
+	{
+		Content += FString::Printf(TEXT("%s,%.4f,%.1f,%.1f\n"), *EachResult.Name, EachResult.MsPerFrame, EachResult.AllocsPerFrame, EachResult.TransformUpdatesPerFrame);
+	}
+
+	return FFileHelper::SaveStringToFile(Content, *this->GetBaselinePath());
+}
+
+int32 UGizmoBenchmarkCommandlet::Main(const FString& Params)
+{
+	FParse::Value(*Params, TEXT("Frames="), this->NumFrames);
+	FParse::Value(*Params, TEXT("Tolerance="), this->Tolerance);
+
+	FString Filter;
+	FParse::Value(*Params, TEXT("Filter="), Filter);
+
+	const bool bWriteBaseline = FParse::Param(*Params, TEXT("WriteBaseline"));
+	this->NumFrames = FMath::Max(this->NumFrames, 1);
+
+	GizmoInstallCountingMalloc();
+
+	FString ReplayPath;
+
+	if (FParse::Value(*Params, TEXT("Replay="), ReplayPath))
+	{
+		int32 NumMismatches = 0;
+		const FGizmoBenchmarkResult Result = this->RunReplayScenario(TEXT("Replay_") + FPaths::GetBaseFilename(ReplayPath), ReplayPath, NumMismatches);
+
+		UE_LOG(LogTemp, Display, TEXT("Gizmo Benchmark : %-18s %10.4f ms %12.1f allocs %12.1f transform updates"), *Result.Name, Result.MsPerFrame, Result.AllocsPerFrame, Result.TransformUpdatesPerFrame);
+
+		if (NumMismatches > 0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s diverged from the recording on %d frames."), *ReplayPath, NumMismatches);
+			return 1;
+		}
+
+		return 0;
+	}
+
+	TArray<TPair<FString, TFunction<FGizmoBenchmarkResult(const FString&)>>> Scenarios;
+
+	for (const int32 NumTargets : { 1, 100, 10000 })
+	{
+		Scenarios.Emplace(FString::Printf(TEXT("Move_Local_%d"), NumTargets), [this, NumTargets](const FString& Name) { return this->RunGizmoScenario(Name, AGizmoMathMove::StaticClass(), NumTargets, true); });
+		Scenarios.Emplace(FString::Printf(TEXT("Move_World_%d"), NumTargets), [this, NumTargets](const FString& Name) { return this->RunGizmoScenario(Name, AGizmoMathMove::StaticClass(), NumTargets, false); });
+		Scenarios.Emplace(FString::Printf(TEXT("Rotate_%d"), NumTargets), [this, NumTargets](const FString& Name) { return this->RunGizmoScenario(Name, AGizmoMathRotate::StaticClass(), NumTargets, false); });
+	}
+
+	for (const int32 NumCorners : { 8, 64, 256 })
+	{
+		Scenarios.Emplace(FString::Printf(TEXT("Extents_%d"), NumCorners), [this, NumCorners](const FString& Name) { return this->RunExtentsScenario(Name, NumCorners); });
+	}
+
+	Scenarios.Emplace(TEXT("Snap_100000"), [this](const FString& Name) { return this->RunSnapScenario(Name, 100000); });
+	Scenarios.Emplace(TEXT("Control_10000"), [this](const FString& Name) { return this->RunControlScenario(Name, 10000); });
+
+	TArray<FGizmoBenchmarkResult> Results;
+
+	for (const TPair<FString, TFunction<FGizmoBenchmarkResult(const FString&)>>& EachScenario : Scenarios)
+	{
+		if (!Filter.IsEmpty() && !EachScenario.Key.Contains(Filter))
+		{
+			continue;
+		}
+
+		Results.Add(EachScenario.Value(EachScenario.Key));
+	}
+
+	if (bWriteBaseline)
+	{
+		// A failed run would commit zeros that every later run passes.
+		for (const FGizmoBenchmarkResult& EachResult : Results)
+		{
+			if (EachResult.bFailed)
+			{
+				UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s did not run to the end, the baseline was not written."), *EachResult.Name);
+				return 1;
+			}
+		}
+
+		if (!this->SaveBaseline(Results))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : Baseline could not be written to %s"), *this->GetBaselinePath());
+			return 1;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("Gizmo Benchmark : Baseline written to %s"), *this->GetBaselinePath());
+		return 0;
+	}
+
+	TMap<FString, FGizmoBenchmarkResult> Baseline;
+
+	if (!this->LoadBaseline(Baseline))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : Baseline %s not found. Run with -WriteBaseline on the reference machine and commit the file."), *this->GetBaselinePath());
+		return 1;
+	}
+
+	int32 NumRegressions = 0;
+
+	auto CheckMetric = [this, &NumRegressions](const FString& Scenario, const TCHAR* Metric, double Value, double BaselineValue)
+		{
+			if (BaselineValue < 0)
+			{
+				UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s has no measured baseline for %s. Run with -WriteBaseline on the reference machine and commit %s."), *Scenario, Metric, *this->GetBaselinePath());
+				NumRegressions++;
+				return;
+			}
+
+			if (Value <= BaselineValue * (1 + this->Tolerance))
+			{
+				return;
+			}
+
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s regressed on %s. %.4f against baseline %.4f."), *Scenario, Metric, Value, BaselineValue);
+			NumRegressions++;
+		};
+
+	for (const FGizmoBenchmarkResult& EachResult : Results)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Gizmo Benchmark : %-18s %10.4f ms %12.1f allocs %12.1f transform updates"), *EachResult.Name, EachResult.MsPerFrame, EachResult.AllocsPerFrame, EachResult.TransformUpdatesPerFrame);
+
+		if (EachResult.bFailed)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s did not run to the end."), *EachResult.Name);
+			NumRegressions++;
+			continue;
+		}
+
+		// Budgets hold on any machine, so they are checked before and regardless of the baseline.
+		if (EachResult.MaxMsPerFrame > 0 && EachResult.MsPerFrame > EachResult.MaxMsPerFrame)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s is over its budget. %.4f ms against %.4f ms."), *EachResult.Name, EachResult.MsPerFrame, EachResult.MaxMsPerFrame);
+			NumRegressions++;
+		}
+
+		const FGizmoBenchmarkResult* BaselineResult = Baseline.Find(EachResult.Name);
+
+		if (!BaselineResult)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Benchmark : %s is missing from the baseline. Run with -WriteBaseline on the reference machine."), *EachResult.Name);
+			NumRegressions++;
+			continue;
+		}
+
+		CheckMetric(EachResult.Name, TEXT("game thread time"), EachResult.MsPerFrame, BaselineResult->MsPerFrame);
+		CheckMetric(EachResult.Name, TEXT("allocations"), EachResult.AllocsPerFrame, BaselineResult->AllocsPerFrame);
+		CheckMetric(EachResult.Name, TEXT("transform updates"), EachResult.TransformUpdatesPerFrame, BaselineResult->TransformUpdatesPerFrame);
+	}
+
+	return NumRegressions > 0 ? 1 : 0;
+}
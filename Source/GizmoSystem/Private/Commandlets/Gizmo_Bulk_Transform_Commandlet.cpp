@@ -0,0 +1,542 @@
+#include "Commandlets/Gizmo_Bulk_Transform_Commandlet.h"
+
+#include "Math/Gizmo_Math_Solver.h"
+#include "Math/Gizmo_Math_Constraints.h"
+#include "History/Gizmo_History.h"
+#include "Trace/CustomCollision.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "Engine/Brush.h"
+#include "GameFramework/WorldSettings.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "UObject/UObjectGlobals.h"
+
+// Points this close behind a hull face still count as inside, in local units of the volume.
+static constexpr double GizmoBulkVolumeTolerance = 0.01;
+
+// "X,Y,Z" into a vector. Returns false when the switch is malformed, Out_bFound tells whether it was passed at all.
+static bool GizmoParseVector(const TCHAR* Params, const TCHAR* Switch, FVector& Out_Vector, bool& Out_bFound)
+{
+	FString Value;
+	Out_bFound = FParse::Value(Params, Switch, Value, false);
+
+	if (!Out_bFound)
+	{
+		return true;
+	}
+
+	TArray<FString> Cells;
+	Value.ParseIntoArray(Cells, TEXT(","), false);
+
+	const bool bIsNumeric = Cells.Num() == 3 && !Cells.ContainsByPredicate([](const FString& EachCell)
+		{
+			const FString Trimmed = EachCell.TrimStartAndEnd();
+			return Trimmed.IsEmpty() || !Trimmed.IsNumeric();
+		});
+
+	if (!bIsNumeric)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gizmo Bulk Transform : %s%s is not X,Y,Z."), Switch, *Value);
+		return false;
+	}
+
+	Out_Vector = FVector(FCString::Atod(*Cells[0]), FCString::Atod(*Cells[1]), FCString::Atod(*Cells[2]));
+	return true;
+}
+
+UGizmoBulkTransformCommandlet::UGizmoBulkTransformCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+bool UGizmoBulkTransformCommandlet::ParseSettings(const FString& Params, FGizmoBulkTransformSettings& Out_Settings) const
+{
+	FString ClassName;
+
+	if (FParse::Value(*Params, TEXT("Class="), ClassName))
+	{
+		// Paths are loaded, Blueprint classes are not in memory yet in a fresh commandlet.
+		Out_Settings.Class = ClassName.StartsWith(TEXT("/")) ? LoadObject<UClass>(nullptr, *ClassName) : UClass::TryFindTypeSlow<UClass>(ClassName);
+
+		if (!Out_Settings.Class)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Bulk Transform : Class %s not found."), *ClassName);
+			return false;
+		}
+	}
+
+	FString TagName;
+
+	if (FParse::Value(*Params, TEXT("Tag="), TagName))
+	{
+		Out_Settings.Tag = FName(*TagName);
+	}
+
+	FParse::Value(*Params, TEXT("Volume="), Out_Settings.Volume);
+
+	if (!Out_Settings.Class && Out_Settings.Tag.IsNone() && Out_Settings.Volume.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gizmo Bulk Transform : At least one of -Class, -Tag or -Volume is required."));
+		return false;
+	}
+
+	// A typo must not turn into a run that silently skips the operation.
+	bool bFound = false;
+	FVector Rotation = FVector::ZeroVector;
+
+	if (!GizmoParseVector(*Params, TEXT("Offset="), Out_Settings.Offset, bFound) || !GizmoParseVector(*Params, TEXT("Scale="), Out_Settings.ScaleRatio, bFound) || !GizmoParseVector(*Params, TEXT("Rotate="), Rotation, bFound))
+	{
+		return false;
+	}
+
+	Out_Settings.Rotation = FRotator(Rotation.X, Rotation.Y, Rotation.Z);
+
+	FString PivotName;
+
+	if (FParse::Value(*Params, TEXT("Pivot="), PivotName, false))
+	{
+		if (PivotName.Equals(TEXT("Selection")))
+		{
+			Out_Settings.PivotMode = EGizmoBulkPivot::Selection;
+		}
+
+		else if (PivotName.Equals(TEXT("Each")))
+		{
+			Out_Settings.PivotMode = EGizmoBulkPivot::Each;
+		}
+
+		else if (GizmoParseVector(*Params, TEXT("Pivot="), Out_Settings.Pivot, bFound))
+		{
+			Out_Settings.PivotMode = EGizmoBulkPivot::Fixed;
+		}
+
+		else
+		{
+			return false;
+		}
+	}
+
+	FParse::Value(*Params, TEXT("Grid="), Out_Settings.GridSize);
+	FParse::Value(*Params, TEXT("RotationSnap="), Out_Settings.RotationSnap);
+	FParse::Value(*Params, TEXT("ScaleSnap="), Out_Settings.ScaleSnap);
+	FParse::Value(*Params, TEXT("Batch="), Out_Settings.BatchSize);
+
+	Out_Settings.bDryRun = FParse::Param(*Params, TEXT("DryRun"));
+	Out_Settings.BatchSize = FMath::Max(Out_Settings.BatchSize, 1);
+
+	const bool bHasOperation = !Out_Settings.Offset.IsZero() || !Out_Settings.Rotation.IsZero() || !Out_Settings.ScaleRatio.Equals(FVector::OneVector)
+		|| Out_Settings.GridSize > 0 || Out_Settings.RotationSnap > 0 || Out_Settings.ScaleSnap > 0;
+
+	if (!bHasOperation)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gizmo Bulk Transform : Nothing to do. Pass -Offset, -Rotate, -Scale or a snap."));
+		return false;
+	}
+
+	return true;
+}
+
+bool UGizmoBulkTransformCommandlet::GatherMaps(const FString& Params, TArray<FString>& Out_PackageNames) const
+{
+	Out_PackageNames.Reset();
+
+	FString Maps;
+
+	if (FParse::Value(*Params, TEXT("Maps="), Maps, false))
+	{
+		Maps.ParseIntoArray(Out_PackageNames, TEXT("+"), true);
+	}
+
+	FString MapPath;
+
+	if (FParse::Value(*Params, TEXT("MapPath="), MapPath, false))
+	{
+		FString Directory;
+
+		if (!FPackageName::TryConvertLongPackageNameToFilename(MapPath / TEXT(""), Directory))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Bulk Transform : %s is not a package path."), *MapPath);
+			return false;
+		}
+
+		TArray<FString> Files;
+		FPackageName::FindPackagesInDirectory(Files, Directory);
+
+		for (const FString& EachFile : Files)
+		{
+			FString PackageName;
+
+			if (FPaths::GetExtension(EachFile, true) == FPackageName::GetMapPackageExtension() && FPackageName::TryConvertFilenameToLongPackageName(EachFile, PackageName))
+			{
+				Out_PackageNames.AddUnique(PackageName);
+			}
+		}
+	}
+
+	if (Out_PackageNames.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gizmo Bulk Transform : No levels. Pass -Maps or -MapPath."));
+		return false;
+	}
+
+	return true;
+}
+
+void UGizmoBulkTransformCommandlet::InitializeLevel(UWorld* World)
+{
+	// Components are registered so world transforms are valid. Nothing that is only needed to play or render is created.
+	World->WorldType = EWorldType::Editor;
+	World->AddToRoot();
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+	WorldContext.SetCurrentWorld(World);
+
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.InitializeScenes(false)
+			.AllowAudioPlayback(false)
+			.RequiresHitProxies(false)
+			.CreatePhysicsScene(false)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(false)
+			.SetTransactional(false)
+			.CreateFXSystem(false));
+	}
+
+	World->UpdateWorldComponents(true, false);
+}
+
+void UGizmoBulkTransformCommandlet::CleanupLevel(UWorld* World)
+{
+	World->ClearWorldComponents();
+	GEngine->DestroyWorldContext(World);
+	World->CleanupWorld();
+	World->RemoveFromRoot();
+}
+
+int32 UGizmoBulkTransformCommandlet::SelectActors(UWorld* World, const FGizmoBulkTransformSettings& Settings, TArray<AActor*>& Out_Actors) const
+{
+	Out_Actors.Reset();
+
+	ULevel* Level = World->PersistentLevel;
+
+	if (!Level)
+	{
+		return 0;
+	}
+
+	// Actors of a partitioned level live in cells that are not loaded here.
+	if (World->GetWorldPartition())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Bulk Transform : %s uses World Partition. Only actors that are always loaded are visited."), *World->GetOutermost()->GetName());
+	}
+
+	const AActor* VolumeActor = nullptr;
+	UCustomCollision* Volume = nullptr;
+	TArray<FPlane> VolumePlanes;
+
+	if (!Settings.Volume.IsEmpty())
+	{
+		for (const AActor* EachActor : Level->Actors)
+		{
+			if (!IsValid(EachActor))
+			{
+				continue;
+			}
+
+			bool bNameMatches = EachActor->GetName().Equals(Settings.Volume);
+
+#if WITH_EDITOR
+			bNameMatches |= EachActor->GetActorLabel().Equals(Settings.Volume);
+#endif
+
+			if (bNameMatches)
+			{
+				VolumeActor = EachActor;
+				Volume = EachActor->FindComponentByClass<UCustomCollision>();
+				break;
+			}
+		}
+
+		if (!Volume)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Gizmo Bulk Transform : %s has no actor %s with a UCustomCollision."), *World->GetOutermost()->GetName(), *Settings.Volume);
+			return 0;
+		}
+
+		Volume->GetHullPlanes(VolumePlanes);
+
+		if (VolumePlanes.IsEmpty())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Gizmo Bulk Transform : %s of %s has no collision hull."), *Settings.Volume, *World->GetOutermost()->GetName());
+			return 0;
+		}
+	}
+
+	for (AActor* EachActor : Level->Actors)
+	{
+		// World settings and brushes are level infrastructure, moving them would need a BSP rebuild or break the level.
+		if (!IsValid(EachActor) || EachActor == VolumeActor || !EachActor->GetRootComponent() || EachActor->IsA<AWorldSettings>() || EachActor->IsA<ABrush>())
+		{
+			continue;
+		}
+
+		if (Settings.Class && !EachActor->IsA(Settings.Class))
+		{
+			continue;
+		}
+
+		if (!Settings.Tag.IsNone() && !EachActor->ActorHasTag(Settings.Tag))
+		{
+			continue;
+		}
+
+		if (Volume)
+		{
+			const FVector LocalLocation = Volume->GetComponentTransform().InverseTransformPosition(EachActor->GetActorLocation());
+
+			const bool bInside = !VolumePlanes.IsEmpty() && !VolumePlanes.ContainsByPredicate([&LocalLocation](const FPlane& Each)
+				{
+					return Each.PlaneDot(LocalLocation) > GizmoBulkVolumeTolerance;
+				});
+
+			if (!bInside)
+			{
+				continue;
+			}
+		}
+
+		Out_Actors.Add(EachActor);
+	}
+
+	return Out_Actors.Num();
+}
+
+int32 UGizmoBulkTransformCommandlet::TransformActors(const TArray<AActor*>& Actors, const FGizmoBulkTransformSettings& Settings, TSet<UPackage*>& Out_DirtyPackages) const
+{
+	if (Actors.IsEmpty())
+	{
+		return 0;
+	}
+
+	TArray<FTransform> StartTransforms;
+	StartTransforms.Reserve(Actors.Num());
+
+	FBox SelectionBox(ForceInit);
+
+	for (const AActor* EachActor : Actors)
+	{
+		StartTransforms.Add(EachActor->GetRootComponent()->GetComponentTransform());
+		SelectionBox += StartTransforms.Last().GetLocation();
+	}
+
+	// Same solver as a gizmo drag. Pivot is per actor for Each, so it is filled in the loop.
+	FGizmoDragDelta Delta;
+	Delta.Translation = Settings.Offset;
+	Delta.Rotation = Settings.Rotation.Quaternion();
+	Delta.ScaleRatio = Settings.ScaleRatio;
+	Delta.ScaleSnap = Settings.ScaleSnap;
+	Delta.Pivot = Settings.PivotMode == EGizmoBulkPivot::Fixed ? Settings.Pivot : SelectionBox.GetCenter();
+
+	// Grid snap stage of the move pipeline. With a zero start the snapped offset is the absolute location.
+	FGizmoConstraintContext GridContext;
+	GridContext.Stages = EGizmoConstraintStage::Axis_Mask | EGizmoConstraintStage::Grid_Snap;
+	GridContext.GridSize = Settings.GridSize;
+
+	TArray<FTransform> NewTransforms;
+	NewTransforms.SetNum(Actors.Num());
+
+	// Pure math, no UObject is touched until the writes below.
+	ParallelFor(Actors.Num(), [&](int32 Index)
+		{
+			FGizmoDragDelta ActorDelta = Delta;
+
+			if (Settings.PivotMode == EGizmoBulkPivot::Each)
+			{
+				ActorDelta.Pivot = StartTransforms[Index].GetLocation();
+			}
+
+			FTransform NewTransform = ActorDelta.Apply(StartTransforms[Index]);
+
+			if (Settings.GridSize > 0)
+			{
+				NewTransform.SetLocation(GizmoApplyConstraints(GridContext, NewTransform.GetLocation()));
+			}
+
+			if (Settings.RotationSnap > 0)
+			{
+				NewTransform.SetRotation(NewTransform.Rotator().GridSnap(FRotator(Settings.RotationSnap)).Quaternion());
+			}
+
+			NewTransforms[Index] = NewTransform;
+		});
+
+	// Actors attached to another selected actor follow it, writing them as well would transform them twice.
+	TSet<const USceneComponent*> SelectedRoots;
+	SelectedRoots.Reserve(Actors.Num());
+
+	for (const AActor* EachActor : Actors)
+	{
+		SelectedRoots.Add(EachActor->GetRootComponent());
+	}
+
+	int32 NumMoved = 0;
+
+	for (int32 Index = 0; Index < Actors.Num(); Index++)
+	{
+		AActor* EachActor = Actors[Index];
+
+		if (NewTransforms[Index].Equals(StartTransforms[Index], UE_KINDA_SMALL_NUMBER) || GizmoIsCarriedByTarget(EachActor->GetRootComponent(), SelectedRoots))
+		{
+			continue;
+		}
+
+		EachActor->Modify();
+		EachActor->GetRootComponent()->SetWorldTransform(NewTransforms[Index], false, nullptr, ETeleportType::TeleportPhysics);
+
+#if WITH_EDITOR
+		EachActor->PostEditMove(true);
+#endif
+
+		// External package for one file per actor levels, the level package otherwise.
+		Out_DirtyPackages.Add(EachActor->GetPackage());
+		NumMoved++;
+	}
+
+	return NumMoved;
+}
+
+int32 UGizmoBulkTransformCommandlet::SavePackages(const TSet<UPackage*>& Packages) const
+{
+	int32 NumFailed = 0;
+
+#if WITH_EDITOR
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Standalone;
+	SaveArgs.SaveFlags = SAVE_NoError;
+
+	for (UPackage* EachPackage : Packages)
+	{
+		const FString Extension = EachPackage->ContainsMap() ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension();
+		const FString Filename = FPackageName::LongPackageNameToFilename(EachPackage->GetName(), Extension);
+
+		// Files checked in read only are left alone. Check them out first, this does not talk to source control.
+		if (IFileManager::Get().IsReadOnly(*Filename))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Bulk Transform : %s is read only."), *Filename);
+			NumFailed++;
+			continue;
+		}
+
+		UObject* Asset = EachPackage->ContainsMap() ? UWorld::FindWorldInPackage(EachPackage) : EachPackage->FindAssetInPackage();
+
+		if (!UPackage::SavePackage(EachPackage, Asset, *Filename, SaveArgs))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Gizmo Bulk Transform : %s could not be saved."), *Filename);
+			NumFailed++;
+		}
+	}
+#endif
+
+	return NumFailed;
+}
+
+int32 UGizmoBulkTransformCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FGizmoBulkTransformSettings Settings;
+	TArray<FString> PackageNames;
+
+	if (!this->ParseSettings(Params, Settings) || !this->GatherMaps(Params, PackageNames))
+	{
+		return 1;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	int32 NumFailed = 0;
+	int32 NumActors = 0;
+	int32 NumSaved = 0;
+
+	TArray<UWorld*> Worlds;
+	TArray<AActor*> Actors;
+	TSet<UPackage*> DirtyPackages;
+
+	for (int32 BatchStart = 0; BatchStart < PackageNames.Num(); BatchStart += Settings.BatchSize)
+	{
+		const int32 BatchEnd = FMath::Min(BatchStart + Settings.BatchSize, PackageNames.Num());
+
+		// The whole batch is requested at once, so the loader overlaps reading and serializing the levels.
+		for (int32 Index = BatchStart; Index < BatchEnd; Index++)
+		{
+			LoadPackageAsync(PackageNames[Index]);
+		}
+
+		FlushAsyncLoading();
+
+		Worlds.Reset();
+		DirtyPackages.Reset();
+
+		for (int32 Index = BatchStart; Index < BatchEnd; Index++)
+		{
+			UPackage* Package = FindPackage(nullptr, *PackageNames[Index]);
+			UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+
+			if (!World)
+			{
+				UE_LOG(LogTemp, Error, TEXT("Gizmo Bulk Transform : %s is not a level or could not be loaded."), *PackageNames[Index]);
+				NumFailed++;
+				continue;
+			}
+
+			this->InitializeLevel(World);
+			Worlds.Add(World);
+
+			this->SelectActors(World, Settings, Actors);
+			const int32 NumMoved = this->TransformActors(Actors, Settings, DirtyPackages);
+			NumActors += NumMoved;
+
+			UE_LOG(LogTemp, Display, TEXT("Gizmo Bulk Transform : %s selected %d actors, moved %d."), *PackageNames[Index], Actors.Num(), NumMoved);
+		}
+
+		if (!Settings.bDryRun)
+		{
+			const int32 NumSaveFailed = this->SavePackages(DirtyPackages);
+			NumFailed += NumSaveFailed;
+			NumSaved += DirtyPackages.Num() - NumSaveFailed;
+		}
+
+		// Levels are released per batch, so memory stays bounded by the batch size instead of the level count.
+		for (UWorld* EachWorld : Worlds)
+		{
+			this->CleanupLevel(EachWorld);
+		}
+
+		Worlds.Reset();
+		Actors.Reset();
+		DirtyPackages.Reset();
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Gizmo Bulk Transform : %d levels, %d actors moved, %d packages %s in %.2f s."), PackageNames.Num(), NumActors, NumSaved, Settings.bDryRun ? TEXT("not saved (dry run)") : TEXT("saved"), FPlatformTime::Seconds() - StartTime);
+
+	return NumFailed > 0 ? 1 : 0;
+#else
+	UE_LOG(LogTemp, Error, TEXT("Gizmo Bulk Transform : Only available in editor builds."));
+	return 1;
+#endif
+}
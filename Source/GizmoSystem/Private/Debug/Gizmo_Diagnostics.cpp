@@ -0,0 +1,180 @@
+#include "Debug/Gizmo_Diagnostics.h"
+
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+// Seconds between two refreshes of the on-screen line.
+static constexpr float GizmoDiagnosticsRefreshInterval = 0.25f;
+
+// Live instances, for the dump command. Actors can be constructed on the loading thread, hence the lock.
+// Never freed, so gizmos destroyed during static shutdown can still unregister.
+static FCriticalSection& GetGizmoDiagnosticsLock()
+{
+	static FCriticalSection* Lock = new FCriticalSection();
+	return *Lock;
+}
+
+static TArray<FGizmoDiagnostics*>& GetGizmoDiagnosticsRegistry()
+{
+	static TArray<FGizmoDiagnostics*>* Registry = new TArray<FGizmoDiagnostics*>();
+	return *Registry;
+}
+
+static FAutoConsoleCommandWithOutputDevice GizmoDumpDiagnosticsCommand(
+	TEXT("Gizmo.DumpDiagnostics"),
+	TEXT("Prints the recent diagnostic events of every gizmo."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FGizmoDiagnostics::DumpAll));
+
+FGizmoDiagnostics::FGizmoDiagnostics()
+{
+	FScopeLock Lock(&GetGizmoDiagnosticsLock());
+	GetGizmoDiagnosticsRegistry().Add(this);
+}
+
+FGizmoDiagnostics::~FGizmoDiagnostics()
+{
+	FScopeLock Lock(&GetGizmoDiagnosticsLock());
+	GetGizmoDiagnosticsRegistry().RemoveSwap(this);
+}
+
+void FGizmoDiagnostics::SetOwner(const UObject* In_Owner)
+{
+	this->Owner = In_Owner;
+}
+
+void FGizmoDiagnostics::Report(EGizmoDiagnostic Reason)
+{
+	if (Reason >= EGizmoDiagnostic::Max)
+	{
+		return;
+	}
+
+	this->Totals[(int32)Reason]++;
+
+	if (this->Num > 0)
+	{
+		FGizmoDiagnosticEvent& Latest = this->Events[(this->Head + Capacity - 1) % Capacity];
+
+		if (Latest.Reason == Reason)
+		{
+			Latest.Count++;
+			Latest.LastFrame = GFrameCounter;
+			Latest.LastTime = FPlatformTime::Seconds();
+			return;
+		}
+	}
+
+	FGizmoDiagnosticEvent& NewEvent = this->Events[this->Head];
+	NewEvent.Reason = Reason;
+	NewEvent.Count = 1;
+	NewEvent.FirstFrame = GFrameCounter;
+	NewEvent.LastFrame = GFrameCounter;
+	NewEvent.LastTime = FPlatformTime::Seconds();
+
+	this->Head = (this->Head + 1) % Capacity;
+	this->Num = FMath::Min(this->Num + 1, Capacity);
+}
+
+void FGizmoDiagnostics::Reset()
+{
+	this->Head = 0;
+	this->Num = 0;
+
+	FMemory::Memzero(this->Totals);
+}
+
+void FGizmoDiagnostics::ShowOnScreen()
+{
+	const UObject* OwnerObject = this->Owner.Get();
+
+	if (!GEngine || !IsValid(OwnerObject) || this->Num == 0)
+	{
+		return;
+	}
+
+	const double CurrentTime = FPlatformTime::Seconds();
+
+	if (CurrentTime - this->LastShownTime < GizmoDiagnosticsRefreshInterval)
+	{
+		return;
+	}
+
+	this->LastShownTime = CurrentTime;
+
+	const FGizmoDiagnosticEvent& Latest = this->Events[(this->Head + Capacity - 1) % Capacity];
+
+	// Keyed by owner, so the line is replaced instead of stacked.
+	GEngine->AddOnScreenDebugMessage((uint64)OwnerObject->GetUniqueID(), GizmoDiagnosticsRefreshInterval * 2, FColor::Red, FString::Printf(TEXT("%s : %s (x%u since frame %llu)"), *OwnerObject->GetName(), GetReasonText(Latest.Reason), Latest.Count, Latest.FirstFrame));
+}
+
+void FGizmoDiagnostics::Dump(FOutputDevice& Ar) const
+{
+	const UObject* OwnerObject = this->Owner.Get();
+	const double CurrentTime = FPlatformTime::Seconds();
+
+	Ar.Logf(TEXT("%s : %d events"), IsValid(OwnerObject) ? *OwnerObject->GetPathName() : TEXT("Unknown"), this->Num);
+
+	// Oldest first.
+	for (int32 EventIndex = 0; EventIndex < this->Num; EventIndex++)
+	{
+		const FGizmoDiagnosticEvent& EachEvent = this->Events[(this->Head - this->Num + EventIndex + Capacity) % Capacity];
+		Ar.Logf(TEXT("    frames %llu - %llu : %s x%u (%.2f s ago)"), EachEvent.FirstFrame, EachEvent.LastFrame, GetReasonText(EachEvent.Reason), EachEvent.Count, CurrentTime - EachEvent.LastTime);
+	}
+
+	for (int32 ReasonIndex = 0; ReasonIndex < (int32)EGizmoDiagnostic::Max; ReasonIndex++)
+	{
+		if (this->Totals[ReasonIndex] > 0)
+		{
+			Ar.Logf(TEXT("    total : %s x%u"), GetReasonText((EGizmoDiagnostic)ReasonIndex), this->Totals[ReasonIndex]);
+		}
+	}
+}
+
+uint32 FGizmoDiagnostics::GetTotal(EGizmoDiagnostic Reason) const
+{
+	return Reason < EGizmoDiagnostic::Max ? this->Totals[(int32)Reason] : 0;
+}
+
+const TCHAR* FGizmoDiagnostics::GetReasonText(EGizmoDiagnostic Reason)
+{
+	switch (Reason)
+	{
+		case EGizmoDiagnostic::Base_Invalid:
+			return TEXT("Gizmo base is not valid !");
+
+		case EGizmoDiagnostic::Target_Invalid:
+			return TEXT("Gizmo target is not valid !");
+
+		case EGizmoDiagnostic::No_Movement:
+			return TEXT("There is no movement !");
+
+		case EGizmoDiagnostic::Not_In_View:
+			return TEXT("Gizmo is not in the view !");
+
+		case EGizmoDiagnostic::Forbidden_Key:
+			return TEXT("Forbidden key pressed !");
+
+		case EGizmoDiagnostic::Not_Visible:
+			return TEXT("Gizmo is not visible !");
+
+		default:
+			return TEXT("Unknown");
+	}
+}
+
+void FGizmoDiagnostics::DumpAll(FOutputDevice& Ar)
+{
+	FScopeLock Lock(&GetGizmoDiagnosticsLock());
+
+	for (const FGizmoDiagnostics* EachDiagnostics : GetGizmoDiagnosticsRegistry())
+	{
+		const UObject* OwnerObject = EachDiagnostics->Owner.Get();
+
+		// Class default objects and archetypes register too, they never report anything.
+		if (IsValid(OwnerObject) && !OwnerObject->IsTemplate())
+		{
+			EachDiagnostics->Dump(Ar);
+		}
+	}
+}
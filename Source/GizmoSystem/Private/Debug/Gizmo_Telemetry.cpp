@@ -0,0 +1,355 @@
+#include "Debug/Gizmo_Telemetry.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+static TAutoConsoleVariable<float> CVarGizmoLatencyBudgetMs(
+	TEXT("Gizmo.Telemetry.LatencyBudgetMs"),
+	16.f,
+	TEXT("Drag latency above this many milliseconds is counted as over budget."));
+
+// Live instances, for the dump command. Same lifetime rules as the diagnostics registry.
+static FCriticalSection& GetGizmoTelemetryLock()
+{
+	static FCriticalSection* Lock = new FCriticalSection();
+	return *Lock;
+}
+
+static TArray<FGizmoTelemetry*>& GetGizmoTelemetryRegistry()
+{
+	static TArray<FGizmoTelemetry*>* Registry = new TArray<FGizmoTelemetry*>();
+	return *Registry;
+}
+
+static void GizmoDumpTelemetry(const TArray<FString>& Args, FOutputDevice& Ar)
+{
+	const FString Path = Args.IsEmpty() ? FGizmoTelemetry::GetDefaultPath() : Args[0];
+
+	if (FGizmoTelemetry::DumpAll(Path))
+	{
+		Ar.Logf(TEXT("Gizmo Telemetry : Written to %s"), *Path);
+	}
+
+	else
+	{
+		Ar.Logf(TEXT("Gizmo Telemetry : %s could not be written."), *Path);
+	}
+}
+
+static FAutoConsoleCommandWithArgsAndOutputDevice GizmoDumpTelemetryCommand(
+	TEXT("Gizmo.DumpTelemetry"),
+	TEXT("Writes the drag latency, solver time, transform write and coalesced sample histograms of every gizmo to CSV. Optional argument is the file path."),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(&GizmoDumpTelemetry));
+
+static bool GizmoIsTimeMetric(EGizmoTelemetryMetric Metric)
+{
+	return Metric == EGizmoTelemetryMetric::Drag_Latency || Metric == EGizmoTelemetryMetric::Solver_Time;
+}
+
+void FGizmoHistogram::Record(uint64 Value)
+{
+	this->Buckets[GetBucketIndex(Value)].fetch_add(1, std::memory_order_relaxed);
+	this->Count.fetch_add(1, std::memory_order_relaxed);
+	this->Sum.fetch_add(Value, std::memory_order_relaxed);
+
+	uint64 PreviousMax = this->Max.load(std::memory_order_relaxed);
+
+	while (Value > PreviousMax && !this->Max.compare_exchange_weak(PreviousMax, Value, std::memory_order_relaxed))
+	{
+
+	}
+}
+
+void FGizmoHistogram::Reset()
+{
+	for (std::atomic<uint64>& EachBucket : this->Buckets)
+	{
+		EachBucket.store(0, std::memory_order_relaxed);
+	}
+
+	this->Count.store(0, std::memory_order_relaxed);
+	this->Sum.store(0, std::memory_order_relaxed);
+	this->Max.store(0, std::memory_order_relaxed);
+}
+
+uint64 FGizmoHistogram::GetCount() const
+{
+	return this->Count.load(std::memory_order_relaxed);
+}
+
+uint64 FGizmoHistogram::GetSum() const
+{
+	return this->Sum.load(std::memory_order_relaxed);
+}
+
+uint64 FGizmoHistogram::GetMax() const
+{
+	return this->Max.load(std::memory_order_relaxed);
+}
+
+uint64 FGizmoHistogram::GetPercentile(double Fraction) const
+{
+	// Buckets are read one by one while others may record, so the total is taken from the buckets themselves.
+	uint64 BucketCounts[NumBuckets];
+	uint64 Total = 0;
+
+	for (int32 BucketIndex = 0; BucketIndex < NumBuckets; BucketIndex++)
+	{
+		BucketCounts[BucketIndex] = this->Buckets[BucketIndex].load(std::memory_order_relaxed);
+		Total += BucketCounts[BucketIndex];
+	}
+
+	if (Total == 0)
+	{
+		return 0;
+	}
+
+	const uint64 Rank = FMath::Clamp<uint64>((uint64)FMath::CeilToDouble(FMath::Clamp(Fraction, 0.0, 1.0) * Total), 1, Total);
+	uint64 Cumulative = 0;
+
+	for (int32 BucketIndex = 0; BucketIndex < NumBuckets; BucketIndex++)
+	{
+		Cumulative += BucketCounts[BucketIndex];
+
+		if (Cumulative >= Rank)
+		{
+			const uint64 Middle = GetBucketLow(BucketIndex) + (GetBucketHigh(BucketIndex) - GetBucketLow(BucketIndex)) / 2;
+			return FMath::Min(Middle, this->GetMax());
+		}
+	}
+
+	return this->GetMax();
+}
+
+uint64 FGizmoHistogram::GetBucketCount(int32 BucketIndex) const
+{
+	return BucketIndex >= 0 && BucketIndex < NumBuckets ? this->Buckets[BucketIndex].load(std::memory_order_relaxed) : 0;
+}
+
+int32 FGizmoHistogram::GetBucketIndex(uint64 Value)
+{
+	constexpr uint64 SubBucketCount = 1ull << SubBucketBits;
+
+	if (Value < SubBucketCount)
+	{
+		return (int32)Value;
+	}
+
+	const int32 Exponent = FMath::Min((int32)FMath::FloorLog2_64(Value), MaxExponent);
+	const uint64 SubBucket = (FMath::Min(Value, (2ull << MaxExponent) - 1) >> (Exponent - SubBucketBits)) & (SubBucketCount - 1);
+
+	return ((Exponent - SubBucketBits + 1) << SubBucketBits) + (int32)SubBucket;
+}
+
+uint64 FGizmoHistogram::GetBucketLow(int32 BucketIndex)
+{
+	constexpr int32 SubBucketCount = 1 << SubBucketBits;
+
+	if (BucketIndex < SubBucketCount)
+	{
+		return (uint64)BucketIndex;
+	}
+
+	const int32 Exponent = (BucketIndex >> SubBucketBits) + SubBucketBits - 1;
+	const uint64 SubBucket = (uint64)(BucketIndex & (SubBucketCount - 1));
+
+	return (SubBucketCount + SubBucket) << (Exponent - SubBucketBits);
+}
+
+uint64 FGizmoHistogram::GetBucketHigh(int32 BucketIndex)
+{
+	constexpr int32 SubBucketCount = 1 << SubBucketBits;
+
+	if (BucketIndex < SubBucketCount)
+	{
+		return (uint64)BucketIndex;
+	}
+
+	const int32 Exponent = (BucketIndex >> SubBucketBits) + SubBucketBits - 1;
+	return GetBucketLow(BucketIndex) + (1ull << (Exponent - SubBucketBits)) - 1;
+}
+
+FGizmoTelemetry::FGizmoTelemetry() : FGizmoTelemetry(false)
+{
+
+}
+
+FGizmoTelemetry::FGizmoTelemetry(bool In_bIsGlobal) : bIsGlobal(In_bIsGlobal)
+{
+	FScopeLock Lock(&GetGizmoTelemetryLock());
+	GetGizmoTelemetryRegistry().Add(this);
+}
+
+FGizmoTelemetry::~FGizmoTelemetry()
+{
+	FScopeLock Lock(&GetGizmoTelemetryLock());
+	GetGizmoTelemetryRegistry().RemoveSwap(this);
+}
+
+void FGizmoTelemetry::SetOwner(const UObject* In_Owner)
+{
+	this->Owner = In_Owner;
+}
+
+void FGizmoTelemetry::Record(EGizmoTelemetryMetric Metric, uint64 Value)
+{
+	if (Metric >= EGizmoTelemetryMetric::Max)
+	{
+		return;
+	}
+
+	this->Histograms[(int32)Metric].Record(Value);
+
+	if (Metric == EGizmoTelemetryMetric::Drag_Latency && Value > (uint64)(CVarGizmoLatencyBudgetMs.GetValueOnAnyThread() * 1000))
+	{
+		this->NumOverBudget.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (!this->bIsGlobal)
+	{
+		GetGlobal().Record(Metric, Value);
+	}
+}
+
+void FGizmoTelemetry::RecordDrag()
+{
+	this->NumDrags.fetch_add(1, std::memory_order_relaxed);
+
+	if (!this->bIsGlobal)
+	{
+		GetGlobal().RecordDrag();
+	}
+}
+
+void FGizmoTelemetry::Reset()
+{
+	for (FGizmoHistogram& EachHistogram : this->Histograms)
+	{
+		EachHistogram.Reset();
+	}
+
+	this->NumDrags.store(0, std::memory_order_relaxed);
+	this->NumOverBudget.store(0, std::memory_order_relaxed);
+}
+
+FGizmoTelemetrySummary FGizmoTelemetry::GetSummary(EGizmoTelemetryMetric Metric) const
+{
+	FGizmoTelemetrySummary Summary;
+	Summary.NumDrags = (int64)this->NumDrags.load(std::memory_order_relaxed);
+
+	if (Metric >= EGizmoTelemetryMetric::Max)
+	{
+		return Summary;
+	}
+
+	const FGizmoHistogram& Histogram = this->Histograms[(int32)Metric];
+	const double Scale = GizmoIsTimeMetric(Metric) ? 0.001 : 1.0;
+
+	Summary.Count = (int64)Histogram.GetCount();
+	Summary.Mean = Summary.Count > 0 ? (float)(Histogram.GetSum() * Scale / Summary.Count) : 0;
+	Summary.P50 = (float)(Histogram.GetPercentile(0.5) * Scale);
+	Summary.P95 = (float)(Histogram.GetPercentile(0.95) * Scale);
+	Summary.P99 = (float)(Histogram.GetPercentile(0.99) * Scale);
+	Summary.Max = (float)(Histogram.GetMax() * Scale);
+
+	if (Metric == EGizmoTelemetryMetric::Drag_Latency)
+	{
+		Summary.NumOverBudget = (int64)this->NumOverBudget.load(std::memory_order_relaxed);
+	}
+
+	return Summary;
+}
+
+const FGizmoHistogram& FGizmoTelemetry::GetHistogram(EGizmoTelemetryMetric Metric) const
+{
+	return this->Histograms[FMath::Min((int32)Metric, (int32)EGizmoTelemetryMetric::Max - 1)];
+}
+
+FGizmoTelemetry& FGizmoTelemetry::GetGlobal()
+{
+	// Never freed, gizmos destroyed during static shutdown still record into it.
+	static FGizmoTelemetry* Global = new FGizmoTelemetry(true);
+	return *Global;
+}
+
+const TCHAR* FGizmoTelemetry::GetMetricName(EGizmoTelemetryMetric Metric)
+{
+	switch (Metric)
+	{
+		case EGizmoTelemetryMetric::Drag_Latency:
+			return TEXT("DragLatency");
+
+		case EGizmoTelemetryMetric::Solver_Time:
+			return TEXT("SolverTime");
+
+		case EGizmoTelemetryMetric::Transform_Writes:
+			return TEXT("TransformWrites");
+
+		case EGizmoTelemetryMetric::Coalesced_Samples:
+			return TEXT("CoalescedSamples");
+
+		default:
+			return TEXT("Unknown");
+	}
+}
+
+bool FGizmoTelemetry::DumpAll(const FString& Path)
+{
+	FString Summaries = TEXT("Gizmo,Metric,Unit,Drags,Count,Mean,P50,P95,P99,Max,OverBudget\n");
+	FString Buckets = TEXT("Gizmo,Metric,Low,High,Count\n");
+
+	auto DumpOne = [&Summaries, &Buckets](const FGizmoTelemetry& Telemetry, const FString& Name)
+		{
+			for (int32 MetricIndex = 0; MetricIndex < (int32)EGizmoTelemetryMetric::Max; MetricIndex++)
+			{
+				const EGizmoTelemetryMetric Metric = (EGizmoTelemetryMetric)MetricIndex;
+				const FGizmoTelemetrySummary Summary = Telemetry.GetSummary(Metric);
+
+				Summaries += FString::Printf(TEXT("%s,%s,%s,%lld,%lld,%.3f,%.3f,%.3f,%.3f,%.3f,%lld\n"), *Name, GetMetricName(Metric), GizmoIsTimeMetric(Metric) ? TEXT("ms") : TEXT("count"), Summary.NumDrags, Summary.Count, Summary.Mean, Summary.P50, Summary.P95, Summary.P99, Summary.Max, Summary.NumOverBudget);
+
+				// Raw buckets, so runs from several machines can be merged without losing the tail.
+				const FGizmoHistogram& Histogram = Telemetry.GetHistogram(Metric);
+
+				for (int32 BucketIndex = 0; BucketIndex < FGizmoHistogram::NumBuckets; BucketIndex++)
+				{
+					const uint64 BucketCount = Histogram.GetBucketCount(BucketIndex);
+
+					if (BucketCount > 0)
+					{
+						Buckets += FString::Printf(TEXT("%s,%s,%llu,%llu,%llu\n"), *Name, GetMetricName(Metric), FGizmoHistogram::GetBucketLow(BucketIndex), FGizmoHistogram::GetBucketHigh(BucketIndex), BucketCount);
+					}
+				}
+			}
+		};
+
+	DumpOne(GetGlobal(), TEXT("Global"));
+
+	{
+		FScopeLock Lock(&GetGizmoTelemetryLock());
+
+		for (const FGizmoTelemetry* EachTelemetry : GetGizmoTelemetryRegistry())
+		{
+			const UObject* OwnerObject = EachTelemetry->Owner.Get();
+
+			// Class default objects register too, but never drag.
+			if (EachTelemetry->bIsGlobal || !IsValid(OwnerObject) || OwnerObject->IsTemplate())
+			{
+				continue;
+			}
+
+			DumpOne(*EachTelemetry, OwnerObject->GetPathName());
+		}
+	}
+
+	const FString BucketsPath = FPaths::Combine(FPaths::GetPath(Path), FPaths::GetBaseFilename(Path) + TEXT("_Buckets.csv"));
+
+	return FFileHelper::SaveStringToFile(Summaries, *Path) && FFileHelper::SaveStringToFile(Buckets, *BucketsPath);
+}
+
+FString FGizmoTelemetry::GetDefaultPath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Gizmo"), FString::Printf(TEXT("GizmoTelemetry_%s.csv"), *FDateTime::Now().ToString()));
+}
@@ -4,10 +4,18 @@
 #include "GizmoSystem.h"
 
 #include "Math/Vector.h"
+#include "Math/VectorRegister.h"
+#include "History/Gizmo_Journal.h"
+#include "Assets/Gizmo_Asset_Subsystem.h"
+#include "Math/Gizmo_Math_Move.h"
+#include "Math/Gizmo_Math_Rotate.h"
+#include "Math/Gizmo_Math_Scale.h"
+#include "Math/Gizmo_Math_Base.h"
 
 #include "BaseGizmos/GizmoActor.h"
 #include "InteractiveGizmoManager.h"
 #include "InteractiveToolsContext.h"
+#include "Engine/Engine.h"
 
 
 UGizmoSystemBPLibrary::UGizmoSystemBPLibrary(const FObjectInitializer& ObjectInitializer)
@@ -34,5 +42,294 @@ bool UGizmoSystemBPLibrary::IsVectorsCoincident(const FVector V1, const FVector
 
 void UGizmoSystemBPLibrary::AddLocalRotWithQuat(USceneComponent* TargetObject, const FVector RotationAxis, float RotationAngle)
 {
+	if (!IsValid(TargetObject))
+	{
+		return;
+	}
+
 	TargetObject->AddLocalRotation(FQuat(RotationAxis, FMath::DegreesToRadians(RotationAngle)));
-}
\ No newline at end of file
+}
+
+// Length of a batch where single element inputs are broadcast. INDEX_NONE when the lengths do not match.
+static int32 GizmoBatchNum(int32 NumA, int32 NumB)
+{
+	if (NumA == NumB || NumB == 1)
+	{
+		return NumA;
+	}
+
+	if (NumA == 1)
+	{
+		return NumB;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("Gizmo BP Library : Batch inputs must have the same length or a single element (%d, %d)."), NumA, NumB);
+	return INDEX_NONE;
+}
+
+// Four elements of an FVector array, one register per component. Broadcast inputs read element 0.
+static void GizmoLoadVectors4(const TArray<FVector>& Vectors, int32 Index, VectorRegister4Double& Out_X, VectorRegister4Double& Out_Y, VectorRegister4Double& Out_Z)
+{
+	if (Vectors.Num() == 1)
+	{
+		Out_X = VectorSetFloat1(Vectors[0].X);
+		Out_Y = VectorSetFloat1(Vectors[0].Y);
+		Out_Z = VectorSetFloat1(Vectors[0].Z);
+		return;
+	}
+
+	const FVector* V = &Vectors[Index];
+
+	Out_X = MakeVectorRegisterDouble(V[0].X, V[1].X, V[2].X, V[3].X);
+	Out_Y = MakeVectorRegisterDouble(V[0].Y, V[1].Y, V[2].Y, V[3].Y);
+	Out_Z = MakeVectorRegisterDouble(V[0].Z, V[1].Z, V[2].Z, V[3].Z);
+}
+
+// Cosine of the angle between each pair without normalizing the vectors first. Zero vectors give zero.
+static VectorRegister4Double GizmoCosine4(const VectorRegister4Double& AX, const VectorRegister4Double& AY, const VectorRegister4Double& AZ, const VectorRegister4Double& BX, const VectorRegister4Double& BY, const VectorRegister4Double& BZ)
+{
+	const VectorRegister4Double Dot = VectorMultiplyAdd(AX, BX, VectorMultiplyAdd(AY, BY, VectorMultiply(AZ, BZ)));
+	const VectorRegister4Double SizeSquaredA = VectorMultiplyAdd(AX, AX, VectorMultiplyAdd(AY, AY, VectorMultiply(AZ, AZ)));
+	const VectorRegister4Double SizeSquaredB = VectorMultiplyAdd(BX, BX, VectorMultiplyAdd(BY, BY, VectorMultiply(BZ, BZ)));
+	const VectorRegister4Double SizeProduct = VectorMax(VectorMultiply(SizeSquaredA, SizeSquaredB), VectorSetFloat1(UE_SMALL_NUMBER * UE_SMALL_NUMBER));
+
+	return VectorMultiply(Dot, VectorReciprocalSqrt(SizeProduct));
+}
+
+static bool GizmoCosineMask(const TArray<FVector>& V1, const TArray<FVector>& V2, float Threshold, bool bAbsolute, TArray<bool>& Out_Mask)
+{
+	Out_Mask.Reset();
+
+	const int32 Num = GizmoBatchNum(V1.Num(), V2.Num());
+
+	if (Num == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Out_Mask.SetNumUninitialized(Num);
+
+	const VectorRegister4Double ThresholdRegister = VectorSetFloat1(static_cast<double>(Threshold));
+	int32 Index = 0;
+
+	for (; Index + 4 <= Num; Index += 4)
+	{
+		VectorRegister4Double AX, AY, AZ, BX, BY, BZ;
+		GizmoLoadVectors4(V1, Index, AX, AY, AZ);
+		GizmoLoadVectors4(V2, Index, BX, BY, BZ);
+
+		const VectorRegister4Double Cosine = GizmoCosine4(AX, AY, AZ, BX, BY, BZ);
+		const int32 Bits = VectorMaskBits(VectorCompareGE(bAbsolute ? VectorAbs(Cosine) : Cosine, ThresholdRegister));
+
+		Out_Mask[Index] = (Bits & 1) != 0;
+		Out_Mask[Index + 1] = (Bits & 2) != 0;
+		Out_Mask[Index + 2] = (Bits & 4) != 0;
+		Out_Mask[Index + 3] = (Bits & 8) != 0;
+	}
+
+	for (; Index < Num; ++Index)
+	{
+		const FVector& A = V1[V1.Num() == 1 ? 0 : Index];
+		const FVector& B = V2[V2.Num() == 1 ? 0 : Index];
+		const double Cosine = FVector::DotProduct(A, B) * FMath::InvSqrt(FMath::Max(A.SizeSquared() * B.SizeSquared(), UE_SMALL_NUMBER * UE_SMALL_NUMBER));
+
+		Out_Mask[Index] = (bAbsolute ? FMath::Abs(Cosine) : Cosine) >= Threshold;
+	}
+
+	return true;
+}
+
+bool UGizmoSystemBPLibrary::IsVectorsParallelBatch(const TArray<FVector>& V1, const TArray<FVector>& V2, float ParallelCosineThreshold, TArray<bool>& Out_Mask)
+{
+	return GizmoCosineMask(V1, V2, ParallelCosineThreshold, true, Out_Mask);
+}
+
+bool UGizmoSystemBPLibrary::IsVectorsCoincidentBatch(const TArray<FVector>& V1, const TArray<FVector>& V2, float ParallelCosineThreshold, TArray<bool>& Out_Mask)
+{
+	return GizmoCosineMask(V1, V2, ParallelCosineThreshold, false, Out_Mask);
+}
+
+bool UGizmoSystemBPLibrary::AxisAngleToQuatBatch(const TArray<FVector>& RotationAxes, const TArray<float>& RotationAngles, TArray<FQuat>& Out_Quats)
+{
+	Out_Quats.Reset();
+
+	const int32 Num = GizmoBatchNum(RotationAxes.Num(), RotationAngles.Num());
+
+	if (Num == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Out_Quats.SetNumUninitialized(Num);
+
+	const VectorRegister4Double HalfRadians = VectorSetFloat1(UE_DOUBLE_PI / 360.0);
+	const VectorRegister4Double MinSizeSquared = VectorSetFloat1(UE_SMALL_NUMBER);
+	const bool bBroadcastAngle = RotationAngles.Num() == 1;
+
+	int32 Index = 0;
+
+	for (; Index + 4 <= Num; Index += 4)
+	{
+		VectorRegister4Double X, Y, Z;
+		GizmoLoadVectors4(RotationAxes, Index, X, Y, Z);
+
+		const float* A = bBroadcastAngle ? nullptr : &RotationAngles[Index];
+		const VectorRegister4Double Angles = bBroadcastAngle ? VectorSetFloat1(static_cast<double>(RotationAngles[0])) : MakeVectorRegisterDouble(static_cast<double>(A[0]), static_cast<double>(A[1]), static_cast<double>(A[2]), static_cast<double>(A[3]));
+
+		VectorRegister4Double Sin;
+		VectorRegister4Double Cos;
+		const VectorRegister4Double Half = VectorMultiply(Angles, HalfRadians);
+		VectorSinCos(&Sin, &Cos, &Half);
+
+		// Zero axes get a zero scale, so they come out as identity.
+		const VectorRegister4Double SizeSquared = VectorMultiplyAdd(X, X, VectorMultiplyAdd(Y, Y, VectorMultiply(Z, Z)));
+		const VectorRegister4Double IsValidAxis = VectorCompareGT(SizeSquared, MinSizeSquared);
+		const VectorRegister4Double Scale = VectorSelect(IsValidAxis, VectorMultiply(Sin, VectorReciprocalSqrt(VectorMax(SizeSquared, MinSizeSquared))), VectorZeroDouble());
+		const VectorRegister4Double W = VectorSelect(IsValidAxis, Cos, VectorOneDouble());
+
+		alignas(32) double QX[4], QY[4], QZ[4], QW[4];
+		VectorStoreAligned(VectorMultiply(X, Scale), QX);
+		VectorStoreAligned(VectorMultiply(Y, Scale), QY);
+		VectorStoreAligned(VectorMultiply(Z, Scale), QZ);
+		VectorStoreAligned(W, QW);
+
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			Out_Quats[Index + Lane] = FQuat(QX[Lane], QY[Lane], QZ[Lane], QW[Lane]);
+		}
+	}
+
+	for (; Index < Num; ++Index)
+	{
+		const FVector Axis = RotationAxes[RotationAxes.Num() == 1 ? 0 : Index].GetSafeNormal();
+		const float Angle = RotationAngles[bBroadcastAngle ? 0 : Index];
+
+		Out_Quats[Index] = Axis.IsZero() ? FQuat::Identity : FQuat(Axis, FMath::DegreesToRadians(Angle));
+	}
+
+	return true;
+}
+
+int32 UGizmoSystemBPLibrary::AddLocalRotWithQuatBatch(const TArray<USceneComponent*>& TargetObjects, const TArray<FVector>& RotationAxes, const TArray<float>& RotationAngles)
+{
+	const int32 NumRotations = GizmoBatchNum(RotationAxes.Num(), RotationAngles.Num());
+
+	if (NumRotations == INDEX_NONE || GizmoBatchNum(TargetObjects.Num(), NumRotations) != TargetObjects.Num())
+	{
+		return 0;
+	}
+
+	TArray<FQuat> Quats;
+	AxisAngleToQuatBatch(RotationAxes, RotationAngles, Quats);
+
+	// Local rotations compose on the right, in list order. Each component is moved once.
+	TArray<USceneComponent*> Components;
+	TArray<FQuat> Deltas;
+	TMap<USceneComponent*, int32> ComponentIndices;
+
+	Components.Reserve(TargetObjects.Num());
+	Deltas.Reserve(TargetObjects.Num());
+	ComponentIndices.Reserve(TargetObjects.Num());
+
+	for (int32 Index = 0; Index < TargetObjects.Num(); ++Index)
+	{
+		USceneComponent* EachTarget = TargetObjects[Index];
+
+		if (!IsValid(EachTarget))
+		{
+			continue;
+		}
+
+		const FQuat& Quat = Quats[Quats.Num() == 1 ? 0 : Index];
+
+		if (const int32* Existing = ComponentIndices.Find(EachTarget))
+		{
+			Deltas[*Existing] = Deltas[*Existing] * Quat;
+			continue;
+		}
+
+		ComponentIndices.Add(EachTarget, Components.Num());
+		Components.Add(EachTarget);
+		Deltas.Add(Quat);
+	}
+
+	for (int32 Index = 0; Index < Components.Num(); ++Index)
+	{
+		Components[Index]->AddLocalRotation(Deltas[Index]);
+	}
+
+	return Components.Num();
+}
+
+int32 UGizmoSystemBPLibrary::ReplayGizmoJournal(const UObject* WorldContextObject, const FString& JournalPath)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return FGizmoJournal::Replay(JournalPath.IsEmpty() ? FGizmoJournal::GetDefaultPath() : JournalPath, World);
+}
+
+// The base gizmo spawns its move, rotate or scale child at runtime, so it warms all three.
+static void GizmoGatherAssetPaths(const UClass* GizmoClass, TArray<FSoftObjectPath>& Out_Paths)
+{
+	const UObject* Defaults = GizmoClass->GetDefaultObject();
+
+	if (const AGizmoMathMove* MoveDefaults = Cast<AGizmoMathMove>(Defaults))
+	{
+		Out_Paths.Append(MoveDefaults->GetAssetPaths());
+	}
+
+	else if (const AGizmoMathRotate* RotateDefaults = Cast<AGizmoMathRotate>(Defaults))
+	{
+		Out_Paths.Append(RotateDefaults->GetAssetPaths());
+	}
+
+	else if (const AGizmoMathScale* ScaleDefaults = Cast<AGizmoMathScale>(Defaults))
+	{
+		Out_Paths.Append(ScaleDefaults->GetAssetPaths());
+	}
+
+	else if (GizmoClass->IsChildOf<AGizmoMathBase>())
+	{
+		for (const UClass* EachChildClass : { AGizmoMathMove::StaticClass(), AGizmoMathRotate::StaticClass(), AGizmoMathScale::StaticClass() })
+		{
+			GizmoGatherAssetPaths(EachChildClass, Out_Paths);
+		}
+	}
+}
+
+void UGizmoSystemBPLibrary::PreloadGizmoAssets(TSubclassOf<AActor> GizmoClass)
+{
+	UGizmoAssetSubsystem* AssetSubsystem = UGizmoAssetSubsystem::Get();
+
+	if (!GizmoClass || !AssetSubsystem)
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> Paths;
+	GizmoGatherAssetPaths(GizmoClass, Paths);
+
+	AssetSubsystem->Preload(Paths);
+}
+
+FGizmoTelemetrySummary UGizmoSystemBPLibrary::GetGizmoTelemetry(const AGizmoMathBase* GizmoBase, EGizmoTelemetryMetric Metric)
+{
+	return IsValid(GizmoBase) ? GizmoBase->Telemetry.GetSummary(Metric) : FGizmoTelemetry::GetGlobal().GetSummary(Metric);
+}
+
+void UGizmoSystemBPLibrary::ResetGizmoTelemetry(AGizmoMathBase* GizmoBase)
+{
+	if (IsValid(GizmoBase))
+	{
+		GizmoBase->Telemetry.Reset();
+	}
+
+	else
+	{
+		FGizmoTelemetry::GetGlobal().Reset();
+	}
+}
+
+bool UGizmoSystemBPLibrary::DumpGizmoTelemetry(const FString& Path)
+{
+	return FGizmoTelemetry::DumpAll(Path.IsEmpty() ? FGizmoTelemetry::GetDefaultPath() : Path);
+}
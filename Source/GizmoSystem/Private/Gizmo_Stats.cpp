@@ -0,0 +1,29 @@
+#include "Gizmo_Stats.h"
+
+DEFINE_STAT(STAT_Gizmo_BaseTick);
+DEFINE_STAT(STAT_Gizmo_CaptureInput);
+DEFINE_STAT(STAT_Gizmo_SizeScaling);
+DEFINE_STAT(STAT_Gizmo_Hover);
+DEFINE_STAT(STAT_Gizmo_PickHandle);
+DEFINE_STAT(STAT_Gizmo_TransformCheck);
+DEFINE_STAT(STAT_Gizmo_MoveSystem);
+DEFINE_STAT(STAT_Gizmo_RotateSystem);
+DEFINE_STAT(STAT_Gizmo_ScaleSystem);
+DEFINE_STAT(STAT_Gizmo_ApplyToTargets);
+DEFINE_STAT(STAT_Gizmo_UpdateCollision);
+DEFINE_STAT(STAT_Gizmo_ProxyDraw);
+DEFINE_STAT(STAT_Gizmo_LateLatch);
+DEFINE_STAT(STAT_Gizmo_SnapGather);
+DEFINE_STAT(STAT_Gizmo_SnapBuild);
+DEFINE_STAT(STAT_Gizmo_SnapQuery);
+DEFINE_STAT(STAT_Gizmo_MarqueeGather);
+DEFINE_STAT(STAT_Gizmo_MarqueeSelect);
+
+DEFINE_STAT(STAT_Gizmo_TransformWrites);
+DEFINE_STAT(STAT_Gizmo_Cooks);
+DEFINE_STAT(STAT_Gizmo_LinesDrawn);
+DEFINE_STAT(STAT_Gizmo_Picks);
+DEFINE_STAT(STAT_Gizmo_InstanceBatches);
+DEFINE_STAT(STAT_Gizmo_SurfaceTraces);
+
+UE_TRACE_CHANNEL_DEFINE(GizmoChannel);
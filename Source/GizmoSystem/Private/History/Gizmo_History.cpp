@@ -0,0 +1,326 @@
+#include "History/Gizmo_History.h"
+
+#include "Components/SceneComponent.h"
+
+static constexpr double GizmoHistoryTranslationStep = 0.01;
+static constexpr double GizmoHistoryScaleStep = 0.0001;
+static constexpr double GizmoHistoryRotationRange = 32767;
+
+static int32 GizmoQuantize(double Value, double Step)
+{
+	return (int32)FMath::Clamp<double>(FMath::RoundToDouble(Value / Step), MIN_int32, MAX_int32);
+}
+
+FGizmoQuantizedDelta FGizmoQuantizedDelta::Quantize(const FTransform& Start, const FTransform& End)
+{
+	FGizmoQuantizedDelta Delta;
+
+	const FVector Translation = End.GetLocation() - Start.GetLocation();
+	const FVector Scale = End.GetScale3D() - Start.GetScale3D();
+	FQuat Rotation = End.GetRotation() * Start.GetRotation().Inverse();
+
+	// Q and -Q are the same rotation. Positive W keeps equal deltas bitwise equal for the shared check.
+	if (Rotation.W < 0)
+	{
+		Rotation = -Rotation;
+	}
+
+	Rotation.Normalize();
+
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		Delta.Translation[Axis] = GizmoQuantize(Translation[Axis], GizmoHistoryTranslationStep);
+		Delta.Scale[Axis] = GizmoQuantize(Scale[Axis], GizmoHistoryScaleStep);
+	}
+
+	Delta.Rotation[0] = (int16)FMath::RoundToInt(Rotation.X * GizmoHistoryRotationRange);
+	Delta.Rotation[1] = (int16)FMath::RoundToInt(Rotation.Y * GizmoHistoryRotationRange);
+	Delta.Rotation[2] = (int16)FMath::RoundToInt(Rotation.Z * GizmoHistoryRotationRange);
+	Delta.Rotation[3] = (int16)FMath::RoundToInt(Rotation.W * GizmoHistoryRotationRange);
+
+	return Delta;
+}
+
+FTransform FGizmoQuantizedDelta::Apply(const FTransform& Current, bool bInverse) const
+{
+	const FVector Translation = FVector(this->Translation[0], this->Translation[1], this->Translation[2]) * GizmoHistoryTranslationStep;
+	const FVector Scale = FVector(this->Scale[0], this->Scale[1], this->Scale[2]) * GizmoHistoryScaleStep;
+	FQuat Rotation = FQuat(this->Rotation[0], this->Rotation[1], this->Rotation[2], this->Rotation[3]) / GizmoHistoryRotationRange;
+	Rotation.Normalize();
+
+	if (bInverse)
+	{
+		return FTransform(Rotation.Inverse() * Current.GetRotation(), Current.GetLocation() - Translation, Current.GetScale3D() - Scale);
+	}
+
+	else
+	{
+		return FTransform(Rotation * Current.GetRotation(), Current.GetLocation() + Translation, Current.GetScale3D() + Scale);
+	}
+}
+
+bool FGizmoQuantizedDelta::IsIdentity() const
+{
+	return *this == FGizmoQuantizedDelta::Quantize(FTransform::Identity, FTransform::Identity);
+}
+
+bool FGizmoQuantizedDelta::operator==(const FGizmoQuantizedDelta& Other) const
+{
+	return FMemory::Memcmp(this, &Other, sizeof(FGizmoQuantizedDelta)) == 0;
+}
+
+void FGizmoHistory::SetCapacity(int64 In_CapacityBytes)
+{
+	In_CapacityBytes = FMath::Max<int64>(In_CapacityBytes, 0);
+
+	if (this->CapacityBytes == In_CapacityBytes)
+	{
+		return;
+	}
+
+	const int32 NumSlots = (int32)FMath::Min<int64>(In_CapacityBytes / (sizeof(TWeakObjectPtr<USceneComponent>) + sizeof(FGizmoQuantizedDelta)), MAX_int32);
+
+	this->Reset();
+	this->CapacityBytes = In_CapacityBytes;
+
+	this->TargetRing.SetNum(NumSlots);
+	this->TargetRing.Shrink();
+	this->DeltaRing.SetNum(NumSlots);
+	this->DeltaRing.Shrink();
+	this->Entries.Reserve(MaxEntries);
+}
+
+bool GizmoIsCarriedByTarget(const USceneComponent* Target, const TSet<const USceneComponent*>& Targets)
+{
+	for (const USceneComponent* Child = Target; Child->GetAttachParent(); Child = Child->GetAttachParent())
+	{
+		if (Child->IsUsingAbsoluteLocation() || Child->IsUsingAbsoluteRotation() || Child->IsUsingAbsoluteScale())
+		{
+			return false;
+		}
+
+		if (Targets.Contains(Child->GetAttachParent()))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FGizmoHistory::Commit(TConstArrayView<TWeakObjectPtr<USceneComponent>> Targets, TConstArrayView<FTransform> StartTransforms)
+{
+	const int32 NumCandidates = FMath::Min(Targets.Num(), StartTransforms.Num());
+
+	if (NumCandidates == 0 || this->TargetRing.IsEmpty())
+	{
+		return false;
+	}
+
+	TSet<const USceneComponent*> TargetSet;
+	TargetSet.Reserve(NumCandidates);
+
+	for (int32 TargetIndex = 0; TargetIndex < NumCandidates; TargetIndex++)
+	{
+		TargetSet.Add(Targets[TargetIndex].Get());
+	}
+
+	// A child moved with its parent already. Applying its own delta on top would move it twice on undo.
+	TArray<USceneComponent*, TInlineAllocator<16>> Recorded;
+	TArray<FGizmoQuantizedDelta, TInlineAllocator<16>> Deltas;
+
+	bool bHasChange = false;
+	bool bSharedDelta = true;
+
+	for (int32 TargetIndex = 0; TargetIndex < NumCandidates; TargetIndex++)
+	{
+		USceneComponent* EachTarget = Targets[TargetIndex].Get();
+
+		if (!IsValid(EachTarget) || GizmoIsCarriedByTarget(EachTarget, TargetSet))
+		{
+			continue;
+		}
+
+		Recorded.Add(EachTarget);
+		Deltas.Add(FGizmoQuantizedDelta::Quantize(StartTransforms[TargetIndex], EachTarget->GetComponentTransform()));
+
+		bHasChange |= !Deltas.Last().IsIdentity();
+		bSharedDelta &= Deltas.Last() == Deltas[0];
+	}
+
+	// A click without movement is not worth an undo step.
+	if (!bHasChange)
+	{
+		return false;
+	}
+
+	const int32 NumTargets = Recorded.Num();
+	const int32 NumDeltas = bSharedDelta ? 1 : NumTargets;
+
+	// New edit after an undo replaces the redo branch.
+	this->Entries.SetNum(this->Cursor);
+
+	int32 TargetOffset = 0;
+	int32 DeltaOffset = 0;
+
+	if (!this->Allocate(NumTargets, NumDeltas, TargetOffset, DeltaOffset))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo History : Drag of %d targets does not fit the history capacity."), NumTargets);
+		return false;
+	}
+
+	for (int32 TargetIndex = 0; TargetIndex < NumTargets; TargetIndex++)
+	{
+		this->TargetRing[TargetOffset + TargetIndex] = Recorded[TargetIndex];
+	}
+
+	for (int32 DeltaIndex = 0; DeltaIndex < NumDeltas; DeltaIndex++)
+	{
+		this->DeltaRing[DeltaOffset + DeltaIndex] = Deltas[DeltaIndex];
+	}
+
+	FEntry NewEntry;
+	NewEntry.TargetOffset = TargetOffset;
+	NewEntry.DeltaOffset = DeltaOffset;
+	NewEntry.NumTargets = NumTargets;
+	NewEntry.bSharedDelta = bSharedDelta;
+
+	this->Entries.Add(NewEntry);
+	this->Cursor = this->Entries.Num();
+
+	return true;
+}
+
+bool FGizmoHistory::Allocate(int32 NumTargets, int32 NumDeltas, int32& Out_TargetOffset, int32& Out_DeltaOffset)
+{
+	if (NumTargets > this->TargetRing.Num() || NumDeltas > this->DeltaRing.Num())
+	{
+		return false;
+	}
+
+	Out_TargetOffset = 0;
+	Out_DeltaOffset = 0;
+
+	if (!this->Entries.IsEmpty())
+	{
+		Out_TargetOffset = this->Entries.Last().TargetOffset + this->Entries.Last().NumTargets;
+		Out_DeltaOffset = this->Entries.Last().DeltaOffset + this->Entries.Last().GetNumDeltas();
+	}
+
+	if (Out_TargetOffset + NumTargets > this->TargetRing.Num())
+	{
+		Out_TargetOffset = 0;
+	}
+
+	if (Out_DeltaOffset + NumDeltas > this->DeltaRing.Num())
+	{
+		Out_DeltaOffset = 0;
+	}
+
+	// Evict everything up to the newest entry overlapping either ring, so the history stays contiguous.
+	int32 NumEvicted = FMath::Max(this->Entries.Num() - (MaxEntries - 1), 0);
+
+	for (int32 EntryIndex = 0; EntryIndex < this->Entries.Num(); EntryIndex++)
+	{
+		const FEntry& EachEntry = this->Entries[EntryIndex];
+
+		const bool bTargetsOverlap = EachEntry.TargetOffset < Out_TargetOffset + NumTargets && Out_TargetOffset < EachEntry.TargetOffset + EachEntry.NumTargets;
+		const bool bDeltasOverlap = EachEntry.DeltaOffset < Out_DeltaOffset + NumDeltas && Out_DeltaOffset < EachEntry.DeltaOffset + EachEntry.GetNumDeltas();
+
+		if (bTargetsOverlap || bDeltasOverlap)
+		{
+			NumEvicted = EntryIndex + 1;
+		}
+	}
+
+	if (NumEvicted > 0)
+	{
+		this->Entries.RemoveAt(0, NumEvicted);
+		this->Cursor = FMath::Max(this->Cursor - NumEvicted, 0);
+	}
+
+	return true;
+}
+
+bool FGizmoHistory::ApplyEntry(const FEntry& Entry, bool bInverse, TArray<USceneComponent*>* Out_Targets)
+{
+	bool bApplied = false;
+
+	// One write per target. Targets destroyed since the drag are skipped.
+	for (int32 TargetIndex = 0; TargetIndex < Entry.NumTargets; TargetIndex++)
+	{
+		USceneComponent* EachTarget = this->TargetRing[Entry.TargetOffset + TargetIndex].Get();
+
+		if (!IsValid(EachTarget))
+		{
+			continue;
+		}
+
+		const FGizmoQuantizedDelta& Delta = this->DeltaRing[Entry.DeltaOffset + (Entry.bSharedDelta ? 0 : TargetIndex)];
+
+		EachTarget->SetWorldTransform(Delta.Apply(EachTarget->GetComponentTransform(), bInverse), false, nullptr, ETeleportType::TeleportPhysics);
+		bApplied = true;
+
+		if (Out_Targets)
+		{
+			Out_Targets->Add(EachTarget);
+		}
+	}
+
+	return bApplied;
+}
+
+bool FGizmoHistory::Undo(TArray<USceneComponent*>* Out_Targets)
+{
+	if (!this->CanUndo())
+	{
+		return false;
+	}
+
+	this->Cursor--;
+	return this->ApplyEntry(this->Entries[this->Cursor], true, Out_Targets);
+}
+
+bool FGizmoHistory::Redo(TArray<USceneComponent*>* Out_Targets)
+{
+	if (!this->CanRedo())
+	{
+		return false;
+	}
+
+	this->Cursor++;
+	return this->ApplyEntry(this->Entries[this->Cursor - 1], false, Out_Targets);
+}
+
+bool FGizmoHistory::CanUndo() const
+{
+	return this->Cursor > 0;
+}
+
+bool FGizmoHistory::CanRedo() const
+{
+	return this->Cursor < this->Entries.Num();
+}
+
+void FGizmoHistory::Reset()
+{
+	this->Entries.Reset();
+	this->Cursor = 0;
+}
+
+int32 FGizmoHistory::GetNumEntries() const
+{
+	return this->Entries.Num();
+}
+
+int64 FGizmoHistory::GetUsedBytes() const
+{
+	int64 UsedBytes = 0;
+
+	for (const FEntry& EachEntry : this->Entries)
+	{
+		UsedBytes += EachEntry.NumTargets * sizeof(TWeakObjectPtr<USceneComponent>) + EachEntry.GetNumDeltas() * sizeof(FGizmoQuantizedDelta);
+	}
+
+	return UsedBytes;
+}
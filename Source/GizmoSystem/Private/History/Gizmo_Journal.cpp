@@ -0,0 +1,400 @@
+#include "History/Gizmo_Journal.h"
+
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Crc.h"
+#include "Misc/Paths.h"
+
+static constexpr uint32 GizmoJournalMagic = 0x314A5A47; // "GZJ1"
+static constexpr uint32 GizmoJournalVersion = 1;
+static constexpr int32 GizmoJournalHeaderSize = sizeof(uint32) * 2;
+static constexpr int32 GizmoJournalTransformSize = sizeof(double) * 10;
+
+// Background thread wakes up at least this often, so records are never older than this on disk.
+static constexpr uint32 GizmoJournalFlushIntervalMs = 100;
+
+FGizmoJournal::FGizmoJournal(const FString& In_FilePath) : FilePath(In_FilePath)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(this->FilePath));
+
+	bool bIsNew = PlatformFile.FileSize(*this->FilePath) < GizmoJournalHeaderSize;
+
+	// Appending to a journal of another version would make the whole file unreadable.
+	if (!bIsNew)
+	{
+		uint32 Header[2] = {};
+		TUniquePtr<IFileHandle> ExistingFile(PlatformFile.OpenRead(*this->FilePath));
+
+		if (!ExistingFile.IsValid() || !ExistingFile->Read((uint8*)Header, sizeof(Header)) || Header[0] != GizmoJournalMagic || Header[1] != GizmoJournalVersion)
+		{
+			ExistingFile.Reset();
+
+			const FString RotatedPath = FPaths::Combine(FPaths::GetPath(this->FilePath), FPaths::GetBaseFilename(this->FilePath) + FDateTime::Now().ToString(TEXT("_%Y%m%d_%H%M%S")) + TEXT(".old"));
+
+			if (!PlatformFile.MoveFile(*RotatedPath, *this->FilePath))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Gizmo Journal : %s has another version and could not be moved aside."), *this->FilePath);
+				return;
+			}
+
+			UE_LOG(LogTemp, Warning, TEXT("Gizmo Journal : %s has another version, moved to %s."), *this->FilePath, *RotatedPath);
+			bIsNew = true;
+		}
+	}
+
+	this->File.Reset(PlatformFile.OpenWrite(*this->FilePath, !bIsNew, true));
+
+	if (!this->File.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Journal : %s could not be opened."), *this->FilePath);
+		return;
+	}
+
+	const uint32 Header[2] = { GizmoJournalMagic, GizmoJournalVersion };
+
+	if (bIsNew && !this->WriteAndFlush((const uint8*)Header, sizeof(Header)))
+	{
+		return;
+	}
+
+	this->WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	this->Thread = FRunnableThread::Create(this, TEXT("GizmoJournal"), 0, TPri_BelowNormal);
+
+	if (!this->Thread)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gizmo Journal : Writer thread could not be started, edits are not journaled to %s."), *this->FilePath);
+		this->Status = EGizmoJournalStatus::Thread_Failed;
+		return;
+	}
+
+	this->Status = EGizmoJournalStatus::Open;
+}
+
+FGizmoJournal::~FGizmoJournal()
+{
+	if (this->Thread)
+	{
+		this->Thread->Kill(true);
+		delete this->Thread;
+		this->Thread = nullptr;
+	}
+
+	if (this->WakeEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(this->WakeEvent);
+		this->WakeEvent = nullptr;
+	}
+
+	// Anything queued after the thread stopped.
+	if (this->File.IsValid())
+	{
+		this->WritePending();
+	}
+}
+
+bool FGizmoJournal::IsOpen() const
+{
+	return this->Status == EGizmoJournalStatus::Open;
+}
+
+EGizmoJournalStatus FGizmoJournal::GetStatus() const
+{
+	return this->Status;
+}
+
+const FString& FGizmoJournal::GetFilePath() const
+{
+	return this->FilePath;
+}
+
+const FString& FGizmoJournal::GetTargetPath(const USceneComponent* Target)
+{
+	if (const FString* CachedPath = this->PathCache.Find(Target))
+	{
+		return *CachedPath;
+	}
+
+	// Stored without the PIE prefix, so a PIE session can be recovered in the editor world and the other way around.
+	return this->PathCache.Add(Target, UWorld::RemovePIEPrefix(Target->GetPathName()));
+}
+
+void FGizmoJournal::CachePaths(TConstArrayView<USceneComponent*> Targets)
+{
+	if (!this->IsOpen())
+	{
+		return;
+	}
+
+	for (const USceneComponent* EachTarget : Targets)
+	{
+		if (IsValid(EachTarget))
+		{
+			this->GetTargetPath(EachTarget);
+		}
+	}
+}
+
+void FGizmoJournal::Append(const USceneComponent* Target)
+{
+	if (!this->IsOpen() || !IsValid(Target))
+	{
+		return;
+	}
+
+	FGizmoJournalRecord Record;
+	Record.TargetPath = this->GetTargetPath(Target);
+	Record.Transform = Target->GetComponentTransform();
+
+	this->Pending.Enqueue(MoveTemp(Record));
+	this->WakeEvent->Trigger();
+}
+
+void FGizmoJournal::Truncate()
+{
+	if (!this->IsOpen())
+	{
+		return;
+	}
+
+	this->Pending.Enqueue(FGizmoJournalRecord());
+	this->WakeEvent->Trigger();
+}
+
+uint32 FGizmoJournal::Run()
+{
+	while (!this->bStopping)
+	{
+		this->WakeEvent->Wait(GizmoJournalFlushIntervalMs);
+		this->WritePending();
+	}
+
+	this->WritePending();
+	return 0;
+}
+
+void FGizmoJournal::Stop()
+{
+	this->bStopping = true;
+
+	if (this->WakeEvent)
+	{
+		this->WakeEvent->Trigger();
+	}
+}
+
+void FGizmoJournal::WritePending()
+{
+	this->WriteBuffer.Reset();
+
+	FGizmoJournalRecord Record;
+
+	while (this->Pending.Dequeue(Record))
+	{
+		// Records queued before the truncate are dropped, whether they were written or not.
+		if (Record.TargetPath.IsEmpty())
+		{
+			this->WriteBuffer.Reset();
+			this->Reopen();
+			continue;
+		}
+
+		// Still drained after a failure, so the queue does not grow.
+		if (!this->File.IsValid())
+		{
+			continue;
+		}
+
+		const FTCHARToUTF8 PathUTF8(*Record.TargetPath);
+		const uint16 PathLength = (uint16)FMath::Min(PathUTF8.Length(), (int32)MAX_uint16);
+
+		const FVector Location = Record.Transform.GetLocation();
+		const FQuat Rotation = Record.Transform.GetRotation();
+		const FVector Scale = Record.Transform.GetScale3D();
+		const double TransformData[10] = { Location.X, Location.Y, Location.Z, Rotation.X, Rotation.Y, Rotation.Z, Rotation.W, Scale.X, Scale.Y, Scale.Z };
+
+		const uint32 PayloadSize = sizeof(uint16) + PathLength + GizmoJournalTransformSize;
+		const int32 RecordOffset = this->WriteBuffer.AddUninitialized(sizeof(uint32) + PayloadSize + sizeof(uint32));
+
+		uint8* Data = this->WriteBuffer.GetData() + RecordOffset;
+		FMemory::Memcpy(Data, &PayloadSize, sizeof(uint32));
+
+		uint8* Payload = Data + sizeof(uint32);
+		FMemory::Memcpy(Payload, &PathLength, sizeof(uint16));
+		FMemory::Memcpy(Payload + sizeof(uint16), PathUTF8.Get(), PathLength);
+		FMemory::Memcpy(Payload + sizeof(uint16) + PathLength, TransformData, GizmoJournalTransformSize);
+
+		const uint32 Crc = FCrc::MemCrc32(Payload, PayloadSize);
+		FMemory::Memcpy(Payload + PayloadSize, &Crc, sizeof(uint32));
+	}
+
+	if (this->WriteBuffer.IsEmpty() || !this->File.IsValid())
+	{
+		return;
+	}
+
+	this->WriteAndFlush(this->WriteBuffer.GetData(), this->WriteBuffer.Num());
+}
+
+bool FGizmoJournal::Reopen()
+{
+	// Closed first, some platforms do not open a file for writing twice.
+	this->File.Reset();
+	this->File.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*this->FilePath, false, true));
+
+	if (!this->File.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Gizmo Journal : %s could not be truncated, edits are no longer journaled."), *this->FilePath);
+		this->Status = EGizmoJournalStatus::File_Failed;
+		return false;
+	}
+
+	const uint32 Header[2] = { GizmoJournalMagic, GizmoJournalVersion };
+	return this->WriteAndFlush((const uint8*)Header, sizeof(Header));
+}
+
+bool FGizmoJournal::WriteAndFlush(const uint8* Data, int64 Size)
+{
+	if (this->File->Write(Data, Size) && this->File->Flush())
+	{
+		return true;
+	}
+
+	// A partly written record ends the replay there, so nothing after it would be readable anyway.
+	UE_LOG(LogTemp, Error, TEXT("Gizmo Journal : Writing %s failed, edits are no longer journaled."), *this->FilePath);
+	this->Status = EGizmoJournalStatus::Write_Failed;
+	this->File.Reset();
+	return false;
+}
+
+bool FGizmoJournal::Read(const FString& FilePath, TArray<FGizmoJournalRecord>& Out_Records)
+{
+	Out_Records.Reset();
+
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() < GizmoJournalHeaderSize)
+	{
+		return false;
+	}
+
+	TUniquePtr<IMappedFileRegion> Region(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+
+	if (!Region.IsValid())
+	{
+		return false;
+	}
+
+	const uint8* Data = Region->GetMappedPtr();
+	const int64 Size = Region->GetMappedSize();
+
+	uint32 Header[2];
+	FMemory::Memcpy(Header, Data, sizeof(Header));
+
+	if (Header[0] != GizmoJournalMagic || Header[1] != GizmoJournalVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Journal : %s is not a gizmo journal."), *FilePath);
+		return false;
+	}
+
+	int64 Offset = GizmoJournalHeaderSize;
+
+	while (Offset + (int64)sizeof(uint32) <= Size)
+	{
+		uint32 PayloadSize;
+		FMemory::Memcpy(&PayloadSize, Data + Offset, sizeof(uint32));
+
+		if (PayloadSize < sizeof(uint16) + GizmoJournalTransformSize || Offset + sizeof(uint32) + PayloadSize + sizeof(uint32) > Size)
+		{
+			break;
+		}
+
+		const uint8* Payload = Data + Offset + sizeof(uint32);
+
+		uint32 Crc;
+		FMemory::Memcpy(&Crc, Payload + PayloadSize, sizeof(uint32));
+
+		if (Crc != FCrc::MemCrc32(Payload, PayloadSize))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Gizmo Journal : %s is damaged after %d records."), *FilePath, Out_Records.Num());
+			break;
+		}
+
+		uint16 PathLength;
+		FMemory::Memcpy(&PathLength, Payload, sizeof(uint16));
+
+		if (sizeof(uint16) + PathLength + GizmoJournalTransformSize != PayloadSize)
+		{
+			break;
+		}
+
+		double TransformData[10];
+		FMemory::Memcpy(TransformData, Payload + sizeof(uint16) + PathLength, GizmoJournalTransformSize);
+
+		FGizmoJournalRecord& Record = Out_Records.AddDefaulted_GetRef();
+		Record.TargetPath = FString(FUTF8ToTCHAR((const ANSICHAR*)(Payload + sizeof(uint16)), PathLength));
+		Record.Transform = FTransform(FQuat(TransformData[3], TransformData[4], TransformData[5], TransformData[6]), FVector(TransformData[0], TransformData[1], TransformData[2]), FVector(TransformData[7], TransformData[8], TransformData[9]));
+
+		Offset += sizeof(uint32) + PayloadSize + sizeof(uint32);
+	}
+
+	return true;
+}
+
+int32 FGizmoJournal::Replay(const FString& FilePath, const UWorld* World)
+{
+	TArray<FGizmoJournalRecord> Records;
+
+	if (!FGizmoJournal::Read(FilePath, Records))
+	{
+		return 0;
+	}
+
+	// Only the last transform of each target matters, so every target is written once.
+	TMap<FString, int32> LastRecords;
+	LastRecords.Reserve(Records.Num());
+
+	for (int32 RecordIndex = 0; RecordIndex < Records.Num(); RecordIndex++)
+	{
+		LastRecords.Add(Records[RecordIndex].TargetPath, RecordIndex);
+	}
+
+	const int32 PIEInstanceID = IsValid(World) && World->IsPlayInEditor() ? World->GetOutermost()->GetPIEInstanceID() : INDEX_NONE;
+	int32 NumApplied = 0;
+
+	for (const TPair<FString, int32>& EachRecord : LastRecords)
+	{
+		FString TargetPath = EachRecord.Key;
+
+		if (PIEInstanceID != INDEX_NONE)
+		{
+			FString PackageName;
+			FString ObjectPath;
+
+			if (TargetPath.Split(TEXT("."), &PackageName, &ObjectPath))
+			{
+				TargetPath = UWorld::ConvertToPIEPackageName(PackageName, PIEInstanceID) + TEXT(".") + ObjectPath;
+			}
+		}
+
+		USceneComponent* Target = FindObject<USceneComponent>(nullptr, *TargetPath);
+
+		if (!IsValid(Target))
+		{
+			continue;
+		}
+
+		Target->SetWorldTransform(Records[EachRecord.Value].Transform, false, nullptr, ETeleportType::TeleportPhysics);
+		NumApplied++;
+	}
+
+	return NumApplied;
+}
+
+FString FGizmoJournal::GetDefaultPath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Gizmo"), TEXT("GizmoJournal.bin"));
+}
@@ -0,0 +1,101 @@
+#include "History/Gizmo_Journal_Subsystem.h"
+#include "History/Gizmo_Journal.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/ObjectSaveContext.h"
+
+void UGizmoJournalSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+#if WITH_EDITOR
+	this->PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddUObject(this, &UGizmoJournalSubsystem::OnPackageSaved);
+#endif
+}
+
+void UGizmoJournalSubsystem::Deinitialize()
+{
+#if WITH_EDITOR
+	UPackage::PackageSavedWithContextEvent.Remove(this->PackageSavedHandle);
+#endif
+
+	// Engine shuts down cleanly, nothing is left to recover. Destroying the journals writes the truncation before their threads stop.
+	this->CheckpointJournals();
+	this->Journals.Empty();
+
+	Super::Deinitialize();
+}
+
+UGizmoJournalSubsystem* UGizmoJournalSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UGizmoJournalSubsystem>() : nullptr;
+}
+
+TSharedPtr<FGizmoJournal> UGizmoJournalSubsystem::AcquireJournal(const FString& FilePath)
+{
+	const FString FullPath = FPaths::ConvertRelativePathToFull(FilePath.IsEmpty() ? FGizmoJournal::GetDefaultPath() : FilePath);
+
+	FOpenJournal& Entry = this->Journals.FindOrAdd(FullPath);
+
+	if (!Entry.Journal.IsValid())
+	{
+		Entry.Journal = MakeShared<FGizmoJournal>(FullPath);
+	}
+
+	Entry.NumUsers++;
+	return Entry.Journal;
+}
+
+void UGizmoJournalSubsystem::ReleaseJournal(const TSharedPtr<FGizmoJournal>& Journal, bool bSessionEnded)
+{
+	if (!Journal.IsValid())
+	{
+		return;
+	}
+
+	const FString FullPath = Journal->GetFilePath();
+	FOpenJournal* Entry = this->Journals.Find(FullPath);
+
+	if (!Entry || Entry->Journal != Journal)
+	{
+		return;
+	}
+
+	Entry->NumUsers--;
+
+	if (Entry->NumUsers > 0)
+	{
+		return;
+	}
+
+	if (bSessionEnded)
+	{
+		Entry->Journal->Truncate();
+	}
+
+	this->Journals.Remove(FullPath);
+}
+
+void UGizmoJournalSubsystem::CheckpointJournals()
+{
+	for (const TPair<FString, FOpenJournal>& EachJournal : this->Journals)
+	{
+		EachJournal.Value.Journal->Truncate();
+	}
+}
+
+#if WITH_EDITOR
+void UGizmoJournalSubsystem::OnPackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext SaveContext)
+{
+	// Cooking and other procedural saves do not save the user's edits.
+	if (SaveContext.IsProceduralSave() || !UWorld::FindWorldInPackage(Package))
+	{
+		return;
+	}
+
+	this->CheckpointJournals();
+}
+#endif
@@ -0,0 +1,61 @@
+#include "Input/Gizmo_Input_Processor.h"
+
+#include "Framework/Application/SlateApplication.h"
+
+void FGizmoInputProcessor::Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor)
+{
+
+}
+
+bool FGizmoInputProcessor::HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	{
+		FScopeLock Lock(&this->LatestLock);
+		this->LatestScreenPosition = MouseEvent.GetScreenSpacePosition();
+		this->bHasLatestScreenPosition = true;
+	}
+
+	if (this->PendingSamples.IsEmpty())
+	{
+		this->OldestPendingTime = FPlatformTime::Seconds();
+	}
+
+	if (this->PendingSamples.Num() < MaxPendingSamples)
+	{
+		this->PendingSamples.Add(MouseEvent.GetScreenSpacePosition());
+	}
+
+	else
+	{
+		// Nobody consumed for a long time. Keep the newest position rather than growing without bound.
+		this->PendingSamples.Last() = MouseEvent.GetScreenSpacePosition();
+		this->NumCoalesced++;
+	}
+
+	// Never consume the event, the game and UI still need it.
+	return false;
+}
+
+const TCHAR* FGizmoInputProcessor::GetDebugName() const
+{
+	return TEXT("GizmoInputProcessor");
+}
+
+void FGizmoInputProcessor::ConsumeSamples(TArray<FVector2D>& Out_Samples, double& Out_OldestTime)
+{
+	Out_OldestTime = this->PendingSamples.IsEmpty() ? 0 : this->OldestPendingTime;
+	Out_Samples.Append(this->PendingSamples);
+	this->PendingSamples.Reset();
+}
+
+int32 FGizmoInputProcessor::GetNumCoalesced() const
+{
+	return this->NumCoalesced;
+}
+
+bool FGizmoInputProcessor::GetLatestScreenPosition(FVector2D& Out_ScreenPosition) const
+{
+	FScopeLock Lock(&this->LatestLock);
+	Out_ScreenPosition = this->LatestScreenPosition;
+	return this->bHasLatestScreenPosition;
+}
@@ -0,0 +1,573 @@
+#include "Input/Gizmo_Input_Recorder.h"
+
+#include "Math/Gizmo_Math_Base.h"
+#include "Math/Gizmo_Math_Move.h"
+#include "Math/Gizmo_Math_Rotate.h"
+#include "Math/Gizmo_Math_Scale.h"
+
+#include "Components/ChildActorComponent.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+
+static constexpr uint32 GizmoRecordMagic = 0x31495A47; // "GZI1"
+static constexpr uint32 GizmoRecordVersion = 2;
+
+// Optional fields of a frame record, written in this order.
+static constexpr uint8 GizmoRecordView = 1 << 0;
+static constexpr uint8 GizmoRecordKeys = 1 << 1;
+static constexpr uint8 GizmoRecordAxis = 1 << 2;
+static constexpr uint8 GizmoRecordTargets = 1 << 3;
+static constexpr uint8 GizmoRecordSamples = 1 << 4;
+static constexpr uint8 GizmoRecordDelta = 1 << 5;
+static constexpr uint8 GizmoRecordWheel = 1 << 6;
+
+// Last record of a file. Only carries the final target crc.
+static constexpr uint8 GizmoRecordEnd = 1 << 7;
+
+// bMoveLocal or bRotateLocal, or the ScalePivot of a scale gizmo. Each decides the frame the drag is solved in.
+static uint8 GizmoGetChildMode(const AActor* Gizmo)
+{
+	if (const AGizmoMathMove* GizmoMove = Cast<AGizmoMathMove>(Gizmo))
+	{
+		return GizmoMove->bMoveLocal ? 1 : 0;
+	}
+
+	else if (const AGizmoMathRotate* GizmoRotate = Cast<AGizmoMathRotate>(Gizmo))
+	{
+		return GizmoRotate->bRotateLocal ? 1 : 0;
+	}
+
+	else if (const AGizmoMathScale* GizmoScale = Cast<AGizmoMathScale>(Gizmo))
+	{
+		return static_cast<uint8>(GizmoScale->ScalePivot);
+	}
+
+	return 0;
+}
+
+static void GizmoSetChildMode(AActor* Gizmo, uint8 Mode)
+{
+	if (AGizmoMathMove* GizmoMove = Cast<AGizmoMathMove>(Gizmo))
+	{
+		GizmoMove->bMoveLocal = Mode != 0;
+	}
+
+	else if (AGizmoMathRotate* GizmoRotate = Cast<AGizmoMathRotate>(Gizmo))
+	{
+		GizmoRotate->bRotateLocal = Mode != 0;
+	}
+
+	else if (AGizmoMathScale* GizmoScale = Cast<AGizmoMathScale>(Gizmo))
+	{
+		// Out of range modes come from a damaged file, the class default is kept.
+		if (Mode <= static_cast<uint8>(EScalePivot::Selection_Center))
+		{
+			GizmoScale->ScalePivot = static_cast<EScalePivot>(Mode);
+		}
+	}
+}
+
+// Both matrices are stored, so the replay never depends on how the inverse is computed.
+static void GizmoSerializeView(FArchive& Ar, FGizmoViewState& View)
+{
+	uint8 bIsValid = View.bIsValid ? 1 : 0;
+
+	Ar << bIsValid;
+	Ar << View.ViewRect;
+	Ar << View.ViewProjectionMatrix;
+	Ar << View.InvViewProjectionMatrix;
+	Ar << View.ViewOrigin;
+	Ar << View.ViewDirection;
+
+	View.bIsValid = bIsValid != 0;
+}
+
+static bool GizmoIsSameView(const FGizmoViewState& A, const FGizmoViewState& B)
+{
+	return A.bIsValid == B.bIsValid && A.ViewRect == B.ViewRect && A.ViewProjectionMatrix == B.ViewProjectionMatrix && A.ViewOrigin == B.ViewOrigin;
+}
+
+FGizmoInputRecorder::FGizmoInputRecorder(const FString& In_FilePath) : FilePath(In_FilePath)
+{
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(this->FilePath), true);
+	this->Writer.Reset(IFileManager::Get().CreateFileWriter(*this->FilePath));
+
+	if (!this->Writer.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Input Recorder : %s could not be opened."), *this->FilePath);
+	}
+}
+
+FGizmoInputRecorder::~FGizmoInputRecorder()
+{
+	if (!this->Writer.IsValid())
+	{
+		return;
+	}
+
+	if (this->bHeaderWritten)
+	{
+		this->Targets.Reset();
+
+		for (const TWeakObjectPtr<USceneComponent>& EachTarget : this->LastTargets)
+		{
+			if (EachTarget.IsValid())
+			{
+				this->Targets.Add(EachTarget.Get());
+			}
+		}
+
+		uint8 Flags = GizmoRecordEnd;
+		uint32 Checksum = FGizmoInputRecorder::GetTargetsChecksum(this->Targets);
+
+		*this->Writer << Flags;
+		*this->Writer << Checksum;
+	}
+
+	this->Writer->Close();
+	UE_LOG(LogTemp, Display, TEXT("Gizmo Input Recorder : %d frames written to %s"), this->NumFrames, *this->FilePath);
+}
+
+bool FGizmoInputRecorder::IsOpen() const
+{
+	return this->Writer.IsValid();
+}
+
+void FGizmoInputRecorder::WriteHeader(const AGizmoMathBase* Base)
+{
+	const AActor* ChildGizmo = Base->GizmoType->GetChildActor();
+
+	uint32 Magic = GizmoRecordMagic;
+	uint32 Version = GizmoRecordVersion;
+	FString GizmoClassPath = IsValid(ChildGizmo) ? ChildGizmo->GetClass()->GetPathName() : FString();
+	uint8 Mode = GizmoGetChildMode(ChildGizmo);
+
+	FArchive& Ar = *this->Writer;
+	Ar << Magic;
+	Ar << Version;
+	Ar << GizmoClassPath;
+	Ar << Mode;
+
+	this->bHeaderWritten = true;
+}
+
+void FGizmoInputRecorder::RecordFrame(const AGizmoMathBase* Base, float DeltaTime)
+{
+	if (!this->IsOpen() || !IsValid(Base))
+	{
+		return;
+	}
+
+	if (!this->bHeaderWritten)
+	{
+		this->WriteHeader(Base);
+	}
+
+	const FGizmoInputFrame& Input = Base->InputFrame;
+	Base->GetAllTargets(this->Targets);
+
+	const TSet<FKey>& PressedKeys = Base->GetPressedKeys();
+	const ESelectedAxis Axis = Base->GetSelectedAxis();
+
+	bool bKeysChanged = PressedKeys.Num() != this->LastKeys.Num();
+
+	for (int32 KeyIndex = 0; KeyIndex < this->LastKeys.Num() && !bKeysChanged; KeyIndex++)
+	{
+		bKeysChanged = !PressedKeys.Contains(this->LastKeys[KeyIndex]);
+	}
+
+	bool bTargetsChanged = this->Targets.Num() != this->LastTargets.Num();
+
+	for (int32 TargetIndex = 0; TargetIndex < this->Targets.Num() && !bTargetsChanged; TargetIndex++)
+	{
+		bTargetsChanged = this->LastTargets[TargetIndex].Get() != this->Targets[TargetIndex];
+	}
+
+	uint8 Flags = 0;
+	Flags |= !this->bHasLastView || !GizmoIsSameView(this->LastView, Input.View) ? GizmoRecordView : 0;
+	Flags |= bKeysChanged ? GizmoRecordKeys : 0;
+	Flags |= Axis != this->LastAxis ? GizmoRecordAxis : 0;
+	Flags |= bTargetsChanged ? GizmoRecordTargets : 0;
+	Flags |= !Input.Samples.IsEmpty() ? GizmoRecordSamples : 0;
+	Flags |= !Input.MouseDelta.IsZero() ? GizmoRecordDelta : 0;
+	Flags |= Input.MouseWheel != 0 ? GizmoRecordWheel : 0;
+
+	uint32 Checksum = FGizmoInputRecorder::GetTargetsChecksum(this->Targets);
+	FVector2D MousePosition = Input.MousePosition;
+
+	FArchive& Ar = *this->Writer;
+	Ar << Flags;
+	Ar << DeltaTime;
+	Ar << MousePosition;
+	Ar << Checksum;
+
+	if (Flags & GizmoRecordView)
+	{
+		this->LastView = Input.View;
+		this->bHasLastView = true;
+
+		GizmoSerializeView(Ar, this->LastView);
+	}
+
+	if (Flags & GizmoRecordKeys)
+	{
+		this->LastKeys = PressedKeys.Array();
+
+		uint8 NumKeys = (uint8)FMath::Min(this->LastKeys.Num(), (int32)MAX_uint8);
+		Ar << NumKeys;
+
+		for (int32 KeyIndex = 0; KeyIndex < NumKeys; KeyIndex++)
+		{
+			FString KeyName = this->LastKeys[KeyIndex].GetFName().ToString();
+			Ar << KeyName;
+		}
+	}
+
+	if (Flags & GizmoRecordAxis)
+	{
+		uint8 AxisValue = (uint8)Axis;
+		Ar << AxisValue;
+
+		this->LastAxis = Axis;
+	}
+
+	if (Flags & GizmoRecordTargets)
+	{
+		int32 NumTargets = this->Targets.Num();
+		Ar << NumTargets;
+
+		this->LastTargets.Reset(NumTargets);
+
+		for (USceneComponent* EachTarget : this->Targets)
+		{
+			FTransform Transform = EachTarget->GetComponentTransform();
+			Ar << Transform;
+
+			this->LastTargets.Add(EachTarget);
+		}
+	}
+
+	if (Flags & GizmoRecordSamples)
+	{
+		uint16 NumSamples = (uint16)FMath::Min(Input.Samples.Num(), (int32)MAX_uint16);
+		Ar << NumSamples;
+
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+		{
+			FVector2D Sample = Input.Samples[SampleIndex];
+			Ar << Sample;
+		}
+	}
+
+	if (Flags & GizmoRecordDelta)
+	{
+		FVector2D MouseDelta = Input.MouseDelta;
+		Ar << MouseDelta;
+	}
+
+	if (Flags & GizmoRecordWheel)
+	{
+		float MouseWheel = Input.MouseWheel;
+		Ar << MouseWheel;
+	}
+
+	this->NumFrames++;
+}
+
+bool FGizmoInputRecorder::Read(const FString& FilePath, FGizmoInputRecording& Out_Recording)
+{
+	Out_Recording = FGizmoInputRecording();
+
+	TArray<uint8> Data;
+
+	if (!FFileHelper::LoadFileToArray(Data, *FilePath))
+	{
+		return false;
+	}
+
+	FMemoryReader Ar(Data);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+
+	Ar << Magic;
+	Ar << Version;
+
+	if (Ar.IsError() || Magic != GizmoRecordMagic || Version != GizmoRecordVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Input Recorder : %s is not a gizmo input recording."), *FilePath);
+		return false;
+	}
+
+	Ar << Out_Recording.GizmoClassPath;
+	Ar << Out_Recording.ChildMode;
+
+	// Fields that are not written on a frame carry over from the previous one.
+	FGizmoViewState View;
+	TArray<FKey> Keys;
+	ESelectedAxis Axis = ESelectedAxis::Null_Axis;
+
+	while (!Ar.AtEnd() && !Ar.IsError())
+	{
+		uint8 Flags = 0;
+		Ar << Flags;
+
+		if (Flags & GizmoRecordEnd)
+		{
+			Ar << Out_Recording.FinalChecksum;
+			Out_Recording.bHasFinalChecksum = !Ar.IsError();
+			break;
+		}
+
+		FGizmoInputRecordFrame Frame;
+		Ar << Frame.DeltaTime;
+		Ar << Frame.Input.MousePosition;
+		Ar << Frame.TargetChecksum;
+
+		if (Flags & GizmoRecordView)
+		{
+			GizmoSerializeView(Ar, View);
+		}
+
+		if (Flags & GizmoRecordKeys)
+		{
+			uint8 NumKeys = 0;
+			Ar << NumKeys;
+
+			Keys.Reset(NumKeys);
+
+			for (int32 KeyIndex = 0; KeyIndex < NumKeys && !Ar.IsError(); KeyIndex++)
+			{
+				FString KeyName;
+				Ar << KeyName;
+
+				Keys.Add(FKey(FName(*KeyName)));
+			}
+		}
+
+		if (Flags & GizmoRecordAxis)
+		{
+			uint8 AxisValue = 0;
+			Ar << AxisValue;
+
+			Axis = (ESelectedAxis)AxisValue;
+		}
+
+		if (Flags & GizmoRecordTargets)
+		{
+			int32 NumTargets = 0;
+			Ar << NumTargets;
+
+			// A transform is at least ten doubles, anything larger than the rest of the file is damage.
+			if (NumTargets < 0 || NumTargets * (int64)sizeof(double) * 10 > Ar.TotalSize() - Ar.Tell())
+			{
+				Ar.SetError();
+				break;
+			}
+
+			TArray<FTransform>& Snapshot = Out_Recording.TargetSnapshots.AddDefaulted_GetRef();
+			Snapshot.SetNum(NumTargets);
+
+			for (FTransform& EachTransform : Snapshot)
+			{
+				Ar << EachTransform;
+			}
+
+			Frame.TargetSnapshot = Out_Recording.TargetSnapshots.Num() - 1;
+		}
+
+		if (Flags & GizmoRecordSamples)
+		{
+			uint16 NumSamples = 0;
+			Ar << NumSamples;
+
+			Frame.Input.Samples.SetNum(NumSamples);
+
+			for (FVector2D& EachSample : Frame.Input.Samples)
+			{
+				Ar << EachSample;
+			}
+		}
+
+		if (Flags & GizmoRecordDelta)
+		{
+			Ar << Frame.Input.MouseDelta;
+		}
+
+		if (Flags & GizmoRecordWheel)
+		{
+			Ar << Frame.Input.MouseWheel;
+		}
+
+		if (Ar.IsError())
+		{
+			break;
+		}
+
+		Frame.Input.View = View;
+		Frame.Keys = Keys;
+		Frame.Axis = Axis;
+
+		Out_Recording.Frames.Add(MoveTemp(Frame));
+	}
+
+	// Recordings cut by a crash have no end record. The intact frames still replay.
+	if (!Out_Recording.bHasFinalChecksum)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Input Recorder : %s ends without an end record after %d frames."), *FilePath, Out_Recording.Frames.Num());
+	}
+
+	return true;
+}
+
+uint32 FGizmoInputRecorder::GetTargetsChecksum(TConstArrayView<USceneComponent*> Targets)
+{
+	uint32 Crc = 0;
+
+	for (const USceneComponent* EachTarget : Targets)
+	{
+		const FTransform& Transform = EachTarget->GetComponentTransform();
+		const FVector Location = Transform.GetLocation();
+		const FQuat Rotation = Transform.GetRotation();
+		const FVector Scale = Transform.GetScale3D();
+		const double TransformData[10] = { Location.X, Location.Y, Location.Z, Rotation.X, Rotation.Y, Rotation.Z, Rotation.W, Scale.X, Scale.Y, Scale.Z };
+
+		Crc = FCrc::MemCrc32(TransformData, sizeof(TransformData), Crc);
+	}
+
+	return Crc;
+}
+
+FString FGizmoInputRecorder::GetDefaultPath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Gizmo"), FString::Printf(TEXT("GizmoInput_%s.gzr"), *FDateTime::Now().ToString()));
+}
+
+FGizmoInputReplayer::FGizmoInputReplayer(const FGizmoInputRecording& In_Recording) : Recording(In_Recording)
+{
+
+}
+
+bool FGizmoInputReplayer::Begin(UWorld* World)
+{
+	UClass* GizmoClass = FSoftClassPath(this->Recording.GizmoClassPath).TryLoadClass<AActor>();
+
+	if (!IsValid(World) || !IsValid(GizmoClass))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Input Replayer : Gizmo class %s could not be loaded."), *this->Recording.GizmoClassPath);
+		return false;
+	}
+
+	int32 NumTargets = 0;
+
+	for (const TArray<FTransform>& EachSnapshot : this->Recording.TargetSnapshots)
+	{
+		NumTargets = FMath::Max(NumTargets, EachSnapshot.Num());
+	}
+
+	AActor* TargetHolder = World->SpawnActor<AActor>();
+	this->TargetPool.Reset(NumTargets);
+
+	for (int32 TargetIndex = 0; TargetIndex < NumTargets; TargetIndex++)
+	{
+		USceneComponent* EachTarget = NewObject<USceneComponent>(TargetHolder);
+		EachTarget->SetMobility(EComponentMobility::Movable);
+		EachTarget->RegisterComponent();
+
+		this->TargetPool.Add(EachTarget);
+	}
+
+	AGizmoMathBase* Base = World->SpawnActor<AGizmoMathBase>();
+	Base->GizmoType->SetChildActorClass(GizmoClass);
+	GizmoSetChildMode(Base->GizmoType->GetChildActor(), this->Recording.ChildMode);
+
+	this->GizmoBase = Base;
+	this->ActiveTargets.Reset();
+	this->NumMismatches = 0;
+
+	return true;
+}
+
+float FGizmoInputReplayer::ApplyFrame(int32 FrameIndex)
+{
+	AGizmoMathBase* Base = this->GizmoBase.Get();
+
+	if (!IsValid(Base) || !this->Recording.Frames.IsValidIndex(FrameIndex))
+	{
+		return 0;
+	}
+
+	const FGizmoInputRecordFrame& Frame = this->Recording.Frames[FrameIndex];
+
+	if (Frame.TargetSnapshot != INDEX_NONE)
+	{
+		const TArray<FTransform>& Snapshot = this->Recording.TargetSnapshots[Frame.TargetSnapshot];
+		this->ActiveTargets.Reset(Snapshot.Num());
+
+		for (int32 TargetIndex = 0; TargetIndex < Snapshot.Num(); TargetIndex++)
+		{
+			USceneComponent* EachTarget = this->TargetPool[TargetIndex];
+			EachTarget->SetWorldTransform(Snapshot[TargetIndex], false, nullptr, ETeleportType::TeleportPhysics);
+
+			this->ActiveTargets.Add(EachTarget);
+		}
+
+		Base->SetGizmoTargets(this->ActiveTargets, false);
+	}
+
+	this->CheckTargets(Frame.TargetChecksum, FrameIndex);
+
+	// Handles are picked by click events, which a headless world never sends. Replays select the recorded axis directly,
+	// and move, rotate and scale gizmos all begin the drag on their next tick through their BeginGrab.
+	Base->SetSelectedAxis(Frame.Axis);
+	Base->InjectInput(Frame.Input, Frame.Keys);
+
+	return Frame.DeltaTime;
+}
+
+bool FGizmoInputReplayer::Finish()
+{
+	if (this->Recording.bHasFinalChecksum)
+	{
+		this->CheckTargets(this->Recording.FinalChecksum, this->Recording.Frames.Num());
+	}
+
+	return this->NumMismatches == 0;
+}
+
+bool FGizmoInputReplayer::CheckTargets(uint32 Expected, int32 FrameIndex)
+{
+	if (FGizmoInputRecorder::GetTargetsChecksum(this->ActiveTargets) == Expected)
+	{
+		return true;
+	}
+
+	// Later frames follow from the first divergence, only that one is worth reporting.
+	if (this->NumMismatches == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Input Replayer : Target transforms diverge from the recording at frame %d."), FrameIndex);
+	}
+
+	this->NumMismatches++;
+	return false;
+}
+
+AGizmoMathBase* FGizmoInputReplayer::GetGizmoBase() const
+{
+	return this->GizmoBase.Get();
+}
+
+TConstArrayView<USceneComponent*> FGizmoInputReplayer::GetTargetPool() const
+{
+	return this->TargetPool;
+}
+
+int32 FGizmoInputReplayer::GetNumMismatches() const
+{
+	return this->NumMismatches;
+}
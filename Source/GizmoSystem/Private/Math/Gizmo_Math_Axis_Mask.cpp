@@ -0,0 +1,118 @@
+#include "Math/Gizmo_Math_Axis_Mask.h"
+
+// World space projection of every X, Y, Z combination. Diagonal, since world axes are the basis.
+static const FMatrix& GizmoWorldProjection(uint32 AxisBits)
+{
+	static const TStaticArray<FMatrix, 8> Projections = []()
+	{
+		TStaticArray<FMatrix, 8> Result;
+
+		for (uint32 Bits = 0; Bits < 8; ++Bits)
+		{
+			Result[Bits] = FMatrix(FPlane(0, 0, 0, 0), FPlane(0, 0, 0, 0), FPlane(0, 0, 0, 0), FPlane(0, 0, 0, 1));
+
+			for (int32 Index = 0; Index < 3; ++Index)
+			{
+				Result[Bits].M[Index][Index] = (Bits >> Index) & 1;
+			}
+		}
+
+		return Result;
+	}();
+
+	return Projections[AxisBits & 7];
+}
+
+EGizmoAxisMask GizmoAxisMaskFromSelected(ESelectedAxis Axis, EGizmoAxisMask Family)
+{
+	// X, Y, Z bits of each selection, shifted into the family below.
+	static constexpr uint32 SelectedBits[] = { 0, 1, 2, 4, 1 | 2, 1 | 4, 2 | 4, 1 | 2 | 4 };
+
+	const uint32 Shift = FMath::CountTrailingZeros(static_cast<uint32>(Family));
+	const uint32 Bits = SelectedBits[FMath::Min<uint32>(static_cast<uint32>(Axis), UE_ARRAY_COUNT(SelectedBits) - 1)];
+
+	if (Axis == ESelectedAxis::XYZ_Axis && Family == GizmoTranslateAxes)
+	{
+		return EGizmoAxisMask::View_Plane;
+	}
+
+	if (Axis == ESelectedAxis::XYZ_Axis && Family == GizmoRotateAxes)
+	{
+		return EGizmoAxisMask::Screen;
+	}
+
+	return static_cast<EGizmoAxisMask>(Bits << Shift);
+}
+
+uint32 GizmoAxisBits(EGizmoAxisMask Mask, EGizmoAxisMask Family)
+{
+	return (static_cast<uint32>(Mask) & static_cast<uint32>(Family)) >> FMath::CountTrailingZeros(static_cast<uint32>(Family));
+}
+
+int32 GizmoAxisCount(EGizmoAxisMask Mask, EGizmoAxisMask Family)
+{
+	return FMath::CountBits(GizmoAxisBits(Mask, Family));
+}
+
+FVector GizmoAxisSum(EGizmoAxisMask Mask, EGizmoAxisMask Family, const FQuat& Frame)
+{
+	const uint32 Bits = GizmoAxisBits(Mask, Family);
+	const FVector Axes[3] = { Frame.GetAxisX(), Frame.GetAxisY(), Frame.GetAxisZ() };
+	FVector Sum = FVector::ZeroVector;
+
+	for (int32 Index = 0; Index < 3; ++Index)
+	{
+		if ((Bits >> Index) & 1)
+		{
+			Sum += Axes[Index];
+		}
+	}
+
+	return Sum;
+}
+
+bool FGizmoAxisProjection::Init(EGizmoAxisMask Mask, const FQuat& Frame, const FVector& ViewDirection)
+{
+	this->Axis = FVector::ZeroVector;
+	this->PlaneNormal = FVector::ZeroVector;
+
+	if (EnumHasAnyFlags(Mask, EGizmoAxisMask::View_Plane))
+	{
+		this->PlaneNormal = -ViewDirection.GetSafeNormal();
+		this->NumAxes = 2;
+		this->Projection = FMatrix::Identity;
+
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			for (int32 Column = 0; Column < 3; ++Column)
+			{
+				this->Projection.M[Row][Column] -= this->PlaneNormal[Row] * this->PlaneNormal[Column];
+			}
+		}
+
+		return true;
+	}
+
+	const uint32 Bits = GizmoAxisBits(Mask, GizmoTranslateAxes);
+	this->NumAxes = FMath::CountBits(Bits);
+	this->Projection = GizmoWorldProjection(Bits);
+
+	// Local frames rotate the table entry: into the frame, project, back out.
+	if (!Frame.Equals(FQuat::Identity, 0))
+	{
+		const FMatrix Rotation = FQuatRotationMatrix(Frame);
+		this->Projection = Rotation.GetTransposed() * this->Projection * Rotation;
+	}
+
+	if (this->NumAxes == 1)
+	{
+		this->Axis = GizmoAxisSum(Mask, GizmoTranslateAxes, Frame);
+	}
+
+	else if (this->NumAxes == 2)
+	{
+		this->PlaneNormal = GizmoAxisSum(static_cast<EGizmoAxisMask>(~Bits & 7), GizmoTranslateAxes, Frame);
+	}
+
+	return this->NumAxes > 0;
+}
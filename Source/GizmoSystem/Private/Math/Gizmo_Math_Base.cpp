@@ -1,5 +1,24 @@
 #include "Math/Gizmo_Math_Base.h"
 #include "Math/Gizmo_Math_Move.h"
+#include "Math/Gizmo_Math_Rotate.h"
+#include "Math/Gizmo_Math_Scale.h"
+
+#include "Gizmo_Stats.h"
+#include "History/Gizmo_Journal.h"
+#include "History/Gizmo_Journal_Subsystem.h"
+#include "Input/Gizmo_Input_Recorder.h"
+#include "Input/Gizmo_Input_Processor.h"
+#include "Net/Gizmo_Net_Component.h"
+#include "Render/Gizmo_Late_Latch.h"
+#include "Snap/Gizmo_Snap_Subsystem.h"
+
+#include "Engine/World.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SplineComponent.h"
+
+#include "Framework/Application/SlateApplication.h"
+
+static constexpr double GizmoHoverTraceDistance = 1000000;
 
 // Sets default values
 AGizmoMathBase::AGizmoMathBase()
@@ -12,6 +31,8 @@ AGizmoMathBase::AGizmoMathBase()
 
 	GizmoType = CreateDefaultSubobject<UChildActorComponent>(TEXT("GizmoType"), false);
 	GizmoType->AttachToComponent(this->Root, FAttachmentTransformRules(EAttachmentRule::KeepRelative, false));
+
+	this->Telemetry.SetOwner(this);
 }
 
 // Called when the game starts or when spawned
@@ -19,13 +40,13 @@ void AGizmoMathBase::BeginPlay()
 {
 	Super::BeginPlay();
 	
-	UWorld* CurrentWorld = GEngine->GetCurrentPlayWorld();
+	UWorld* CurrentWorld = this->GetWorld();
 	ACharacter* Character = UGameplayStatics::GetPlayerCharacter(CurrentWorld, PlayerIndex);
 
 	this->PlayerController = UGameplayStatics::GetPlayerController(CurrentWorld, PlayerIndex);
-	this->CapsuleComponent = Character->GetCapsuleComponent();
+	this->CapsuleComponent = IsValid(Character) ? Character->GetCapsuleComponent() : nullptr;
 
-	if (!IsValid(this->PlayerCamera))
+	if (!IsValid(this->PlayerCamera) && IsValid(Character))
 	{
 		TArray<UCameraComponent*> Components;
 		Character->GetComponents(Components);
@@ -40,37 +61,90 @@ void AGizmoMathBase::BeginPlay()
 		}
 	}
 
-	if (IsValid(this->PlayerCamera))
+	if (IsValid(this->PlayerCamera) && IsValid(this->PlayerController))
 	{
 		EnableInput(this->PlayerController);
 		this->PlayerController->bEnableClickEvents = true;
+
+		InputComponent->BindAction("AnyKey", IE_Pressed, this, &AGizmoMathBase::AnyKey_Pressed);
+		InputComponent->BindAction("AnyKey", IE_Released, this, &AGizmoMathBase::AnyKey_Released);
 	}
 
 	else
 	{
 		UE_LOG(LogTemp, Warning, TEXT("You need to define camera and enable input manually."))
 	}
+
+	UGizmoJournalSubsystem* JournalSubsystem = UGizmoJournalSubsystem::Get();
+
+	if (this->bEnableJournal && JournalSubsystem)
+	{
+		this->Journal = JournalSubsystem->AcquireJournal(this->JournalPath);
+	}
+
+	if (this->bRecordInput)
+	{
+		this->InputRecorder = MakeShared<FGizmoInputRecorder>(this->InputRecordingPath.IsEmpty() ? FGizmoInputRecorder::GetDefaultPath() : this->InputRecordingPath);
+	}
+
+	if (FSlateApplication::IsInitialized())
+	{
+		this->InputProcessor = MakeShared<FGizmoInputProcessor>();
+		FSlateApplication::Get().RegisterInputPreProcessor(this->InputProcessor);
+	}
 }
 
 void AGizmoMathBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	if (this->InputProcessor.IsValid() && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().UnregisterInputPreProcessor(this->InputProcessor);
+	}
+
+	// Restores collision and navigation of dragged instance components and rebuilds edited splines.
+	this->InstanceDrag.End();
+	this->SplineDrag.End();
+
+	UGizmoJournalSubsystem* JournalSubsystem = UGizmoJournalSubsystem::Get();
+
+	// A destroyed gizmo or a level change leaves the session running, its edits may still need to be recovered.
+	if (this->Journal.IsValid() && JournalSubsystem)
+	{
+		JournalSubsystem->ReleaseJournal(this->Journal, EndPlayReason == EEndPlayReason::Quit || EndPlayReason == EEndPlayReason::EndPlayInEditor);
+	}
+
+	this->InputProcessor.Reset();
+	this->LateLatchExtension.Reset();
+	this->Journal.Reset();
+	this->InputRecorder.Reset();
+
 	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
 void AGizmoMathBase::Tick(float DeltaTime)
 {
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_BaseTick);
+
 	Super::Tick(DeltaTime);
 
+	this->CaptureInputFrame();
+
+	if (this->InputRecorder.IsValid())
+	{
+		this->InputRecorder->RecordFrame(this, DeltaTime);
+	}
+
 	// Gizmo Size in World.
 	if (IsValid(this->CapsuleComponent) && IsValid(GizmoType->GetChildActor()))
 	{
+		GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_SizeScaling);
+
 		double ScaleAxis = ((FVector::Distance(this->CapsuleComponent->GetComponentLocation(), this->GetRootComponent()->GetComponentLocation())) / this->GizmoSizeMultiplier);
 		GizmoType->GetChildActor()->GetRootComponent()->SetWorldScale3D(FVector3d(ScaleAxis, ScaleAxis, ScaleAxis));
 	}
 
-	InputComponent->BindAction("AnyKey", IE_Pressed, this, &AGizmoMathBase::AnyKey_Pressed);
-	InputComponent->BindAction("AnyKey", IE_Released, this, &AGizmoMathBase::AnyKey_Pressed);
+	this->HoverCallback();
 }
 
 void AGizmoMathBase::AnyKey_Pressed(FKey Key)
@@ -104,11 +178,7 @@ bool AGizmoMathBase::ForbiddenKeysCallback()
 
 bool AGizmoMathBase::DetectMovementCallback()
 {
-	double Delta_X;
-	double Delta_Y;
-	this->PlayerController->GetInputMouseDelta(Delta_X, Delta_Y);
-
-	if (Delta_X || Delta_Y != 0)
+	if (!this->InputFrame.Samples.IsEmpty() || !this->InputFrame.MouseDelta.IsZero())
 	{
 		return true;
 	}
@@ -119,9 +189,96 @@ bool AGizmoMathBase::DetectMovementCallback()
 	}
 }
 
+void AGizmoMathBase::CaptureInputFrame()
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_CaptureInput);
+
+	const FVector2D PreviousMousePosition = this->InputFrame.MousePosition;
+
+	if (this->InjectedInputFrame.IsSet())
+	{
+		this->InputFrame = this->InjectedInputFrame.GetValue();
+		this->InputFrame.PreviousMousePosition = PreviousMousePosition;
+		this->InjectedInputFrame.Reset();
+
+		// Replays and benchmarks carry no arrival time, so their frames record no latency. Timing them from here would only measure the tick.
+		return;
+	}
+
+	this->InputFrame.PreviousMousePosition = PreviousMousePosition;
+	this->InputFrame.MouseDelta = FVector2D::ZeroVector;
+	this->InputFrame.MouseWheel = 0;
+	this->InputFrame.Samples.Reset();
+	this->InputFrame.InputTime = 0;
+	this->InputFrame.NumCoalesced = 0;
+
+	if (!IsValid(this->PlayerController))
+	{
+		this->InputFrame.View.bIsValid = false;
+		return;
+	}
+
+	this->InputFrame.View.Capture(this->PlayerController);
+	this->PlayerController->GetInputMouseDelta(this->InputFrame.MouseDelta.X, this->InputFrame.MouseDelta.Y);
+	this->InputFrame.MouseWheel = this->PlayerController->GetInputAnalogKeyState(EKeys::MouseWheelAxis);
+
+	FVector2D MousePosition;
+	const bool bHasMousePosition = this->PlayerController->GetMousePosition(MousePosition.X, MousePosition.Y);
+
+	if (bHasMousePosition)
+	{
+		this->InputFrame.MousePosition = MousePosition;
+	}
+
+	if (this->InputProcessor.IsValid())
+	{
+		TArray<FVector2D> ScreenSamples;
+		this->InputProcessor->ConsumeSamples(ScreenSamples, this->InputFrame.InputTime);
+
+		this->InputFrame.NumCoalesced = this->InputProcessor->GetNumCoalesced() - this->NumCoalescedSeen;
+		this->NumCoalescedSeen = this->InputProcessor->GetNumCoalesced();
+
+		// Slate reports desktop positions. The newest sample is where the viewport cursor is now, which maps all of them into viewport space.
+		if (bHasMousePosition && !ScreenSamples.IsEmpty())
+		{
+			this->InputFrame.ScreenToViewport = MousePosition - ScreenSamples.Last();
+
+			for (const FVector2D& EachSample : ScreenSamples)
+			{
+				this->InputFrame.Samples.Add(EachSample + this->InputFrame.ScreenToViewport);
+			}
+		}
+	}
+
+	// No processor (or no Slate events this frame) still yields one sample per frame when the cursor moved.
+	if (this->InputFrame.Samples.IsEmpty() && bHasMousePosition && !MousePosition.Equals(this->InputFrame.PreviousMousePosition))
+	{
+		this->InputFrame.Samples.Add(MousePosition);
+	}
+
+	// Without Slate timestamps the move is only known from the player controller, which read it this frame.
+	if (this->InputFrame.InputTime == 0 && !this->InputFrame.Samples.IsEmpty())
+	{
+		this->InputFrame.InputTime = FPlatformTime::Seconds();
+	}
+}
+
 bool AGizmoMathBase::IsGizmoInViewCallback()
 {
-	if (!IsValid(PlayerCamera) || !IsValid(GizmoTarget) || !((UKismetMathLibrary::Dot_VectorVector(PlayerCamera->GetForwardVector(), UKismetMathLibrary::Normal(GizmoTarget->GetComponentLocation() - PlayerCamera->GetComponentLocation(), 0.0001f))) > 0.5))
+	if (!this->HasAnchor())
+	{
+		return false;
+	}
+
+	const FVector AnchorLocation = this->GetAnchorTransform().GetLocation();
+
+	// Captured view works without a camera component, e.g. with injected input.
+	if (this->InputFrame.View.bIsValid)
+	{
+		return UKismetMathLibrary::Dot_VectorVector(this->InputFrame.View.ViewDirection, UKismetMathLibrary::Normal(AnchorLocation - this->InputFrame.View.ViewOrigin, 0.0001f)) > 0.5;
+	}
+
+	if (!IsValid(PlayerCamera) || !((UKismetMathLibrary::Dot_VectorVector(PlayerCamera->GetForwardVector(), UKismetMathLibrary::Normal(AnchorLocation - PlayerCamera->GetComponentLocation(), 0.0001f))) > 0.5))
 	{
 		return false;
 	}
@@ -130,4 +287,629 @@ bool AGizmoMathBase::IsGizmoInViewCallback()
 	{
 		return true;
 	}
-}
\ No newline at end of file
+}
+
+void AGizmoMathBase::GetAllTargets(TArray<USceneComponent*>& Out_Targets) const
+{
+	Out_Targets.Reset(this->GizmoTargets.Num() + 1);
+
+	if (IsValid(this->GizmoTarget))
+	{
+		Out_Targets.Add(this->GizmoTarget);
+	}
+
+	for (USceneComponent* EachTarget : this->GizmoTargets)
+	{
+		if (IsValid(EachTarget))
+		{
+			Out_Targets.AddUnique(EachTarget);
+		}
+	}
+}
+
+void AGizmoMathBase::SetGizmoTargets(const TArray<USceneComponent*>& Targets, bool bAppend)
+{
+	if (this->bIsDragging)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Base : Targets can not change while dragging."));
+		return;
+	}
+
+	if (!bAppend)
+	{
+		this->GizmoTarget = nullptr;
+		this->GizmoTargets.Reset();
+	}
+
+	for (USceneComponent* EachTarget : Targets)
+	{
+		if (!IsValid(EachTarget) || EachTarget == this->GizmoTarget)
+		{
+			continue;
+		}
+
+		if (!IsValid(this->GizmoTarget))
+		{
+			this->GizmoTarget = EachTarget;
+			continue;
+		}
+
+		this->GizmoTargets.AddUnique(EachTarget);
+	}
+}
+
+bool AGizmoMathBase::IsMarqueeSelectable(const UPrimitiveComponent* Component) const
+{
+	const AActor* Owner = Component->GetOwner();
+
+	if (!Owner || Owner == this || Owner->GetParentActor() == this)
+	{
+		return false;
+	}
+
+	const USceneComponent* OwnerRoot = Owner->GetRootComponent();
+	return IsValid(OwnerRoot) && OwnerRoot->Mobility == EComponentMobility::Movable;
+}
+
+void AGizmoMathBase::GetMarqueeTargets(TConstArrayView<UPrimitiveComponent*> Components, TArray<USceneComponent*>& Out_Targets) const
+{
+	Out_Targets.Reset();
+
+	TSet<const AActor*> Owners;
+	Owners.Reserve(Components.Num());
+
+	for (const UPrimitiveComponent* EachComponent : Components)
+	{
+		const AActor* Owner = EachComponent->GetOwner();
+		bool bIsAlreadyInSet = false;
+		Owners.Add(Owner, &bIsAlreadyInSet);
+
+		if (!bIsAlreadyInSet)
+		{
+			Out_Targets.Add(Owner->GetRootComponent());
+		}
+	}
+}
+
+void AGizmoMathBase::BeginMarquee()
+{
+	this->Marquee.Gather(this->GetWorld(), this->InputFrame.View.ViewOrigin, [this](const UPrimitiveComponent* Component)
+	{
+		return this->IsMarqueeSelectable(Component);
+	});
+}
+
+int32 AGizmoMathBase::UpdateMarquee(FVector2D Start, FVector2D End, bool bRefine, TArray<USceneComponent*>& Out_Targets)
+{
+	Out_Targets.Reset();
+
+	if (!this->InputFrame.View.bIsValid)
+	{
+		return 0;
+	}
+
+	if (this->Marquee.IsEmpty())
+	{
+		this->BeginMarquee();
+	}
+
+	TArray<UPrimitiveComponent*> Components;
+	this->Marquee.Select(this->InputFrame.View, Start, End, bRefine, Components);
+	this->GetMarqueeTargets(Components, Out_Targets);
+
+	return Out_Targets.Num();
+}
+
+int32 AGizmoMathBase::EndMarquee(FVector2D Start, FVector2D End, bool bRefine, bool bAppend)
+{
+	TArray<USceneComponent*> Targets;
+	const int32 NumSelected = this->UpdateMarquee(Start, End, bRefine, Targets);
+	this->Marquee.Reset();
+
+	if (NumSelected > 0 || !bAppend)
+	{
+		this->SetGizmoTargets(Targets, bAppend);
+	}
+
+	return NumSelected;
+}
+
+void AGizmoMathBase::BeginDrag()
+{
+	TArray<USceneComponent*> Targets;
+	this->GetAllTargets(Targets);
+
+	this->DragTargets.Reset(Targets.Num());
+	this->DragStartTransforms.Reset(Targets.Num());
+	this->Telemetry.RecordDrag();
+
+	for (USceneComponent* EachTarget : Targets)
+	{
+		this->DragTargets.Add(EachTarget);
+		this->DragStartTransforms.Add(EachTarget->GetComponentTransform());
+	}
+
+	if (this->Journal.IsValid())
+	{
+		this->Journal->CachePaths(Targets);
+	}
+
+	this->InstanceDrag.Begin(this->InstanceTargets);
+	this->SplineDrag.Begin(this->SplineTargets);
+
+	this->DragSnapSources.Reset();
+
+	if (UGizmoSnapSubsystem* Snap = UWorld::GetSubsystem<UGizmoSnapSubsystem>(this->GetWorld()))
+	{
+		TArray<USceneComponent*> Children;
+
+		for (const USceneComponent* EachTarget : Targets)
+		{
+			this->DragSnapSources.Add(EachTarget->GetUniqueID());
+
+			EachTarget->GetChildrenComponents(true, Children);
+
+			for (const USceneComponent* EachChild : Children)
+			{
+				this->DragSnapSources.Add(EachChild->GetUniqueID());
+			}
+		}
+
+		Snap->SuspendSources(this->DragSnapSources);
+	}
+
+	this->NetComponent = this->bReplicateEdits ? UGizmoNetComponent::FindForController(this->PlayerController) : nullptr;
+	this->bNetDragStarted = false;
+	this->bIsDragging = true;
+}
+
+void AGizmoMathBase::EndDrag()
+{
+	if (this->bIsDragging)
+	{
+		// Resizing drops the history, so it only happens when the capacity was changed since the last drag.
+		if (this->HistoryCapacityKB != this->AppliedHistoryCapacityKB)
+		{
+			this->History.SetCapacity((int64)this->HistoryCapacityKB * 1024);
+			this->AppliedHistoryCapacityKB = this->HistoryCapacityKB;
+		}
+
+		this->History.Commit(this->DragTargets, this->DragStartTransforms);
+
+		TArray<USceneComponent*> Targets;
+		Targets.Reserve(this->DragTargets.Num());
+
+		for (const TWeakObjectPtr<USceneComponent>& EachTarget : this->DragTargets)
+		{
+			Targets.Add(EachTarget.Get());
+		}
+
+		this->JournalTargets(Targets);
+	}
+
+	if (this->NetComponent.IsValid() && this->bNetDragStarted)
+	{
+		this->NetComponent->EndDrag();
+	}
+
+	this->NetComponent = nullptr;
+	this->bNetDragStarted = false;
+
+	this->InstanceDrag.End();
+
+	TArray<USplineComponent*> EditedSplines;
+	this->SplineDrag.End(&EditedSplines);
+
+	for (USplineComponent* EachSpline : EditedSplines)
+	{
+		this->OnSplineCommitted.Broadcast(EachSpline);
+	}
+
+	if (UGizmoSnapSubsystem* Snap = UWorld::GetSubsystem<UGizmoSnapSubsystem>(this->GetWorld()))
+	{
+		Snap->ResumeSources();
+	}
+
+	this->DragSnapSources.Reset();
+	this->DragTargets.Reset();
+	this->DragStartTransforms.Reset();
+	this->bIsDragging = false;
+}
+
+const TSet<uint32>& AGizmoMathBase::GetDragSnapSources() const
+{
+	return this->DragSnapSources;
+}
+
+void AGizmoMathBase::ApplyToTargets(TFunctionRef<FTransform(const FTransform&)> Solver)
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_ApplyToTargets);
+
+	uint64 NumWrites = 0;
+
+	for (int32 TargetIndex = 0; TargetIndex < this->DragTargets.Num(); TargetIndex++)
+	{
+		USceneComponent* EachTarget = this->DragTargets[TargetIndex].Get();
+
+		if (!IsValid(EachTarget))
+		{
+			continue;
+		}
+
+		const FTransform NewTransform = Solver(this->DragStartTransforms[TargetIndex]);
+
+		// Skip the write (and its child and overlap updates) when nothing changed since the last frame.
+		if (NewTransform.Equals(EachTarget->GetComponentTransform()))
+		{
+			continue;
+		}
+
+		EachTarget->SetWorldTransform(NewTransform, false, nullptr, ETeleportType::None);
+		INC_DWORD_STAT(STAT_Gizmo_TransformWrites);
+		NumWrites++;
+	}
+
+	// Instances and spline points count like components, each changed one is a write.
+	NumWrites += this->InstanceDrag.Apply(Solver);
+	NumWrites += this->SplineDrag.Apply(Solver);
+
+	// Gizmos apply once per frame, so this is one sample per drag frame.
+	this->Telemetry.Record(EGizmoTelemetryMetric::Transform_Writes, NumWrites);
+	this->Telemetry.Record(EGizmoTelemetryMetric::Coalesced_Samples, (uint64)FMath::Max(this->InputFrame.NumCoalesced, 0));
+
+	// Zero for injected frames without an arrival time.
+	if (this->InputFrame.InputTime > 0)
+	{
+		this->Telemetry.Record(EGizmoTelemetryMetric::Drag_Latency, (uint64)((FPlatformTime::Seconds() - this->InputFrame.InputTime) * 1000000));
+	}
+}
+
+bool AGizmoMathBase::Undo()
+{
+	TArray<USceneComponent*> Targets;
+
+	if (this->bIsDragging || !this->History.Undo(&Targets))
+	{
+		return false;
+	}
+
+	this->JournalTargets(Targets);
+	return true;
+}
+
+bool AGizmoMathBase::Redo()
+{
+	TArray<USceneComponent*> Targets;
+
+	if (this->bIsDragging || !this->History.Redo(&Targets))
+	{
+		return false;
+	}
+
+	this->JournalTargets(Targets);
+	return true;
+}
+
+void AGizmoMathBase::JournalTargets(TConstArrayView<USceneComponent*> Targets)
+{
+	if (!this->Journal.IsValid())
+	{
+		return;
+	}
+
+	for (const USceneComponent* EachTarget : Targets)
+	{
+		this->Journal->Append(EachTarget);
+	}
+}
+
+bool AGizmoMathBase::CanUndo() const
+{
+	return !this->bIsDragging && this->History.CanUndo();
+}
+
+bool AGizmoMathBase::CanRedo() const
+{
+	return !this->bIsDragging && this->History.CanRedo();
+}
+
+bool AGizmoMathBase::IsJournalOpen() const
+{
+	return this->Journal.IsValid() && this->Journal->IsOpen();
+}
+
+void AGizmoMathBase::ApplyDragDelta(const FGizmoDragDelta& Delta)
+{
+	if (UGizmoNetComponent* Net = this->NetComponent.Get())
+	{
+		// First delta carries the pivot and scale settings, and targets are still at their start transforms.
+		if (!this->bNetDragStarted)
+		{
+			TArray<USceneComponent*> Targets;
+			Targets.Reserve(this->DragTargets.Num());
+
+			for (const TWeakObjectPtr<USceneComponent>& EachTarget : this->DragTargets)
+			{
+				Targets.Add(EachTarget.Get());
+			}
+
+			Net->BeginDrag(Targets, Delta);
+			this->bNetDragStarted = true;
+		}
+
+		Net->UpdateDrag(Delta);
+	}
+
+	this->ApplyToTargets([&Delta](const FTransform& StartTransform)
+	{
+		return Delta.Apply(StartTransform);
+	});
+}
+
+FVector AGizmoMathBase::GetSelectionCenter() const
+{
+	const int32 NumSelected = this->DragStartTransforms.Num() + this->InstanceDrag.GetNumInstances() + this->SplineDrag.GetNumHandles();
+
+	if (NumSelected == 0)
+	{
+		return this->HasAnchor() ? this->GetAnchorTransform().GetLocation() : this->GetActorLocation();
+	}
+
+	FVector Sum = this->InstanceDrag.GetStartLocationSum() + this->SplineDrag.GetStartLocationSum();
+
+	for (const FTransform& EachTransform : this->DragStartTransforms)
+	{
+		Sum += EachTransform.GetLocation();
+	}
+
+	return Sum / NumSelected;
+}
+
+bool AGizmoMathBase::HasAnchor() const
+{
+	if (IsValid(this->GizmoTarget))
+	{
+		return true;
+	}
+
+	for (const FGizmoInstanceTarget& EachTarget : this->InstanceTargets)
+	{
+		if (IsValid(EachTarget.Component) && EachTarget.InstanceIndices.Num() > 0 && EachTarget.Component->IsValidInstance(EachTarget.InstanceIndices[0]))
+		{
+			return true;
+		}
+	}
+
+	for (const FGizmoSplineTarget& EachTarget : this->SplineTargets)
+	{
+		if (IsValid(EachTarget.Component) && EachTarget.PointIndices.Num() > 0 && EachTarget.PointIndices[0] >= 0 && EachTarget.PointIndices[0] < EachTarget.Component->GetNumberOfSplinePoints())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+FTransform AGizmoMathBase::GetAnchorTransform() const
+{
+	if (IsValid(this->GizmoTarget))
+	{
+		return this->GizmoTarget->GetComponentTransform();
+	}
+
+	for (const FGizmoInstanceTarget& EachTarget : this->InstanceTargets)
+	{
+		FTransform InstanceTransform;
+
+		if (IsValid(EachTarget.Component) && EachTarget.InstanceIndices.Num() > 0 && EachTarget.Component->GetInstanceTransform(EachTarget.InstanceIndices[0], InstanceTransform, true))
+		{
+			return InstanceTransform;
+		}
+	}
+
+	for (const FGizmoSplineTarget& EachTarget : this->SplineTargets)
+	{
+		FTransform HandleTransform;
+
+		if (EachTarget.PointIndices.Num() > 0 && FGizmoSplineDrag::GetHandleTransform(EachTarget.Component, EachTarget.PointIndices[0], EachTarget.Handle, HandleTransform))
+		{
+			return HandleTransform;
+		}
+	}
+
+	return this->GetActorTransform();
+}
+
+void AGizmoMathBase::SyncToAnchor()
+{
+	if (!this->HasAnchor() || !IsValid(this->GetRootComponent()))
+	{
+		return;
+	}
+
+	this->GetRootComponent()->SetWorldLocation(this->GetAnchorTransform().GetLocation(), false, nullptr, ETeleportType::None);
+}
+
+void AGizmoMathBase::SetLateLatchParams(const FGizmoLateLatchParams& Params)
+{
+	if (!this->bEnableLateLatch)
+	{
+		if (this->LateLatchExtension.IsValid())
+		{
+			this->LateLatchExtension->SetParams(this->GetRootComponent(), FGizmoLateLatchParams());
+		}
+
+		return;
+	}
+
+	if (!this->LateLatchExtension.IsValid())
+	{
+		this->LateLatchExtension = FSceneViewExtensions::NewExtension<FGizmoLateLatchExtension>(this->InputProcessor);
+	}
+
+	FGizmoLateLatchParams FrameParams = Params;
+	FrameParams.CommittedTransform = this->GetRootComponent()->GetComponentTransform();
+	FrameParams.ScreenToViewport = this->InputFrame.ScreenToViewport;
+	FrameParams.MousePosition = this->InputFrame.MousePosition;
+
+	this->LateLatchExtension->SetParams(this->GetRootComponent(), FrameParams);
+}
+
+void AGizmoMathBase::HoverCallback()
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_Hover);
+
+	AActor* ChildGizmo = GizmoType->GetChildActor();
+
+	if (!this->bEnableHover || !IsValid(ChildGizmo) || !this->InputFrame.View.bIsValid)
+	{
+		return;
+	}
+
+	// Handles only change when the child gizmo is swapped.
+	if (this->HoverHandlesOwner.Get() != ChildGizmo)
+	{
+		TArray<UStaticMeshComponent*> Handles;
+		ChildGizmo->GetComponents(Handles);
+
+		this->HoverHandles.Reset(Handles.Num());
+
+		for (UStaticMeshComponent* EachHandle : Handles)
+		{
+			this->HoverHandles.Add(EachHandle);
+		}
+
+		this->HoverHandlesOwner = ChildGizmo;
+		this->bHoverPicked = false;
+		this->HoveredHandle = nullptr;
+	}
+
+	// Grabbed handle stays highlighted for the whole drag.
+	if (this->bIsDragging)
+	{
+		return;
+	}
+
+	const FTransform GizmoTransform = ChildGizmo->GetRootComponent()->GetComponentTransform();
+
+	if (this->bHoverPicked && this->HoverMousePosition.Equals(this->InputFrame.MousePosition) && this->HoverViewProjection.Equals(this->InputFrame.View.ViewProjectionMatrix, 0) && this->HoverGizmoTransform.Equals(GizmoTransform))
+	{
+		return;
+	}
+
+	this->HoverMousePosition = this->InputFrame.MousePosition;
+	this->HoverViewProjection = this->InputFrame.View.ViewProjectionMatrix;
+	this->HoverGizmoTransform = GizmoTransform;
+	this->bHoverPicked = true;
+
+	UPrimitiveComponent* NewHovered = this->PickHandle(this->InputFrame.MousePosition);
+
+	if (NewHovered == this->HoveredHandle)
+	{
+		return;
+	}
+
+	this->SetHandleHighlight(this->HoveredHandle, 0);
+	this->SetHandleHighlight(NewHovered, 1);
+	this->HoveredHandle = NewHovered;
+}
+
+UPrimitiveComponent* AGizmoMathBase::PickHandle(const FVector2D& ScreenPosition) const
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_PickHandle);
+	INC_DWORD_STAT(STAT_Gizmo_Picks);
+
+	FVector RayOrigin;
+	FVector RayDirection;
+
+	if (!this->InputFrame.View.DeprojectScreenToWorld(ScreenPosition, RayOrigin, RayDirection))
+	{
+		return nullptr;
+	}
+
+	// Traces only the handle bodies, not the scene.
+	const FVector RayEnd = RayOrigin + RayDirection * GizmoHoverTraceDistance;
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GizmoHover), false);
+
+	UPrimitiveComponent* Nearest = nullptr;
+	double NearestDistance = TNumericLimits<double>::Max();
+
+	for (const TWeakObjectPtr<UPrimitiveComponent>& EachHandle : this->HoverHandles)
+	{
+		UPrimitiveComponent* Handle = EachHandle.Get();
+		FHitResult Hit;
+
+		if (IsValid(Handle) && Handle->IsVisible() && Handle->LineTraceComponent(Hit, RayOrigin, RayEnd, QueryParams) && Hit.Distance < NearestDistance)
+		{
+			Nearest = Handle;
+			NearestDistance = Hit.Distance;
+		}
+	}
+
+	return Nearest;
+}
+
+void AGizmoMathBase::SetHandleHighlight(UPrimitiveComponent* Handle, float Highlight)
+{
+	if (!IsValid(Handle))
+	{
+		return;
+	}
+
+	// Custom primitive data only updates the primitive uniform buffer. No material instance and no render state rebuild.
+	Handle->SetCustomPrimitiveDataFloat(this->HoverDataIndex, Highlight);
+}
+
+void AGizmoMathBase::InjectInput(const FGizmoInputFrame& Frame, const TArray<FKey>& Keys)
+{
+	this->InjectedInputFrame = Frame;
+	this->PressedKeys = TSet<FKey>(Keys);
+}
+
+const TSet<FKey>& AGizmoMathBase::GetPressedKeys() const
+{
+	return this->PressedKeys;
+}
+
+ESelectedAxis AGizmoMathBase::GetSelectedAxis() const
+{
+	const AActor* ChildGizmo = this->GizmoType->GetChildActor();
+
+	if (const AGizmoMathMove* GizmoMove = Cast<AGizmoMathMove>(ChildGizmo))
+	{
+		return GizmoMove->AxisEnum;
+	}
+
+	else if (const AGizmoMathRotate* GizmoRotate = Cast<AGizmoMathRotate>(ChildGizmo))
+	{
+		return GizmoRotate->AxisEnum;
+	}
+
+	else if (const AGizmoMathScale* GizmoScale = Cast<AGizmoMathScale>(ChildGizmo))
+	{
+		return GizmoScale->AxisEnum;
+	}
+
+	return ESelectedAxis::Null_Axis;
+}
+
+void AGizmoMathBase::SetSelectedAxis(ESelectedAxis Axis)
+{
+	AActor* ChildGizmo = this->GizmoType->GetChildActor();
+
+	if (AGizmoMathMove* GizmoMove = Cast<AGizmoMathMove>(ChildGizmo))
+	{
+		GizmoMove->AxisEnum = Axis;
+	}
+
+	else if (AGizmoMathRotate* GizmoRotate = Cast<AGizmoMathRotate>(ChildGizmo))
+	{
+		GizmoRotate->AxisEnum = Axis;
+	}
+
+	else if (AGizmoMathScale* GizmoScale = Cast<AGizmoMathScale>(ChildGizmo))
+	{
+		GizmoScale->AxisEnum = Axis;
+	}
+}
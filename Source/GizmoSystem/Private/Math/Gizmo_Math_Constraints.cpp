@@ -0,0 +1,89 @@
+#include "Math/Gizmo_Math_Constraints.h"
+
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+
+void FGizmoConstraintContext::Init(const FGizmoAxisProjection& AxisProjection, const FQuat& InFrame)
+{
+	this->Projection = AxisProjection.Projection;
+	this->Axis = AxisProjection.Axis;
+	this->Frame = InFrame;
+}
+
+FVector FGizmoSweepStage::Apply(const FGizmoConstraintContext& Context, const FVector& Offset)
+{
+	UPrimitiveComponent* Component = Context.SweepComponent.Get();
+
+	if (!Context.World || !Component || Offset.IsNearlyZero())
+	{
+		return Offset;
+	}
+
+	// Real shapes at their real rotation. GetCollisionShape is only a world aligned bounds box for most components.
+	TArray<FHitResult> Hits;
+	Context.World->ComponentSweepMulti(Hits, Component, Context.SweepStart, Context.SweepStart + Offset, Context.SweepRotation, Context.SweepParams);
+
+	double Time = 1;
+
+	for (const FHitResult& EachHit : Hits)
+	{
+		const UPrimitiveComponent* HitComponent = EachHit.GetComponent();
+
+		// Grabbed while already overlapping. Blocking here would freeze the drag.
+		if (EachHit.bStartPenetrating || !HitComponent || HitComponent->GetCollisionResponseToChannel(Context.SweepChannel) != ECR_Block)
+		{
+			continue;
+		}
+
+		Time = FMath::Min(Time, (double)EachHit.Time);
+	}
+
+	return Offset * Time;
+}
+
+// Fallback for combinations without a specialization. Same order as the pipelines.
+static FVector GizmoApplyConstraintsDynamic(const FGizmoConstraintContext& Context, FVector Offset)
+{
+	if (EnumHasAnyFlags(Context.Stages, EGizmoConstraintStage::Axis_Mask))
+	{
+		Offset = FGizmoAxisMaskStage::Apply(Context, Offset);
+	}
+
+	if (EnumHasAnyFlags(Context.Stages, EGizmoConstraintStage::Grid_Snap))
+	{
+		Offset = FGizmoGridSnapStage::Apply(Context, Offset);
+	}
+
+	if (EnumHasAnyFlags(Context.Stages, EGizmoConstraintStage::Clamp))
+	{
+		Offset = FGizmoClampStage::Apply(Context, Offset);
+	}
+
+	if (EnumHasAnyFlags(Context.Stages, EGizmoConstraintStage::Sweep))
+	{
+		Offset = FGizmoSweepStage::Apply(Context, Offset);
+	}
+
+	return Offset;
+}
+
+FVector GizmoApplyConstraints(const FGizmoConstraintContext& Context, const FVector& Offset)
+{
+	switch (Context.Stages)
+	{
+		case FGizmoMaskPipeline::Stages:
+			return FGizmoMaskPipeline::Apply(Context, Offset);
+
+		case FGizmoMaskSnapPipeline::Stages:
+			return FGizmoMaskSnapPipeline::Apply(Context, Offset);
+
+		case FGizmoMaskClampPipeline::Stages:
+			return FGizmoMaskClampPipeline::Apply(Context, Offset);
+
+		case FGizmoMaskSnapClampPipeline::Stages:
+			return FGizmoMaskSnapClampPipeline::Apply(Context, Offset);
+
+		default:
+			return GizmoApplyConstraintsDynamic(Context, Offset);
+	}
+}
@@ -1,10 +1,18 @@
 #include "Math/Gizmo_Math_Move.h"
 
+#include "Gizmo_Stats.h"
+#include "Assets/Gizmo_Asset_Subsystem.h"
+#include "Render/Gizmo_Late_Latch.h"
+#include "Snap/Gizmo_Snap_Subsystem.h"
+
+static constexpr double GizmoSurfaceTraceDistance = 1000000;
+
 // Sets default values.
 AGizmoMathMove::AGizmoMathMove()
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
+	this->Diagnostics.SetOwner(this);
 	this->InitHandles();
 }
 
@@ -13,6 +21,8 @@ void AGizmoMathMove::BeginPlay()
 {	
 	Super::BeginPlay();
 
+	this->LoadAssets();
+
 	if (!IsValid(this->GetParentActor()))
 	{
 		return;
@@ -26,8 +36,11 @@ void AGizmoMathMove::BeginPlay()
 	}
 
 	this->GizmoBase = TempBase;
+
+	// Input frame is captured in the base tick.
+	this->AddTickPrerequisiteActor(this->GizmoBase);
 	
-	UWorld* CurrentWorld = GEngine->GetCurrentPlayWorld();
+	UWorld* CurrentWorld = this->GetWorld();
 	this->PlayerController = UGameplayStatics::GetPlayerController(CurrentWorld, this->GizmoBase->PlayerIndex);
 	
 	this->BindDelegates();
@@ -43,6 +56,11 @@ void AGizmoMathMove::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 	this->TransformSystem();
+
+	if (this->bEnableDebugMode)
+	{
+		this->Diagnostics.ShowOnScreen();
+	}
 }
 
 void AGizmoMathMove::InitHandles()
@@ -56,7 +74,6 @@ void AGizmoMathMove::InitHandles()
 	this->Axis_X->SetCollisionProfileName(FName("BlockAll"));
 	this->Axis_X->SetNotifyRigidBodyCollision(true);
 	this->Axis_X->SetCastShadow(false);
-	this->Axis_X->SetStaticMesh(LoadObject<UStaticMesh>(nullptr, TEXT("/GizmoSystem/Content/Meshes/SM_Gizmo_Move_Axis.SM_Gizmo_Move_Axis")));
 
 	this->Axis_Y = CreateDefaultSubobject<UStaticMeshComponent>("Axis_Y");
 	this->Axis_Y->AttachToComponent(this->Root, FAttachmentTransformRules::KeepRelativeTransform);
@@ -66,7 +83,6 @@ void AGizmoMathMove::InitHandles()
 	this->Axis_Y->SetCollisionProfileName(FName("BlockAll"));
 	this->Axis_Y->SetNotifyRigidBodyCollision(true);
 	this->Axis_Y->SetCastShadow(false);
-	this->Axis_Y->SetStaticMesh(LoadObject<UStaticMesh>(nullptr, TEXT("/GizmoSystem/Content/Meshes/SM_Gizmo_Move_Axis.SM_Gizmo_Move_Axis")));
 	
 	this->Axis_Z = CreateDefaultSubobject<UStaticMeshComponent>("Axis_Z");
 	this->Axis_Z->AttachToComponent(this->Root, FAttachmentTransformRules::KeepRelativeTransform);
@@ -76,259 +92,542 @@ void AGizmoMathMove::InitHandles()
 	this->Axis_Z->SetCollisionProfileName(FName("BlockAll"));
 	this->Axis_Z->SetNotifyRigidBodyCollision(true);
 	this->Axis_Z->SetCastShadow(false);
-	this->Axis_Z->SetStaticMesh(LoadObject<UStaticMesh>(nullptr, TEXT("/GizmoSystem/Content/Meshes/SM_Gizmo_Move_Axis.SM_Gizmo_Move_Axis")));
 }
 
-void AGizmoMathMove::TransformSystem()
+TArray<FSoftObjectPath> AGizmoMathMove::GetAssetPaths() const
 {
-	if (!this->Transform_Check())
+	return
+	{
+		this->AxisMesh.ToSoftObjectPath(),
+		this->Material_X.ToSoftObjectPath(),
+		this->Material_Y.ToSoftObjectPath(),
+		this->Material_Z.ToSoftObjectPath(),
+	};
+}
+
+void AGizmoMathMove::LoadAssets()
+{
+	UGizmoAssetSubsystem* Assets = UGizmoAssetSubsystem::Get();
+
+	if (!IsValid(Assets))
 	{
 		return;
 	}
 
-	MoveMultiplier = this->GetInputAxisKeyValue(EKeys::MouseWheelAxis) + MoveMultiplier;
+	Assets->RequestAssets(this->GetAssetPaths(), FStreamableDelegate::CreateUObject(this, &AGizmoMathMove::ApplyAssets));
+}
 
-	if (MoveMultiplier <= 0)
+void AGizmoMathMove::ApplyAssets()
+{
+	UGizmoAssetSubsystem::ApplyToHandle(this->Axis_X, this->AxisMesh, this->Material_X);
+	UGizmoAssetSubsystem::ApplyToHandle(this->Axis_Y, this->AxisMesh, this->Material_Y);
+	UGizmoAssetSubsystem::ApplyToHandle(this->Axis_Z, this->AxisMesh, this->Material_Z);
+}
+
+void AGizmoMathMove::TransformSystem()
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_MoveSystem);
+
+	if (!this->Transform_Check())
 	{
-		MoveMultiplier = 1;
+		return;
 	}
 
 	if (bMoveLocal)
 	{
-		this->Transform_Local();
+		this->GetRootComponent()->SetWorldRotation(this->GizmoBase->GetAnchorTransform().Rotator());
 	}
 
 	else
 	{
-		this->Transform_World();
+		this->GetRootComponent()->SetWorldRotation(FQuat(0.f), false, nullptr, ETeleportType::None);
 	}
 
-	this->Transform_Track();
-}
+	// Axis can also be selected from Blueprint without a click, so grab lazily where the cursor was at the end of the last frame.
+	if ((!this->GizmoBase->bIsDragging || this->GrabAxisEnum != this->AxisEnum) && !this->BeginGrab(this->GizmoBase->InputFrame.PreviousMousePosition))
+	{
+		return;
+	}
 
-bool AGizmoMathMove::Transform_Check()
-{
-	if (!IsValid(GizmoBase))
+	FGizmoTelemetryTimer SolverTimer(this->GizmoBase->Telemetry, EGizmoTelemetryMetric::Solver_Time);
+
+	if (this->bSurfaceDrag)
 	{
-		if (bEnableDebugMode)
+		FGizmoDragDelta Delta;
+
+		if (this->Surface_Solve(this->GizmoBase->InputFrame.MousePosition, Delta))
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Gizmo Move : Gizmo base is not valid !");
+			this->GizmoBase->ApplyDragDelta(Delta);
 		}
 
-		return false;
+		this->Transform_Track();
+
+		// Render thread can not re-solve a surface drop.
+		if (this->GizmoBase->bEnableLateLatch)
+		{
+			this->GizmoBase->SetLateLatchParams(FGizmoLateLatchParams());
+		}
+
+		return;
 	}
 
-	if (!IsValid(this->GizmoBase->GizmoTarget))
+	// Every cursor sample received since the last frame goes through the solver in order. Only the final offset is written.
+	// A single local axis tracks the cursor through its screen axis, everything else through the ray-plane constraint.
+	const bool bUseScreenAxis = this->bMoveLocal && this->GrabScreenAxis.bIsValid;
+	bool bSolved = false;
+	FVector Offset = FVector::ZeroVector;
+
+	for (const FVector2D& EachSample : this->GizmoBase->InputFrame.Samples)
 	{
-		if (bEnableDebugMode)
+		FVector SampleOffset;
+
+		if (bUseScreenAxis ? this->Transform_Local(EachSample, SampleOffset) : this->Transform_World(EachSample, SampleOffset))
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Gizmo Move : Gizmo target is not valid !");
+			Offset = SampleOffset;
+			bSolved = true;
 		}
+	}
 
-		return false;
+	bool bSnapped = false;
+
+	if (bSolved && this->bSnapToPoints)
+	{
+		bSnapped = this->Snap_Offset(Offset);
 	}
 
-	if (!this->GizmoBase->DetectMovementCallback())
+	if (bSolved)
 	{
-		if (bEnableDebugMode)
+		// A snapped point is already on a target, the grid must not move it off again.
+		const EGizmoConstraintStage Stages = this->GrabConstraints.Stages;
+
+		if (bSnapped)
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Gizmo Move : There is no movement !");
+			this->GrabConstraints.Stages &= ~EGizmoConstraintStage::Grid_Snap;
 		}
 
+		Offset = GizmoApplyConstraints(this->GrabConstraints, Offset);
+		this->GrabConstraints.Stages = Stages;
+	}
+
+	if (bSolved)
+	{
+		FGizmoDragDelta Delta;
+		Delta.Translation = Offset;
+
+		this->GizmoBase->ApplyDragDelta(Delta);
+	}
+
+	this->Transform_Track();
+
+	// The render thread only re-solves the raw cursor. Snapped, clamped or swept frames must keep their result, and it has nothing to solve from before the grab.
+	if (this->GizmoBase->bEnableLateLatch && (bSnapped || this->GrabConstraints.Stages != EGizmoConstraintStage::Axis_Mask || (!bUseScreenAxis && !this->bHasGrabPoint)))
+	{
+		this->GizmoBase->SetLateLatchParams(FGizmoLateLatchParams());
+	}
+
+	else if (this->GizmoBase->bEnableLateLatch)
+	{
+		FGizmoLateLatchParams Params;
+		Params.bIsActive = true;
+		Params.GrabGizmoLocation = this->GrabGizmoLocation;
+		Params.GrabMousePosition = this->GrabMousePosition;
+		Params.bUseScreenAxis = bUseScreenAxis;
+		Params.ScreenAxis = this->GrabScreenAxis;
+		Params.Constraint = this->GrabConstraint;
+		Params.GrabPoint = this->GrabPoint;
+
+		this->GizmoBase->SetLateLatchParams(Params);
+	}
+}
+
+bool AGizmoMathMove::Transform_Check()
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_TransformCheck);
+
+	if (!IsValid(GizmoBase))
+	{
+		this->Diagnostics.Report(EGizmoDiagnostic::Base_Invalid);
+		return false;
+	}
+
+	if (!this->GizmoBase->HasAnchor())
+	{
+		this->Diagnostics.Report(EGizmoDiagnostic::Target_Invalid);
+		return false;
+	}
+
+	if (!this->GizmoBase->DetectMovementCallback())
+	{
+		this->Diagnostics.Report(EGizmoDiagnostic::No_Movement);
 		return false;
 	}
 
 	if (!this->GizmoBase->IsGizmoInViewCallback())
 	{
-		if (bEnableDebugMode)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Gizmo Move : Gizmo is not in the view !");
-		}
-		
+		this->Diagnostics.Report(EGizmoDiagnostic::Not_In_View);
 		return false;
 	}
 
 	if (this->GizmoBase->ForbiddenKeysCallback())
 	{
-		if (bEnableDebugMode)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Gizmo Move : Forbidden key pressed !");
-		}
+		this->Diagnostics.Report(EGizmoDiagnostic::Forbidden_Key);
+		return false;
+	}
 
+	return true;
+}
+
+bool AGizmoMathMove::Transform_World(const FVector2D& ScreenPosition, FVector& Out_Offset)
+{
+	FVector Point;
+
+	if (!this->GrabConstraint.Solve(this->GizmoBase->InputFrame.View, ScreenPosition, Point))
+	{
 		return false;
 	}
 
+	if (!this->bHasGrabPoint)
+	{
+		this->GrabPoint = Point;
+		this->bHasGrabPoint = true;
+	}
+
+	Out_Offset = Point - this->GrabPoint;
 	return true;
 }
 
-void AGizmoMathMove::Transform_World()
+bool AGizmoMathMove::Transform_Local(const FVector2D& ScreenPosition, FVector& Out_Offset)
 {
-	this->GetRootComponent()->SetWorldRotation(FQuat(0.f), false, nullptr, ETeleportType::None);
+	if (!this->GrabScreenAxis.bIsValid)
+	{
+		return false;
+	}
 
-	const double ObjectDistance = UKismetMathLibrary::Vector_Distance(this->GizmoBase->PlayerCamera->GetComponentLocation(), this->GizmoBase->GizmoTarget->GetComponentLocation());
+	// Measured from the grab point, so the handle stays under the cursor regardless of frame rate or mouse sensitivity.
+	Out_Offset = this->GrabScreenAxis.WorldAxis * this->GrabScreenAxis.ToWorldDistance(ScreenPosition - this->GrabMousePosition);
+	return true;
+}
 
-	FVector MouseWorldLocation;
-	FVector MouseWorldDirection;
-	this->PlayerController->DeprojectMousePositionToWorld(MouseWorldLocation, MouseWorldDirection);
+void AGizmoMathMove::Transform_Track()
+{
+	USceneComponent* ParentRoot = nullptr;
 
-	const FVector NewLocation = MouseWorldLocation + (MouseWorldDirection * ObjectDistance);
-	const FVector OriginalLocation = this->GizmoBase->GizmoTarget->GetComponentLocation();
+	if (IsValid(GizmoBase->GetRootComponent()))
+	{
+		ParentRoot = GizmoBase->GetRootComponent();
+		ParentRoot->SetWorldLocation(this->GizmoBase->GetAnchorTransform().GetLocation(), false, nullptr, ETeleportType::None);
+	}
+}
 
-	switch (AxisEnum)
+void AGizmoMathMove::OnClickedEvent(UPrimitiveComponent* TouchComponent, FKey PressedButton)
+{
+	if (!IsValid(TouchComponent))
 	{
-		case ESelectedAxis::Null_Axis:
-			break;
+		return;
+	}
 
-		case ESelectedAxis::X_Axis:
+	this->AxisComponent = TouchComponent;
 
-			this->GizmoBase->GizmoTarget->SetWorldLocation(FVector(NewLocation.X, this->GizmoBase->GizmoTarget->GetComponentLocation().Y, this->GizmoBase->GizmoTarget->GetComponentLocation().Z));
-			break;
+	const ESelectedAxis TouchedAxis = this->GetAxisEnum(TouchComponent);
 
-		case ESelectedAxis::Y_Axis:
+	if (TouchedAxis != ESelectedAxis::Null_Axis)
+	{
+		this->AxisEnum = TouchedAxis;
+	}
 
-			this->GizmoBase->GizmoTarget->SetWorldLocation(FVector(this->GizmoBase->GizmoTarget->GetComponentLocation().X, NewLocation.Y, this->GizmoBase->GizmoTarget->GetComponentLocation().Z));
-			break;
+	if (IsValid(this->GizmoBase) && this->GizmoBase->HasAnchor())
+	{
+		FVector2D MousePosition = this->GizmoBase->InputFrame.MousePosition;
 
-		case ESelectedAxis::Z_Axis:
+		if (IsValid(this->PlayerController))
+		{
+			this->PlayerController->GetMousePosition(MousePosition.X, MousePosition.Y);
+		}
 
-			this->GizmoBase->GizmoTarget->SetWorldLocation(FVector(this->GizmoBase->GizmoTarget->GetComponentLocation().X, this->GizmoBase->GizmoTarget->GetComponentLocation().Y, NewLocation.Z));
-			break;
+		this->BeginGrab(MousePosition);
+	}
 
-		case ESelectedAxis::XY_Axis:
-			break;
-		case ESelectedAxis::XZ_Axis:
-			break;
-		case ESelectedAxis::YZ_Axis:
-			break;
-		case ESelectedAxis::XYZ_Axis:
-			break;
-		default:
-			break;
+	if (this->bEnableDebugMode)
+	{
+		GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, TouchComponent->GetFullName());
 	}
 }
 
-void AGizmoMathMove::Transform_Local()
+void AGizmoMathMove::OnReleasedEvent(UPrimitiveComponent* TouchComponent, FKey ReleasedButton)
 {
-	if (IsValid(this->GizmoBase->PlayerCamera) == false)
+	if (IsValid(this->GizmoBase))
 	{
-		return;
+		this->GizmoBase->EndDrag();
+		this->GizmoBase->SetLateLatchParams(FGizmoLateLatchParams());
 	}
 
-	if (IsValid(AxisComponent) == false)
+	// Like Scale. A selected axis left behind would start a new drag on the next move with no button held.
+	this->AxisEnum = ESelectedAxis::Null_Axis;
+	this->GrabAxisEnum = ESelectedAxis::Null_Axis;
+}
+
+bool AGizmoMathMove::BeginGrab(const FVector2D& MousePosition)
+{
+	if (this->AxisEnum == ESelectedAxis::Null_Axis)
 	{
-		return;
+		return false;
+	}
+
+	const FGizmoViewState& View = this->GizmoBase->InputFrame.View;
+	const FVector Origin = this->GizmoBase->GetAnchorTransform().GetLocation();
+
+	// Axes of the mask in the gizmo frame, and the projection every solved offset goes through.
+	const FQuat Frame = this->bMoveLocal ? this->GizmoBase->GetAnchorTransform().GetRotation() : FQuat::Identity;
+	this->GrabAxisMask = this->GetAxisMask();
+
+	// Nothing to move along, so no drag is started.
+	if (!this->GrabProjection.Init(this->GrabAxisMask, Frame, View.ViewDirection))
+	{
+		this->GrabConstraint.bIsValid = false;
+		this->GrabScreenAxis.bIsValid = false;
+		return false;
 	}
 
-	this->GetRootComponent()->SetWorldRotation(this->GizmoBase->GizmoTarget->GetComponentRotation());
+	this->GizmoBase->BeginDrag();
+	this->GrabAxisEnum = this->AxisEnum;
+	this->GrabMousePosition = MousePosition;
+	this->GrabGizmoLocation = Origin;
 
-	// MAIN VARIABLES
-	double Delta_X = 0;
-	double Delta_Y = 0;
-	this->PlayerController->GetInputMouseDelta(Delta_X, Delta_Y);
+	// Single local axis: projected once per drag. Per frame work is a single dot product.
+	this->GrabScreenAxis.Init(View, Origin, this->GrabProjection.Axis);
 
-	// MAIN CALCULATIONS
-	const FVector AxisForward = AxisComponent->GetForwardVector();
-	const FVector NormalTarget = this->GizmoBase->PlayerCamera->GetComponentLocation() - this->GizmoBase->GizmoTarget->GetComponentLocation();
-	const FVector NormalizedVector = UKismetMathLibrary::Normal(FVector(NormalTarget.X, NormalTarget.Y, 0.0f), 0.0001);
-	const FVector CrossVector = UKismetMathLibrary::Cross_VectorVector(AxisForward, NormalizedVector);
-	const double DotProduct = UKismetMathLibrary::Dot_VectorVector(AxisForward, NormalizedVector);
+	// Everything else: ray-plane constraint and the point under the cursor at grab.
+	if (this->GrabProjection.NumAxes == 1)
+	{
+		this->GrabConstraint.InitForAxis(View, Origin, this->GrabProjection.Axis);
+	}
 
-	// X OFFSET
-	double HorizontalMultiplier = 0;
-	if (CrossVector.Z > 0 == true)
+	else if (this->GrabProjection.NumAxes == 2)
 	{
-		HorizontalMultiplier = Delta_X * MoveMultiplier;
+		this->GrabConstraint.InitForPlane(Origin, this->GrabProjection.PlaneNormal);
 	}
 
-	else
+	else if (this->GrabProjection.NumAxes == 3)
 	{
-		HorizontalMultiplier = Delta_X * MoveMultiplier * (-1);
+		this->GrabConstraint.InitForPlane(Origin, -View.ViewDirection);
 	}
 
-	// Y OFFSET
-	double VerticalMultiplier = 0;
-	if (UKismetMathLibrary::Abs(AxisForward.Z) >= 0.75 == true)
+	// Can miss when the cursor ray is parallel to the plane. Transform_World grabs again with the next sample that solves.
+	this->bHasGrabPoint = this->GrabConstraint.Solve(View, MousePosition, this->GrabPoint);
+
+	this->GrabConstraints = FGizmoConstraintContext();
+	this->GrabConstraints.Start = Origin;
+	this->GrabConstraints.Init(this->GrabProjection, Frame);
+
+	// The view plane handle is not masked, so snapped points keep their depth.
+	if (EnumHasAnyFlags(this->GrabAxisMask, EGizmoAxisMask::View_Plane))
 	{
-		if (AxisForward.Z >= 0 == true)
-		{
-			VerticalMultiplier = Delta_Y * MoveMultiplier;
-		}
+		this->GrabConstraints.Projection = FMatrix::Identity;
+	}
+
+	this->GrabConstraints.Stages = EGizmoConstraintStage::Axis_Mask;
+
+	if (this->GridSize > 0)
+	{
+		this->GrabConstraints.GridSize = this->GridSize;
+		this->GrabConstraints.Stages |= EGizmoConstraintStage::Grid_Snap;
+	}
+
+	if (this->bClampToVolume && this->ClampVolume.IsValid)
+	{
+		this->GrabConstraints.Volume = this->ClampVolume;
+		this->GrabConstraints.Stages |= EGizmoConstraintStage::Clamp;
+	}
 
-		else
+	UPrimitiveComponent* SweepComponent = Cast<UPrimitiveComponent>(this->GizmoBase->GizmoTarget);
+
+	if (this->bSweepCollision && IsValid(SweepComponent))
+	{
+		this->GrabConstraints.World = this->GetWorld();
+		this->GrabConstraints.SweepComponent = SweepComponent;
+		this->GrabConstraints.SweepStart = SweepComponent->GetComponentLocation();
+		this->GrabConstraints.SweepRotation = SweepComponent->GetComponentQuat();
+		this->GrabConstraints.SweepChannel = this->SweepChannel;
+		this->GrabConstraints.SweepParams = FComponentQueryParams(SCENE_QUERY_STAT(GizmoSweep), this);
+		this->GrabConstraints.SweepParams.AddIgnoredActor(this->GizmoBase);
+
+		TArray<USceneComponent*> Targets;
+		this->GizmoBase->GetAllTargets(Targets);
+
+		for (const USceneComponent* EachTarget : Targets)
 		{
-			VerticalMultiplier = Delta_Y * MoveMultiplier * (-1);
+			this->GrabConstraints.SweepParams.AddIgnoredActor(EachTarget->GetOwner());
 		}
 
+		this->GrabConstraints.Stages |= EGizmoConstraintStage::Sweep;
 	}
 
-	else
+	// Surface traces ignore the dragged selection and the gizmo itself. Built once per drag.
+	this->GrabAnchorTransform = this->GizmoBase->GetAnchorTransform();
+	this->bHasSurfaceTrace = false;
+	this->SurfaceHit.Reset(1.f, false);
+	this->SurfaceQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(GizmoSurfaceDrag), false, this);
+	this->SurfaceQueryParams.AddIgnoredActor(this->GizmoBase);
+
+	if (this->bSurfaceDrag)
 	{
-		if (DotProduct > 0 == true)
+		TArray<USceneComponent*> Targets;
+		this->GizmoBase->GetAllTargets(Targets);
+
+		for (const USceneComponent* EachTarget : Targets)
 		{
-			VerticalMultiplier = Delta_Y * MoveMultiplier * (-1);
+			this->SurfaceQueryParams.AddIgnoredActor(EachTarget->GetOwner());
 		}
 
-		else
+		// Bounds of every primitive of the target's actor in the anchor frame. A plain scene component root has no bounds of its own.
+		this->SurfaceLocalBounds.Init();
+		const AActor* TargetOwner = IsValid(this->GizmoBase->GizmoTarget) ? this->GizmoBase->GizmoTarget->GetOwner() : nullptr;
+
+		if (IsValid(TargetOwner))
 		{
-			VerticalMultiplier = Delta_Y * MoveMultiplier;
+			const FTransform AnchorTransform = this->GrabAnchorTransform;
+
+			TargetOwner->ForEachComponent<UPrimitiveComponent>(false, [this, &AnchorTransform](const UPrimitiveComponent* EachPrimitive)
+			{
+				if (EachPrimitive->IsRegistered())
+				{
+					this->SurfaceLocalBounds += EachPrimitive->CalcBounds(EachPrimitive->GetComponentTransform().GetRelativeTransform(AnchorTransform)).GetBox();
+				}
+			});
 		}
 	}
 
-	FVector DeltaLocation = AxisForward * UKismetMathLibrary::Lerp(VerticalMultiplier, HorizontalMultiplier, UKismetMathLibrary::FClamp(UKismetMathLibrary::Abs(CrossVector.Z), 0, 1));
-	this->GizmoBase->GizmoTarget->AddWorldOffset(DeltaLocation, false, nullptr, ETeleportType::None);
+	return true;
 }
 
-void AGizmoMathMove::Transform_Track()
+bool AGizmoMathMove::Snap_Offset(FVector& InOut_Offset)
 {
-	USceneComponent* ParentRoot = nullptr;
+	UGizmoSnapSubsystem* Snap = this->GetWorld()->GetSubsystem<UGizmoSnapSubsystem>();
 
-	if (IsValid(GizmoBase->GetRootComponent()))
+	if (!IsValid(Snap))
 	{
-		ParentRoot = GizmoBase->GetRootComponent();
-		ParentRoot->SetWorldLocation(this->GizmoBase->GizmoTarget->GetComponentLocation(), false, nullptr, ETeleportType::None);
+		return false;
 	}
+
+	const FGizmoViewState& View = this->GizmoBase->InputFrame.View;
+	FVector2D PivotScreen;
+
+	if (!View.ProjectWorldToScreen(this->GrabGizmoLocation + InOut_Offset, PivotScreen))
+	{
+		return false;
+	}
+
+	if (Snap->FindSnapCandidates(View, PivotScreen, this->SnapPixelRadius, 1, this->GizmoBase->GetDragSnapSources(), this->SnapCandidates) == 0)
+	{
+		return false;
+	}
+
+	// The axis mask stage projects it onto the grabbed axis or plane.
+	InOut_Offset = this->SnapCandidates[0].Location - this->GrabGizmoLocation;
+	return true;
 }
 
-void AGizmoMathMove::OnClickedEvent(UPrimitiveComponent* TouchComponent, FKey PressedButton)
+bool AGizmoMathMove::Surface_Solve(const FVector2D& ScreenPosition, FGizmoDragDelta& Out_Delta)
 {
-	if (!IsValid(TouchComponent))
+	const FGizmoViewState& View = this->GizmoBase->InputFrame.View;
+
+	// Trace cost follows cursor motion, not frame rate. A still cursor under a still camera changes nothing.
+	if (this->bHasSurfaceTrace && FVector2D::Distance(ScreenPosition, this->SurfaceTraceMousePosition) < this->SurfaceTraceTolerance && View.ViewProjectionMatrix.Equals(this->SurfaceTraceViewProjection, 0))
 	{
-		return;
+		return false;
 	}
 
-	this->AxisComponent = TouchComponent;
+	FVector RayOrigin;
+	FVector RayDirection;
+
+	if (!View.DeprojectScreenToWorld(ScreenPosition, RayOrigin, RayDirection))
+	{
+		return false;
+	}
+
+	this->SurfaceTraceMousePosition = ScreenPosition;
+	this->SurfaceTraceViewProjection = View.ViewProjectionMatrix;
+	this->bHasSurfaceTrace = true;
+
+	INC_DWORD_STAT(STAT_Gizmo_SurfaceTraces);
 
-	if (TouchComponent->ComponentHasTag(FName("Axis_X")))
+	if (!this->GetWorld()->LineTraceSingleByChannel(this->SurfaceHit, RayOrigin, RayOrigin + RayDirection * GizmoSurfaceTraceDistance, this->SurfaceTraceChannel, this->SurfaceQueryParams))
 	{
-		this->AxisEnum = ESelectedAxis::X_Axis;
+		return false;
 	}
 
-	else if (TouchComponent->ComponentHasTag(FName("Axis_Y")))
+	const FVector Normal = this->SurfaceHit.ImpactNormal;
+	const FQuat StartRotation = this->GrabAnchorTransform.GetRotation();
+	const FQuat NewRotation = this->bAlignToSurface ? FRotationMatrix::MakeFromZX(Normal, StartRotation.GetForwardVector()).ToQuat() : StartRotation;
+
+	// Lowest point of the bounds along the normal, at the new rotation, rests on the hit.
+	double SupportOffset = 0;
+
+	if (this->SurfaceLocalBounds.IsValid)
 	{
-		this->AxisEnum = ESelectedAxis::Y_Axis;
+		const FBox Bounds = this->SurfaceLocalBounds.TransformBy(FTransform(NewRotation, FVector::ZeroVector, this->GrabAnchorTransform.GetScale3D()));
+		SupportOffset = FVector::DotProduct(Bounds.GetExtent(), Normal.GetAbs()) - FVector::DotProduct(Bounds.GetCenter(), Normal);
 	}
 
-	else if (TouchComponent->ComponentHasTag(FName("Axis_Z")))
+	Out_Delta.Pivot = this->GrabAnchorTransform.GetLocation();
+	Out_Delta.Rotation = NewRotation * StartRotation.Inverse();
+	Out_Delta.Translation = this->SurfaceHit.ImpactPoint + Normal * SupportOffset - Out_Delta.Pivot;
+
+	return true;
+}
+
+EGizmoAxisMask AGizmoMathMove::GetAxisMask() const
+{
+	if (this->AxisMaskOverride != 0)
 	{
-		this->AxisEnum = ESelectedAxis::Z_Axis;
+		return static_cast<EGizmoAxisMask>(this->AxisMaskOverride);
 	}
 
-	if (this->bEnableDebugMode)
+	return GizmoAxisMaskFromSelected(this->AxisEnum, GizmoTranslateAxes);
+}
+
+ESelectedAxis AGizmoMathMove::GetAxisEnum(const UPrimitiveComponent* Handle) const
+{
+	if (Handle == nullptr)
 	{
-		GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, TouchComponent->GetFullName());
+		return ESelectedAxis::Null_Axis;
 	}
+
+	if (Handle == this->Axis_X)
+	{
+		return ESelectedAxis::X_Axis;
+	}
+
+	if (Handle == this->Axis_Y)
+	{
+		return ESelectedAxis::Y_Axis;
+	}
+
+	if (Handle == this->Axis_Z)
+	{
+		return ESelectedAxis::Z_Axis;
+	}
+
+	return ESelectedAxis::Null_Axis;
 }
 
 void AGizmoMathMove::BindDelegates()
 {
-	if (IsValid(this->Axis_X) && IsValid(this->Axis_Y) && IsValid(this->Axis_X))
+	if (IsValid(this->Axis_X) && IsValid(this->Axis_Y) && IsValid(this->Axis_Z))
 	{
-		EnableInput(this->PlayerController);
-		this->PlayerController->bEnableClickEvents = true;
+		if (IsValid(this->PlayerController))
+		{
+			EnableInput(this->PlayerController);
+			this->PlayerController->bEnableClickEvents = true;
+		}
 
 		this->Axis_X->OnClicked.AddDynamic(this, &AGizmoMathMove::OnClickedEvent);
 		this->Axis_Y->OnClicked.AddDynamic(this, &AGizmoMathMove::OnClickedEvent);
-		this->Axis_Z->OnClicked.AddDynamic(this, &AGizmoMathMove::OnClickedEvent);		
+		this->Axis_Z->OnClicked.AddDynamic(this, &AGizmoMathMove::OnClickedEvent);
+
+		this->Axis_X->OnReleased.AddDynamic(this, &AGizmoMathMove::OnReleasedEvent);
+		this->Axis_Y->OnReleased.AddDynamic(this, &AGizmoMathMove::OnReleasedEvent);
+		this->Axis_Z->OnReleased.AddDynamic(this, &AGizmoMathMove::OnReleasedEvent);
 	}
 }
 
@@ -1,15 +1,25 @@
 #include "Math/Gizmo_Math_Rotate.h"
 
+#include "Gizmo_Stats.h"
+#include "Assets/Gizmo_Asset_Subsystem.h"
+#include "Math/Gizmo_Math_Axis_Mask.h"
+
+// Rotation planes facing the camera less than this (cosine) are too edge-on for ray-plane solving.
+static constexpr double GizmoMinRotatePlaneFacing = 0.2;
+
 AGizmoMathRotate::AGizmoMathRotate()
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
+	this->Diagnostics.SetOwner(this);
 	this->InitHandles();
 }
 
 void AGizmoMathRotate::BeginPlay()
 {
 	Super::BeginPlay();
+
+	this->LoadAssets();
 	
 	if (!IsValid(this->GetParentActor()))
 	{
@@ -25,10 +35,19 @@ void AGizmoMathRotate::BeginPlay()
 
 	this->GizmoBase = TempBase;
 
-	UWorld* CurrentWorld = GEngine->GetCurrentPlayWorld();
+	// Input frame is captured in the base tick.
+	this->AddTickPrerequisiteActor(this->GizmoBase);
+
+	UWorld* CurrentWorld = this->GetWorld();
 	this->PlayerController = UGameplayStatics::GetPlayerController(CurrentWorld, this->GizmoBase->PlayerIndex);
-	PlayerController->bEnableClickEvents = true;
-	EnableInput(this->PlayerController);
+
+	if (IsValid(this->PlayerController))
+	{
+		this->PlayerController->bEnableClickEvents = true;
+		EnableInput(this->PlayerController);
+	}
+
+	this->BindDelegates();
 }
 
 void AGizmoMathRotate::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -40,6 +59,11 @@ void AGizmoMathRotate::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 	this->RotateSystem();
+
+	if (this->bEnableDebugMode)
+	{
+		this->Diagnostics.ShowOnScreen();
+	}
 }
 
 void AGizmoMathRotate::InitHandles()
@@ -73,65 +97,240 @@ void AGizmoMathRotate::InitHandles()
 	this->Axis_Z->SetCastShadow(false);
 }
 
+TArray<FSoftObjectPath> AGizmoMathRotate::GetAssetPaths() const
+{
+	return
+	{
+		this->RingMesh.ToSoftObjectPath(),
+		this->Material_X.ToSoftObjectPath(),
+		this->Material_Y.ToSoftObjectPath(),
+		this->Material_Z.ToSoftObjectPath(),
+	};
+}
+
+void AGizmoMathRotate::LoadAssets()
+{
+	UGizmoAssetSubsystem* Assets = UGizmoAssetSubsystem::Get();
+
+	if (!IsValid(Assets))
+	{
+		return;
+	}
+
+	Assets->RequestAssets(this->GetAssetPaths(), FStreamableDelegate::CreateUObject(this, &AGizmoMathRotate::ApplyAssets));
+}
+
+void AGizmoMathRotate::ApplyAssets()
+{
+	UGizmoAssetSubsystem::ApplyToHandle(this->Axis_X, this->RingMesh, this->Material_X);
+	UGizmoAssetSubsystem::ApplyToHandle(this->Axis_Y, this->RingMesh, this->Material_Y);
+	UGizmoAssetSubsystem::ApplyToHandle(this->Axis_Z, this->RingMesh, this->Material_Z);
+}
+
 void AGizmoMathRotate::RotateSystem()
 {
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_RotateSystem);
+
 	if (!this->Rotate_Check())
 	{
 		return;
 	}
 
-	RotateMultiplier += this->GetInputAxisKeyValue(EKeys::MouseWheelAxis);
+	RotateMultiplier += this->GizmoBase->InputFrame.MouseWheel;
 
 	if (RotateMultiplier <= 0)
 	{
 		RotateMultiplier = 1;
 	}
 
-	switch (this->AxisEnum)
+	const FGizmoInputFrame& InputFrame = this->GizmoBase->InputFrame;
+
+	// Axis can also be selected from Blueprint without a click, so grab lazily where the cursor was at the end of the last frame.
+	if ((!this->GizmoBase->bIsDragging || this->GrabAxisEnum != this->AxisEnum) && !this->BeginGrab(InputFrame.PreviousMousePosition))
 	{
-		case ESelectedAxis::Null_Axis:
-		{
-			break;
-		}
-	
-		case ESelectedAxis::X_Axis:
-		{
-			if (this->bRotateLocal)
-			{
-				const double Rotation = this->Rotate_XY() * RotateMultiplier;
-				this->GizmoBase->GizmoTarget->AddWorldRotation(FRotator(Rotation, 0, 0));
-				break;
-			}
+		return;
+	}
 
-			else
-			{
+	FGizmoTelemetryTimer SolverTimer(this->GizmoBase->Telemetry, EGizmoTelemetryMetric::Solver_Time);
 
-			}
-		}
-		
-		case ESelectedAxis::Y_Axis:
+	if (this->GrabPlane.bIsValid)
+	{
+		// Integrating every sample in order keeps fast flicks that sweep past 180 degrees between two frames.
+		for (const FVector2D& EachSample : InputFrame.Samples)
 		{
-			if (this->bRotateLocal)
-			{
-				const double Rotation = this->Rotate_XY() * RotateMultiplier;
-				this->GizmoBase->GizmoTarget->AddWorldRotation(FRotator(0, Rotation, 0));
-				break;
-			}
+			double DeltaAngle = 0;
 
-			else
+			if (this->Rotate_Sample(EachSample, DeltaAngle))
 			{
-
+				this->GrabAngle += DeltaAngle;
 			}
 		}
+	}
+
+	else
+	{
+		this->GrabAngle += this->Rotate_XY(InputFrame.MouseDelta) * RotateMultiplier;
+	}
+
+	FGizmoDragDelta Delta;
+	Delta.Rotation = FQuat(this->GrabAxis, FMath::DegreesToRadians(this->GrabAngle));
+	Delta.Pivot = this->GrabPivot;
+
+	this->GizmoBase->ApplyDragDelta(Delta);
+}
+
+bool AGizmoMathRotate::Rotate_Sample(const FVector2D& ScreenPosition, double& Out_DeltaAngle)
+{
+	FVector Point;
+
+	if (!this->GrabPlane.Solve(this->GizmoBase->InputFrame.View, ScreenPosition, Point))
+	{
+		return false;
+	}
+
+	const FVector PlaneVector = Point - this->GrabPivot;
+
+	if (PlaneVector.IsNearlyZero())
+	{
+		return false;
+	}
+
+	Out_DeltaAngle = this->bHasPreviousPlaneVector ? FMath::RadiansToDegrees(GizmoSignedAngle(this->PreviousPlaneVector, PlaneVector, this->GrabAxis)) : 0;
+
+	this->PreviousPlaneVector = PlaneVector;
+	this->bHasPreviousPlaneVector = true;
+
+	return true;
+}
+
+bool AGizmoMathRotate::BeginGrab(const FVector2D& MousePosition)
+{
+	const FVector Axis = this->GetRotationAxis();
+
+	if (Axis.IsNearlyZero())
+	{
+		return false;
+	}
+
+	this->GizmoBase->BeginDrag();
+
+	this->GrabAxisEnum = this->AxisEnum;
+	this->GrabAxis = Axis;
+	this->GrabAngle = 0;
+	this->GrabPivot = this->GizmoBase->GetAnchorTransform().GetLocation();
+	this->bHasPreviousPlaneVector = false;
+
+	const FGizmoViewState& View = this->GizmoBase->InputFrame.View;
+	const double Facing = View.bIsValid ? FMath::Abs(FVector::DotProduct((this->GrabPivot - View.ViewOrigin).GetSafeNormal(), Axis)) : 0;
+
+	if (Facing >= GizmoMinRotatePlaneFacing && this->GrabPlane.InitForPlane(this->GrabPivot, Axis))
+	{
+		double IgnoredAngle = 0;
+		this->Rotate_Sample(MousePosition, IgnoredAngle);
+	}
 
-		case ESelectedAxis::Z_Axis:
+	else
+	{
+		this->GrabPlane.bIsValid = false;
+	}
+
+	return true;
+}
+
+FVector AGizmoMathRotate::GetRotationAxis() const
+{
+	const FQuat Frame = this->bRotateLocal ? this->GizmoBase->GetAnchorTransform().GetRotation() : FQuat::Identity;
+	const EGizmoAxisMask Mask = GizmoAxisMaskFromSelected(this->AxisEnum, GizmoRotateAxes);
+
+	// Screen rotation turns around the view direction.
+	if (EnumHasAnyFlags(Mask, EGizmoAxisMask::Screen))
+	{
+		return -this->GizmoBase->InputFrame.View.ViewDirection;
+	}
+
+	// Rotation needs exactly one axis.
+	return GizmoAxisCount(Mask, GizmoRotateAxes) == 1 ? GizmoAxisSum(Mask, GizmoRotateAxes, Frame) : FVector::ZeroVector;
+}
+
+ESelectedAxis AGizmoMathRotate::GetAxisEnum(const UPrimitiveComponent* Handle) const
+{
+	if (Handle == nullptr)
+	{
+		return ESelectedAxis::Null_Axis;
+	}
+
+	if (Handle == this->Axis_X)
+	{
+		return ESelectedAxis::X_Axis;
+	}
+
+	if (Handle == this->Axis_Y)
+	{
+		return ESelectedAxis::Y_Axis;
+	}
+
+	if (Handle == this->Axis_Z)
+	{
+		return ESelectedAxis::Z_Axis;
+	}
+
+	return ESelectedAxis::Null_Axis;
+}
+
+void AGizmoMathRotate::OnClickedEvent(UPrimitiveComponent* TouchComponent, FKey PressedButton)
+{
+	if (!IsValid(TouchComponent))
+	{
+		return;
+	}
+
+	this->AxisComponent = TouchComponent;
+
+	const ESelectedAxis TouchedAxis = this->GetAxisEnum(TouchComponent);
+
+	if (TouchedAxis != ESelectedAxis::Null_Axis)
+	{
+		this->AxisEnum = TouchedAxis;
+	}
+
+	if (IsValid(this->GizmoBase) && this->GizmoBase->HasAnchor())
+	{
+		FVector2D MousePosition = this->GizmoBase->InputFrame.MousePosition;
+
+		if (IsValid(this->PlayerController))
 		{
-			break;
+			this->PlayerController->GetMousePosition(MousePosition.X, MousePosition.Y);
 		}
 
-		default:
+		this->BeginGrab(MousePosition);
+	}
+
+	if (this->bEnableDebugMode)
+	{
+		GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, TouchComponent->GetFullName());
+	}
+}
+
+void AGizmoMathRotate::OnReleasedEvent(UPrimitiveComponent* TouchComponent, FKey ReleasedButton)
+{
+	if (IsValid(this->GizmoBase))
+	{
+		this->GizmoBase->EndDrag();
+	}
+
+	// Like Scale. A selected axis left behind would start a new drag on the next move with no button held.
+	this->AxisEnum = ESelectedAxis::Null_Axis;
+	this->GrabAxisEnum = ESelectedAxis::Null_Axis;
+}
+
+void AGizmoMathRotate::BindDelegates()
+{
+	for (UStaticMeshComponent* EachAxis : { this->Axis_X, this->Axis_Y, this->Axis_Z })
+	{
+		if (IsValid(EachAxis))
 		{
-			break;
+			EachAxis->OnClicked.AddDynamic(this, &AGizmoMathRotate::OnClickedEvent);
+			EachAxis->OnReleased.AddDynamic(this, &AGizmoMathRotate::OnReleasedEvent);
 		}
 	}
 }
@@ -139,13 +338,13 @@ void AGizmoMathRotate::RotateSystem()
 FVector AGizmoMathRotate::HorizontalNormal(USceneComponent* Target)
 {
 	const FVector WorldLocation = Target->GetComponentLocation();
-	const FVector CameraLocation = this->GizmoBase->PlayerCamera->GetComponentLocation();
+	const FVector CameraLocation = this->GizmoBase->InputFrame.View.ViewOrigin;
 	const FVector Difference = CameraLocation - WorldLocation;
 
 	return UKismetMathLibrary::Normal(FVector(Difference.X, Difference.Y, 0));
 }
 
-double AGizmoMathRotate::Rotate_XY()
+double AGizmoMathRotate::Rotate_XY(const FVector2D& MouseDelta)
 {
 	USceneComponent* AxisComp = nullptr;
 
@@ -188,72 +387,47 @@ double AGizmoMathRotate::Rotate_XY()
 	const double Mouse_Y_Multiplier = UKismetMathLibrary::Abs(AxisForward_Z) >= 0.75 ? Mouse_Y_Multiplier_True : (DotProduct > 0 ? -5 : 5);
 	const double Mouse_Alpha = UKismetMathLibrary::FClamp(UKismetMathLibrary::Abs(Cross_Z), 0, 1);
 
-	FVector2D MouseDelta = FVector2D((double)0.f);
-	this->PlayerController->GetInputMouseDelta(MouseDelta.X, MouseDelta.Y);
-
 	const double Rotation = UKismetMathLibrary::Lerp(Mouse_Y_Multiplier * MouseDelta.Y, Mouse_X_Multiplier * MouseDelta.X, Mouse_Alpha);
 	return Rotation;
 }
 
 bool AGizmoMathRotate::Rotate_Check()
 {
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_TransformCheck);
+
 	if (!IsValid(GizmoBase))
 	{
-		if (bEnableDebugMode)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Gizmo Rotate : Gizmo base is not valid !");
-		}
-
+		this->Diagnostics.Report(EGizmoDiagnostic::Base_Invalid);
 		return false;
 	}
 
-	else if (!IsValid(this->GizmoBase->GizmoTarget))
+	else if (!this->GizmoBase->HasAnchor())
 	{
-		if (bEnableDebugMode)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Gizmo Rotate : Gizmo target is not valid !");
-		}
-
+		this->Diagnostics.Report(EGizmoDiagnostic::Target_Invalid);
 		return false;
 	}
 
 	else if (!this->GizmoBase->DetectMovementCallback())
 	{
-		if (bEnableDebugMode)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Gizmo Rotate : There is no movement !");
-		}
-
+		this->Diagnostics.Report(EGizmoDiagnostic::No_Movement);
 		return false;
 	}
 
 	else if (!this->GizmoBase->IsGizmoInViewCallback())
 	{
-		if (bEnableDebugMode)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Gizmo Rotate : Gizmo is not in the view !");
-		}
-
+		this->Diagnostics.Report(EGizmoDiagnostic::Not_In_View);
 		return false;
 	}
 
 	else if (this->GizmoBase->ForbiddenKeysCallback())
 	{
-		if (bEnableDebugMode)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Gizmo Rotate : Forbidden key pressed !");
-		}
-
+		this->Diagnostics.Report(EGizmoDiagnostic::Forbidden_Key);
 		return false;
 	}
 
-	else if (this->Check_Visibility())
+	else if (!this->Check_Visibility())
 	{
-		if (bEnableDebugMode)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Gizmo Rotate : Gizmo is not visible !");
-		}
-
+		this->Diagnostics.Report(EGizmoDiagnostic::Not_Visible);
 		return false;
 	}
 
@@ -262,9 +436,14 @@ bool AGizmoMathRotate::Rotate_Check()
 
 bool AGizmoMathRotate::Check_Visibility()
 {
-	const FVector CameraFowardVector = this->GizmoBase->PlayerCamera->GetForwardVector();
-	const FVector CameraLocation = this->GizmoBase->PlayerCamera->GetComponentLocation();
-	const FVector TargetLocation = this->GizmoBase->GizmoTarget->GetComponentLocation();
+	if (!this->GizmoBase->InputFrame.View.bIsValid)
+	{
+		return false;
+	}
+
+	const FVector CameraFowardVector = this->GizmoBase->InputFrame.View.ViewDirection;
+	const FVector CameraLocation = this->GizmoBase->InputFrame.View.ViewOrigin;
+	const FVector TargetLocation = this->GizmoBase->GetAnchorTransform().GetLocation();
 
 	const FVector Difference = TargetLocation - CameraLocation;
 	const FVector NormalizedVector = UKismetMathLibrary::Normal(Difference, 0.0001);
@@ -0,0 +1,406 @@
+#include "Math/Gizmo_Math_Scale.h"
+
+#include "Gizmo_Stats.h"
+#include "Assets/Gizmo_Asset_Subsystem.h"
+#include "Math/Gizmo_Math_Axis_Mask.h"
+
+// Sets default values.
+AGizmoMathScale::AGizmoMathScale()
+{
+ 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	PrimaryActorTick.bCanEverTick = true;
+	this->Diagnostics.SetOwner(this);
+	this->InitHandles();
+}
+
+// Called when the game starts or when spawned.
+void AGizmoMathScale::BeginPlay()
+{
+	Super::BeginPlay();
+
+	this->LoadAssets();
+
+	if (!IsValid(this->GetParentActor()))
+	{
+		return;
+	}
+
+	AGizmoMathBase* TempBase = Cast<AGizmoMathBase>(this->GetParentActor());
+
+	if (!IsValid(TempBase))
+	{
+		return;
+	}
+
+	this->GizmoBase = TempBase;
+
+	// Input frame is captured in the base tick.
+	this->AddTickPrerequisiteActor(this->GizmoBase);
+
+	UWorld* CurrentWorld = this->GetWorld();
+	this->PlayerController = UGameplayStatics::GetPlayerController(CurrentWorld, this->GizmoBase->PlayerIndex);
+
+	this->BindDelegates();
+}
+
+void AGizmoMathScale::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (IsValid(this->GizmoBase) && this->GizmoBase->bIsDragging)
+	{
+		this->GizmoBase->EndDrag();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// Called every frame.
+void AGizmoMathScale::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	this->ScaleSystem();
+
+	if (this->bEnableDebugMode)
+	{
+		this->Diagnostics.ShowOnScreen();
+	}
+}
+
+UStaticMeshComponent* AGizmoMathScale::CreateHandle(FName HandleName, const FRotator& HandleRotation, UStaticMesh* HandleMesh)
+{
+	UStaticMeshComponent* Handle = CreateDefaultSubobject<UStaticMeshComponent>(HandleName);
+	Handle->AttachToComponent(this->Root, FAttachmentTransformRules::KeepRelativeTransform);
+	Handle->SetRelativeRotation(HandleRotation);
+	Handle->ComponentTags.Add(HandleName);
+	Handle->SetGenerateOverlapEvents(true);
+	Handle->SetCollisionProfileName(FName("BlockAll"));
+	Handle->SetNotifyRigidBodyCollision(true);
+	Handle->SetCastShadow(false);
+
+	if (IsValid(HandleMesh))
+	{
+		Handle->SetStaticMesh(HandleMesh);
+	}
+
+	return Handle;
+}
+
+void AGizmoMathScale::InitHandles()
+{
+	this->Root = CreateDefaultSubobject<USceneComponent>("Root");
+
+	// Meshes are streamed in on BeginPlay, see LoadAssets.
+	this->Axis_X = this->CreateHandle("Axis_X", FRotator3d(0, 0, 0), nullptr);
+	this->Axis_Y = this->CreateHandle("Axis_Y", FRotator3d(0, 90, 0), nullptr);
+	this->Axis_Z = this->CreateHandle("Axis_Z", FRotator3d(90, 0, 0), nullptr);
+
+	this->Plane_XY = this->CreateHandle("Plane_XY", FRotator3d(0, 0, 0), nullptr);
+	this->Plane_XZ = this->CreateHandle("Plane_XZ", FRotator3d(0, 0, 90), nullptr);
+	this->Plane_YZ = this->CreateHandle("Plane_YZ", FRotator3d(90, 0, 0), nullptr);
+
+	// Uniform handle has no default mesh. Assign CenterMesh, use SetHandleMeshes or Blueprint.
+	this->Axis_XYZ = this->CreateHandle("Axis_XYZ", FRotator3d(0, 0, 0), nullptr);
+}
+
+TArray<FSoftObjectPath> AGizmoMathScale::GetAssetPaths() const
+{
+	return
+	{
+		this->AxisMesh.ToSoftObjectPath(),
+		this->PlaneMesh.ToSoftObjectPath(),
+		this->CenterMesh.ToSoftObjectPath(),
+		this->Material_X.ToSoftObjectPath(),
+		this->Material_Y.ToSoftObjectPath(),
+		this->Material_Z.ToSoftObjectPath(),
+		this->Material_XYZ.ToSoftObjectPath(),
+	};
+}
+
+void AGizmoMathScale::LoadAssets()
+{
+	UGizmoAssetSubsystem* Assets = UGizmoAssetSubsystem::Get();
+
+	if (!IsValid(Assets))
+	{
+		return;
+	}
+
+	Assets->RequestAssets(this->GetAssetPaths(), FStreamableDelegate::CreateUObject(this, &AGizmoMathScale::ApplyAssets));
+}
+
+void AGizmoMathScale::ApplyAssets()
+{
+	UGizmoAssetSubsystem::ApplyToHandle(this->Axis_X, this->AxisMesh, this->Material_X);
+	UGizmoAssetSubsystem::ApplyToHandle(this->Axis_Y, this->AxisMesh, this->Material_Y);
+	UGizmoAssetSubsystem::ApplyToHandle(this->Axis_Z, this->AxisMesh, this->Material_Z);
+	UGizmoAssetSubsystem::ApplyToHandle(this->Plane_XY, this->PlaneMesh, this->Material_XYZ);
+	UGizmoAssetSubsystem::ApplyToHandle(this->Plane_XZ, this->PlaneMesh, this->Material_XYZ);
+	UGizmoAssetSubsystem::ApplyToHandle(this->Plane_YZ, this->PlaneMesh, this->Material_XYZ);
+	UGizmoAssetSubsystem::ApplyToHandle(this->Axis_XYZ, this->CenterMesh, this->Material_XYZ);
+}
+
+void AGizmoMathScale::ScaleSystem()
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_ScaleSystem);
+
+	if (!this->Scale_Check())
+	{
+		return;
+	}
+
+	// Axis can also be selected without a click, from Blueprint or by a replay, so grab lazily where the cursor was at the end of the last frame.
+	if ((!this->GizmoBase->bIsDragging || this->GrabAxisEnum != this->AxisEnum) && !this->BeginGrab(this->GizmoBase->InputFrame.PreviousMousePosition))
+	{
+		return;
+	}
+
+	FGizmoTelemetryTimer SolverTimer(this->GizmoBase->Telemetry, EGizmoTelemetryMetric::Solver_Time);
+
+	// Ratio is computed once per frame and shared by every target.
+	this->Scale_Apply(this->Scale_Ratio());
+	this->Scale_Track();
+}
+
+bool AGizmoMathScale::Scale_Check()
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_TransformCheck);
+
+	if (!IsValid(GizmoBase))
+	{
+		this->Diagnostics.Report(EGizmoDiagnostic::Base_Invalid);
+		return false;
+	}
+
+	if (!this->GizmoBase->HasAnchor())
+	{
+		this->Diagnostics.Report(EGizmoDiagnostic::Target_Invalid);
+		return false;
+	}
+
+	if (this->AxisEnum == ESelectedAxis::Null_Axis)
+	{
+		return false;
+	}
+
+	if (!this->GizmoBase->DetectMovementCallback())
+	{
+		this->Diagnostics.Report(EGizmoDiagnostic::No_Movement);
+		return false;
+	}
+
+	if (!this->GizmoBase->IsGizmoInViewCallback())
+	{
+		this->Diagnostics.Report(EGizmoDiagnostic::Not_In_View);
+		return false;
+	}
+
+	if (this->GizmoBase->ForbiddenKeysCallback())
+	{
+		this->Diagnostics.Report(EGizmoDiagnostic::Forbidden_Key);
+		return false;
+	}
+
+	return true;
+}
+
+FVector AGizmoMathScale::Scale_Ratio()
+{
+	const FVector2D MousePosition = this->GizmoBase->InputFrame.MousePosition;
+	const double PixelDistance = FVector2D::DotProduct(MousePosition - this->GrabMousePosition, this->GrabScreenDirection);
+	const double Ratio = FMath::Max(1.0 + (PixelDistance * this->ScaleMultiplier), UE_KINDA_SMALL_NUMBER);
+
+	const uint32 Bits = GizmoAxisBits(GizmoAxisMaskFromSelected(this->AxisEnum, GizmoScaleAxes), GizmoScaleAxes);
+
+	return FVector((Bits & 1) ? Ratio : 1, (Bits & 2) ? Ratio : 1, (Bits & 4) ? Ratio : 1);
+}
+
+void AGizmoMathScale::Scale_Apply(const FVector& Ratio)
+{
+	FGizmoDragDelta Delta;
+	Delta.ScaleRatio = Ratio;
+	Delta.Pivot = this->GrabPivot;
+	Delta.ScaleFrame = this->GrabFrame;
+	Delta.bScaleAboutPivot = this->ScalePivot != EScalePivot::Target_Origin;
+	Delta.ScaleSnap = this->SnapIncrement;
+	Delta.MinScale = this->MinScale;
+
+	this->GizmoBase->ApplyDragDelta(Delta);
+}
+
+void AGizmoMathScale::Scale_Track()
+{
+	this->GetRootComponent()->SetWorldRotation(this->GizmoBase->GetAnchorTransform().GetRotation());
+
+	if (IsValid(GizmoBase->GetRootComponent()))
+	{
+		GizmoBase->GetRootComponent()->SetWorldLocation(this->GizmoBase->GetAnchorTransform().GetLocation(), false, nullptr, ETeleportType::None);
+	}
+}
+
+ESelectedAxis AGizmoMathScale::GetAxisEnum(const UPrimitiveComponent* Handle) const
+{
+	if (Handle == nullptr)
+	{
+		return ESelectedAxis::Null_Axis;
+	}
+
+	const TPair<const UPrimitiveComponent*, ESelectedAxis> Handles[] =
+	{
+		{ this->Axis_X, ESelectedAxis::X_Axis },
+		{ this->Axis_Y, ESelectedAxis::Y_Axis },
+		{ this->Axis_Z, ESelectedAxis::Z_Axis },
+		{ this->Plane_XY, ESelectedAxis::XY_Axis },
+		{ this->Plane_XZ, ESelectedAxis::XZ_Axis },
+		{ this->Plane_YZ, ESelectedAxis::YZ_Axis },
+		{ this->Axis_XYZ, ESelectedAxis::XYZ_Axis },
+	};
+
+	for (const TPair<const UPrimitiveComponent*, ESelectedAxis>& EachHandle : Handles)
+	{
+		if (EachHandle.Key == Handle)
+		{
+			return EachHandle.Value;
+		}
+	}
+
+	return ESelectedAxis::Null_Axis;
+}
+
+void AGizmoMathScale::OnClickedEvent(UPrimitiveComponent* TouchComponent, FKey PressedButton)
+{
+	if (!IsValid(TouchComponent) || !IsValid(this->GizmoBase) || !this->GizmoBase->HasAnchor())
+	{
+		return;
+	}
+
+	this->AxisComponent = TouchComponent;
+
+	const ESelectedAxis TouchedAxis = this->GetAxisEnum(TouchComponent);
+
+	if (TouchedAxis != ESelectedAxis::Null_Axis)
+	{
+		this->AxisEnum = TouchedAxis;
+	}
+
+	FVector2D MousePosition = this->GizmoBase->InputFrame.MousePosition;
+
+	if (IsValid(this->PlayerController))
+	{
+		this->PlayerController->GetMousePosition(MousePosition.X, MousePosition.Y);
+	}
+
+	this->BeginGrab(MousePosition);
+
+	if (this->bEnableDebugMode)
+	{
+		GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, TouchComponent->GetFullName());
+	}
+}
+
+bool AGizmoMathScale::BeginGrab(const FVector2D& MousePosition)
+{
+	if (this->AxisEnum == ESelectedAxis::Null_Axis)
+	{
+		return false;
+	}
+
+	this->GizmoBase->BeginDrag();
+	this->GrabAxisEnum = this->AxisEnum;
+
+	this->GrabFrame = this->GizmoBase->GetAnchorTransform().GetRotation();
+
+	switch (this->ScalePivot)
+	{
+		case EScalePivot::Target_Origin:
+			// Unused, every target scales about its own location.
+			this->GrabPivot = FVector::ZeroVector;
+			break;
+
+		case EScalePivot::Gizmo_Origin:
+			// Where the gizmo is drawn, in the frame it is drawn in.
+			this->GrabPivot = this->GizmoBase->GetActorLocation();
+			this->GrabFrame = this->GetActorQuat();
+			break;
+
+		case EScalePivot::Selection_Center:
+			this->GrabPivot = this->GizmoBase->GetSelectionCenter();
+			break;
+	}
+
+	this->GrabMousePosition = MousePosition;
+
+	// Screen direction that grows the scale. Uniform handle grows when dragging up and right.
+	const EGizmoAxisMask Mask = GizmoAxisMaskFromSelected(this->AxisEnum, GizmoScaleAxes);
+	const FVector HandleDirection = GizmoAxisCount(Mask, GizmoScaleAxes) < 3 ? GizmoAxisSum(Mask, GizmoScaleAxes, this->GrabFrame) : FVector::ZeroVector;
+
+	this->GrabScreenDirection = FVector2D(1, -1).GetSafeNormal();
+
+	FVector2D ScreenStart;
+	FVector2D ScreenEnd;
+	const FVector HandleOrigin = this->GizmoBase->GetAnchorTransform().GetLocation();
+
+	const FGizmoViewState& View = this->GizmoBase->InputFrame.View;
+
+	if (!HandleDirection.IsNearlyZero() && View.ProjectWorldToScreen(HandleOrigin, ScreenStart) && View.ProjectWorldToScreen(HandleOrigin + HandleDirection.GetSafeNormal() * 100, ScreenEnd))
+	{
+		// Handles pointing at the camera have no usable screen direction, so they keep the diagonal.
+		if (FVector2D::Distance(ScreenStart, ScreenEnd) > 1)
+		{
+			this->GrabScreenDirection = (ScreenEnd - ScreenStart).GetSafeNormal();
+		}
+	}
+
+	return true;
+}
+
+void AGizmoMathScale::OnReleasedEvent(UPrimitiveComponent* TouchComponent, FKey ReleasedButton)
+{
+	if (!IsValid(this->GizmoBase))
+	{
+		return;
+	}
+
+	this->GizmoBase->EndDrag();
+	this->AxisEnum = ESelectedAxis::Null_Axis;
+	this->GrabAxisEnum = ESelectedAxis::Null_Axis;
+	this->AxisComponent = nullptr;
+}
+
+void AGizmoMathScale::BindDelegates()
+{
+	if (IsValid(this->PlayerController))
+	{
+		EnableInput(this->PlayerController);
+		this->PlayerController->bEnableClickEvents = true;
+	}
+
+	for (UStaticMeshComponent* EachHandle : { this->Axis_X, this->Axis_Y, this->Axis_Z, this->Plane_XY, this->Plane_XZ, this->Plane_YZ, this->Axis_XYZ })
+	{
+		if (IsValid(EachHandle))
+		{
+			EachHandle->OnClicked.AddDynamic(this, &AGizmoMathScale::OnClickedEvent);
+			EachHandle->OnReleased.AddDynamic(this, &AGizmoMathScale::OnReleasedEvent);
+		}
+	}
+}
+
+void AGizmoMathScale::SetHandleMeshes(UStaticMesh* In_Axis_Mesh, UStaticMesh* In_Plane_Mesh, UStaticMesh* In_Center_Mesh)
+{
+	if (IsValid(In_Axis_Mesh))
+	{
+		this->Axis_X->SetStaticMesh(In_Axis_Mesh);
+		this->Axis_Y->SetStaticMesh(In_Axis_Mesh);
+		this->Axis_Z->SetStaticMesh(In_Axis_Mesh);
+	}
+
+	if (IsValid(In_Plane_Mesh))
+	{
+		this->Plane_XY->SetStaticMesh(In_Plane_Mesh);
+		this->Plane_XZ->SetStaticMesh(In_Plane_Mesh);
+		this->Plane_YZ->SetStaticMesh(In_Plane_Mesh);
+	}
+
+	if (IsValid(In_Center_Mesh))
+	{
+		this->Axis_XYZ->SetStaticMesh(In_Center_Mesh);
+	}
+}
@@ -0,0 +1,212 @@
+#include "Math/Gizmo_Math_Solver.h"
+
+#include "GameFramework/PlayerController.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "SceneView.h"
+
+// Axes whose projection is shorter than this (in pixels per world unit) are treated as pointing at the camera.
+static constexpr double GizmoMinPixelsPerUnit = 0.01;
+
+// Rays closer to parallel with the constraint plane than this (cosine) are rejected, the hit would be far off and unstable.
+static constexpr double GizmoMinRayPlaneCosine = 0.01;
+
+bool FGizmoViewState::Capture(const APlayerController* PlayerController)
+{
+	this->bIsValid = false;
+
+	const ULocalPlayer* LocalPlayer = IsValid(PlayerController) ? PlayerController->GetLocalPlayer() : nullptr;
+
+	if (!LocalPlayer || !LocalPlayer->ViewportClient)
+	{
+		return false;
+	}
+
+	FSceneViewProjectionData ProjectionData;
+
+	if (!LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData))
+	{
+		return false;
+	}
+
+	this->ViewRect = ProjectionData.GetConstrainedViewRect();
+	this->ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+	this->InvViewProjectionMatrix = this->ViewProjectionMatrix.Inverse();
+	this->ViewOrigin = ProjectionData.ViewOrigin;
+
+	// View space Z is the camera forward axis.
+	this->ViewDirection = FVector(ProjectionData.ViewRotationMatrix.GetColumn(2)).GetSafeNormal();
+	this->bIsValid = true;
+
+	return true;
+}
+
+void FGizmoViewState::Build(const FVector& Location, const FRotator& Rotation, float FOVDegrees, const FIntPoint& ViewSize)
+{
+	// Same conventions as ULocalPlayer::GetProjectionData: X axis FOV is kept, view space Z is forward.
+	const FMatrix ViewRotationMatrix = FInverseRotationMatrix(Rotation) * FMatrix(FPlane(0, 0, 1, 0), FPlane(1, 0, 0, 0), FPlane(0, 1, 0, 0), FPlane(0, 0, 0, 1));
+	const float HalfFOV = FMath::DegreesToRadians(FOVDegrees) * 0.5f;
+	const float AspectRatio = ViewSize.Y > 0 ? (float)ViewSize.X / (float)ViewSize.Y : 1.f;
+	const FMatrix ProjectionMatrix = FReversedZPerspectiveMatrix(HalfFOV, HalfFOV, 1.f, AspectRatio, GNearClippingPlane, GNearClippingPlane);
+
+	this->ViewRect = FIntRect(FIntPoint::ZeroValue, ViewSize);
+	this->ViewProjectionMatrix = FTranslationMatrix(-Location) * ViewRotationMatrix * ProjectionMatrix;
+	this->InvViewProjectionMatrix = this->ViewProjectionMatrix.Inverse();
+	this->ViewOrigin = Location;
+	this->ViewDirection = Rotation.Vector();
+	this->bIsValid = true;
+}
+
+bool FGizmoViewState::ProjectWorldToScreen(const FVector& WorldLocation, FVector2D& Out_ScreenPosition) const
+{
+	if (!this->bIsValid)
+	{
+		return false;
+	}
+
+	return FSceneView::ProjectWorldToScreen(WorldLocation, this->ViewRect, this->ViewProjectionMatrix, Out_ScreenPosition);
+}
+
+bool FGizmoViewState::DeprojectScreenToWorld(const FVector2D& ScreenPosition, FVector& Out_RayOrigin, FVector& Out_RayDirection) const
+{
+	if (!this->bIsValid)
+	{
+		return false;
+	}
+
+	FSceneView::DeprojectScreenToWorld(ScreenPosition, this->ViewRect, this->InvViewProjectionMatrix, Out_RayOrigin, Out_RayDirection);
+	return true;
+}
+
+bool FGizmoScreenAxis::Init(const FGizmoViewState& View, const FVector& Origin, const FVector& Axis)
+{
+	this->bIsValid = false;
+	this->WorldAxis = Axis.GetSafeNormal();
+	this->ScreenStep = FVector2D::ZeroVector;
+	this->PixelsPerUnit = 0;
+
+	FVector2D ScreenOrigin;
+	FVector2D ScreenEnd;
+
+	// One world unit along the axis gives the local derivative at the origin depth.
+	if (!View.ProjectWorldToScreen(Origin, ScreenOrigin) || !View.ProjectWorldToScreen(Origin + this->WorldAxis, ScreenEnd))
+	{
+		return false;
+	}
+
+	const FVector2D ScreenAxis = ScreenEnd - ScreenOrigin;
+	this->PixelsPerUnit = ScreenAxis.Size();
+
+	if (this->PixelsPerUnit < GizmoMinPixelsPerUnit)
+	{
+		return false;
+	}
+
+	this->ScreenStep = ScreenAxis / (this->PixelsPerUnit * this->PixelsPerUnit);
+	this->bIsValid = true;
+
+	return true;
+}
+
+double FGizmoScreenAxis::ToWorldDistance(const FVector2D& PixelDelta) const
+{
+	return FVector2D::DotProduct(PixelDelta, this->ScreenStep);
+}
+
+bool FGizmoConstraintPlane::InitForAxis(const FGizmoViewState& View, const FVector& In_Origin, const FVector& In_Axis)
+{
+	this->bIsValid = false;
+	this->Origin = In_Origin;
+	this->Axis = In_Axis.GetSafeNormal();
+
+	const FVector ToCamera = View.bIsValid ? (View.ViewOrigin - In_Origin).GetSafeNormal() : FVector::ZeroVector;
+
+	// Component of the camera direction perpendicular to the axis.
+	this->Normal = (ToCamera - this->Axis * FVector::DotProduct(ToCamera, this->Axis)).GetSafeNormal();
+	this->bIsValid = !this->Axis.IsNearlyZero() && !this->Normal.IsNearlyZero();
+
+	return this->bIsValid;
+}
+
+bool FGizmoConstraintPlane::InitForPlane(const FVector& In_Origin, const FVector& In_Normal)
+{
+	this->Origin = In_Origin;
+	this->Normal = In_Normal.GetSafeNormal();
+	this->Axis = FVector::ZeroVector;
+	this->bIsValid = !this->Normal.IsNearlyZero();
+
+	return this->bIsValid;
+}
+
+bool FGizmoConstraintPlane::Intersect(const FVector& RayOrigin, const FVector& RayDirection, FVector& Out_Point) const
+{
+	const double Denominator = FVector::DotProduct(RayDirection, this->Normal);
+
+	if (FMath::Abs(Denominator) < GizmoMinRayPlaneCosine)
+	{
+		return false;
+	}
+
+	const double Distance = FVector::DotProduct(this->Origin - RayOrigin, this->Normal) / Denominator;
+
+	if (Distance < 0)
+	{
+		return false;
+	}
+
+	Out_Point = RayOrigin + RayDirection * Distance;
+	return true;
+}
+
+bool FGizmoConstraintPlane::Solve(const FGizmoViewState& View, const FVector2D& ScreenPosition, FVector& Out_Point) const
+{
+	FVector RayOrigin;
+	FVector RayDirection;
+
+	if (!this->bIsValid || !View.DeprojectScreenToWorld(ScreenPosition, RayOrigin, RayDirection) || !this->Intersect(RayOrigin, RayDirection, Out_Point))
+	{
+		return false;
+	}
+
+	if (!this->Axis.IsZero())
+	{
+		Out_Point = this->Origin + this->Axis * FVector::DotProduct(Out_Point - this->Origin, this->Axis);
+	}
+
+	return true;
+}
+
+FTransform FGizmoDragDelta::Apply(const FTransform& StartTransform) const
+{
+	const FVector StartScale = StartTransform.GetScale3D();
+	FVector NewScale = StartScale * this->ScaleRatio;
+
+	for (int32 Component = 0; Component < 3; Component++)
+	{
+		// Snapping and clamping are folded into the same value, so they never cost an extra write.
+		if (this->ScaleSnap > 0)
+		{
+			NewScale[Component] = FMath::GridSnap(NewScale[Component], this->ScaleSnap);
+		}
+
+		if (FMath::Abs(NewScale[Component]) < this->MinScale)
+		{
+			NewScale[Component] = StartScale[Component] < 0 ? -this->MinScale : this->MinScale;
+		}
+	}
+
+	FVector Offset = StartTransform.GetLocation() - this->Pivot;
+
+	if (this->bScaleAboutPivot)
+	{
+		// World offset scaled along the shared frame by the drag ratio. The per target ratio is in the target's own axes and would spread rotated targets unevenly.
+		Offset = this->ScaleFrame.RotateVector(this->ScaleFrame.UnrotateVector(Offset) * this->ScaleRatio);
+	}
+
+	return FTransform(this->Rotation * StartTransform.GetRotation(), this->Pivot + this->Rotation.RotateVector(Offset) + this->Translation, NewScale);
+}
+
+double GizmoSignedAngle(const FVector& A, const FVector& B, const FVector& Axis)
+{
+	return FMath::Atan2(FVector::DotProduct(Axis, FVector::CrossProduct(A, B)), FVector::DotProduct(A, B));
+}
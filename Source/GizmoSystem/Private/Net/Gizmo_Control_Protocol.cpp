@@ -0,0 +1,388 @@
+#include "Net/Gizmo_Control_Protocol.h"
+
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "Interfaces/IPv4/IPv4Address.h"
+#include "HAL/PlatformTime.h"
+
+static void GizmoControlAppend(TArray<uint8>& Out_Buffer, const void* Data, int32 Size)
+{
+	Out_Buffer.Append((const uint8*)Data, Size);
+}
+
+// Writes the size placeholder, type and request id. Returns the offset EndMessage patches.
+static int32 GizmoControlBeginMessage(TArray<uint8>& Out_Buffer, EGizmoControlMessage Type, uint32 RequestId)
+{
+	const int32 Offset = Out_Buffer.AddZeroed(FGizmoControlProtocol::SizeBytes);
+	const uint8 TypeValue = (uint8)Type;
+
+	GizmoControlAppend(Out_Buffer, &TypeValue, sizeof(uint8));
+	GizmoControlAppend(Out_Buffer, &RequestId, sizeof(uint32));
+
+	return Offset;
+}
+
+static void GizmoControlEndMessage(TArray<uint8>& Out_Buffer, int32 Offset)
+{
+	const uint32 Size = (uint32)(Out_Buffer.Num() - Offset - FGizmoControlProtocol::SizeBytes);
+	FMemory::Memcpy(Out_Buffer.GetData() + Offset, &Size, sizeof(uint32));
+}
+
+static void GizmoControlAppendTransform(TArray<uint8>& Out_Buffer, const FTransform& Transform)
+{
+	const FVector Location = Transform.GetLocation();
+	const FQuat Rotation = Transform.GetRotation();
+	const FVector Scale = Transform.GetScale3D();
+	const double TransformData[10] = { Location.X, Location.Y, Location.Z, Rotation.X, Rotation.Y, Rotation.Z, Rotation.W, Scale.X, Scale.Y, Scale.Z };
+
+	GizmoControlAppend(Out_Buffer, TransformData, FGizmoControlProtocol::TransformBytes);
+}
+
+// Returns false for non finite values and zero rotations. Rotations are normalized, clients may send them with float precision.
+static bool GizmoControlReadTransform(const uint8* Data, FTransform& Out_Transform)
+{
+	double TransformData[10];
+	FMemory::Memcpy(TransformData, Data, FGizmoControlProtocol::TransformBytes);
+
+	for (const double EachValue : TransformData)
+	{
+		if (!FMath::IsFinite(EachValue))
+		{
+			return false;
+		}
+	}
+
+	FQuat Rotation(TransformData[3], TransformData[4], TransformData[5], TransformData[6]);
+
+	if (Rotation.SizeSquared() < UE_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	Rotation.Normalize();
+
+	Out_Transform = FTransform(Rotation, FVector(TransformData[0], TransformData[1], TransformData[2]), FVector(TransformData[7], TransformData[8], TransformData[9]));
+	return true;
+}
+
+void FGizmoControlProtocol::WriteResolve(TArray<uint8>& Out_Buffer, uint32 RequestId, const FString& Path)
+{
+	const int32 Offset = GizmoControlBeginMessage(Out_Buffer, EGizmoControlMessage::Resolve, RequestId);
+
+	const FTCHARToUTF8 PathUTF8(*Path);
+	const uint16 PathLength = (uint16)FMath::Min(PathUTF8.Length(), (int32)MAX_uint16);
+
+	GizmoControlAppend(Out_Buffer, &PathLength, sizeof(uint16));
+	GizmoControlAppend(Out_Buffer, PathUTF8.Get(), PathLength);
+
+	GizmoControlEndMessage(Out_Buffer, Offset);
+}
+
+void FGizmoControlProtocol::WriteTransforms(TArray<uint8>& Out_Buffer, EGizmoControlMessage Type, uint32 RequestId, TConstArrayView<uint32> Ids, TConstArrayView<FTransform> Transforms)
+{
+	const uint32 Count = (uint32)FMath::Min(Ids.Num(), Transforms.Num());
+	Out_Buffer.Reserve(Out_Buffer.Num() + SizeBytes + HeaderBytes + sizeof(uint32) + Count * (sizeof(uint32) + TransformBytes));
+
+	const int32 Offset = GizmoControlBeginMessage(Out_Buffer, Type, RequestId);
+	GizmoControlAppend(Out_Buffer, &Count, sizeof(uint32));
+
+	for (uint32 Index = 0; Index < Count; Index++)
+	{
+		GizmoControlAppend(Out_Buffer, &Ids[Index], sizeof(uint32));
+		GizmoControlAppendTransform(Out_Buffer, Transforms[Index]);
+	}
+
+	GizmoControlEndMessage(Out_Buffer, Offset);
+}
+
+void FGizmoControlProtocol::WriteSelect(TArray<uint8>& Out_Buffer, uint32 RequestId, TConstArrayView<uint32> Ids, bool bAppend)
+{
+	const int32 Offset = GizmoControlBeginMessage(Out_Buffer, EGizmoControlMessage::Select, RequestId);
+
+	const uint8 AppendValue = bAppend ? 1 : 0;
+	const uint32 Count = (uint32)Ids.Num();
+
+	GizmoControlAppend(Out_Buffer, &AppendValue, sizeof(uint8));
+	GizmoControlAppend(Out_Buffer, &Count, sizeof(uint32));
+	GizmoControlAppend(Out_Buffer, Ids.GetData(), Ids.Num() * sizeof(uint32));
+
+	GizmoControlEndMessage(Out_Buffer, Offset);
+}
+
+void FGizmoControlProtocol::WriteSetAxis(TArray<uint8>& Out_Buffer, uint32 RequestId, ESelectedAxis Axis)
+{
+	const int32 Offset = GizmoControlBeginMessage(Out_Buffer, EGizmoControlMessage::Set_Axis, RequestId);
+
+	const uint8 AxisValue = (uint8)Axis;
+	GizmoControlAppend(Out_Buffer, &AxisValue, sizeof(uint8));
+
+	GizmoControlEndMessage(Out_Buffer, Offset);
+}
+
+void FGizmoControlProtocol::WriteAck(TArray<uint8>& Out_Buffer, const FGizmoControlAck& Ack)
+{
+	const int32 Offset = GizmoControlBeginMessage(Out_Buffer, EGizmoControlMessage::Ack, Ack.RequestId);
+
+	const uint8 StatusValue = (uint8)Ack.Status;
+	GizmoControlAppend(Out_Buffer, &StatusValue, sizeof(uint8));
+	GizmoControlAppend(Out_Buffer, &Ack.Value, sizeof(uint32));
+
+	GizmoControlEndMessage(Out_Buffer, Offset);
+}
+
+bool FGizmoControlProtocol::ReadCommand(const uint8* Message, int32 MessageSize, FGizmoControlCommand& Out_Command)
+{
+	if (MessageSize < HeaderBytes)
+	{
+		return false;
+	}
+
+	Out_Command.Type = (EGizmoControlMessage)Message[0];
+	FMemory::Memcpy(&Out_Command.RequestId, Message + sizeof(uint8), sizeof(uint32));
+
+	const uint8* Payload = Message + HeaderBytes;
+	const int32 PayloadSize = MessageSize - HeaderBytes;
+
+	switch (Out_Command.Type)
+	{
+		case EGizmoControlMessage::Resolve:
+		{
+			uint16 PathLength = 0;
+
+			if (PayloadSize < (int32)sizeof(uint16))
+			{
+				return false;
+			}
+
+			FMemory::Memcpy(&PathLength, Payload, sizeof(uint16));
+
+			if (PayloadSize != (int32)sizeof(uint16) + PathLength)
+			{
+				return false;
+			}
+
+			Out_Command.Path = FString(FUTF8ToTCHAR((const ANSICHAR*)(Payload + sizeof(uint16)), PathLength));
+			return true;
+		}
+
+		case EGizmoControlMessage::Set_Transforms:
+		case EGizmoControlMessage::Apply_Deltas:
+		{
+			uint32 Count = 0;
+
+			if (PayloadSize < (int32)sizeof(uint32))
+			{
+				return false;
+			}
+
+			FMemory::Memcpy(&Count, Payload, sizeof(uint32));
+
+			constexpr int32 EntryBytes = sizeof(uint32) + TransformBytes;
+
+			if ((int64)PayloadSize != (int64)sizeof(uint32) + (int64)Count * EntryBytes)
+			{
+				return false;
+			}
+
+			Out_Command.Ids.SetNumUninitialized(Count);
+			Out_Command.Transforms.SetNumUninitialized(Count);
+
+			const uint8* Entry = Payload + sizeof(uint32);
+
+			for (uint32 Index = 0; Index < Count; Index++, Entry += EntryBytes)
+			{
+				FMemory::Memcpy(&Out_Command.Ids[Index], Entry, sizeof(uint32));
+
+				if (!GizmoControlReadTransform(Entry + sizeof(uint32), Out_Command.Transforms[Index]))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		case EGizmoControlMessage::Select:
+		{
+			uint32 Count = 0;
+
+			if (PayloadSize < (int32)(sizeof(uint8) + sizeof(uint32)))
+			{
+				return false;
+			}
+
+			Out_Command.bAppend = Payload[0] != 0;
+			FMemory::Memcpy(&Count, Payload + sizeof(uint8), sizeof(uint32));
+
+			if ((int64)PayloadSize != (int64)(sizeof(uint8) + sizeof(uint32)) + (int64)Count * sizeof(uint32))
+			{
+				return false;
+			}
+
+			Out_Command.Ids.SetNumUninitialized(Count);
+			FMemory::Memcpy(Out_Command.Ids.GetData(), Payload + sizeof(uint8) + sizeof(uint32), Count * sizeof(uint32));
+			return true;
+		}
+
+		case EGizmoControlMessage::Set_Axis:
+		{
+			if (PayloadSize != (int32)sizeof(uint8) || Payload[0] > (uint8)ESelectedAxis::XYZ_Axis)
+			{
+				return false;
+			}
+
+			Out_Command.Axis = (ESelectedAxis)Payload[0];
+			return true;
+		}
+
+		default:
+			// Unknown types still reach the game thread, so the client gets an ack for them.
+			return true;
+	}
+}
+
+bool FGizmoControlProtocol::ReadAck(const uint8* Message, int32 MessageSize, FGizmoControlAck& Out_Ack)
+{
+	if (MessageSize != HeaderBytes + sizeof(uint8) + sizeof(uint32) || Message[0] != (uint8)EGizmoControlMessage::Ack)
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(&Out_Ack.RequestId, Message + sizeof(uint8), sizeof(uint32));
+	Out_Ack.Status = (EGizmoControlStatus)Message[HeaderBytes];
+	FMemory::Memcpy(&Out_Ack.Value, Message + HeaderBytes + sizeof(uint8), sizeof(uint32));
+
+	return true;
+}
+
+FGizmoControlClient::~FGizmoControlClient()
+{
+	this->Close();
+}
+
+bool FGizmoControlClient::Connect(int32 Port)
+{
+	this->Close();
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+	if (!SocketSubsystem)
+	{
+		return false;
+	}
+
+	TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+	Address->SetIp(FIPv4Address(127, 0, 0, 1).Value);
+	Address->SetPort(Port);
+
+	this->Socket = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("GizmoControlClient"), false);
+
+	if (!this->Socket)
+	{
+		return false;
+	}
+
+	this->Socket->SetNoDelay(true);
+
+	if (!this->Socket->Connect(*Address))
+	{
+		this->Close();
+		return false;
+	}
+
+	return true;
+}
+
+void FGizmoControlClient::Close()
+{
+	if (!this->Socket)
+	{
+		return;
+	}
+
+	this->Socket->Close();
+	ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(this->Socket);
+
+	this->Socket = nullptr;
+	this->ReceiveBuffer.Reset();
+}
+
+bool FGizmoControlClient::IsConnected() const
+{
+	return this->Socket && this->Socket->GetConnectionState() == SCS_Connected;
+}
+
+bool FGizmoControlClient::Send(const TArray<uint8>& Buffer)
+{
+	int32 Offset = 0;
+
+	while (this->Socket && Offset < Buffer.Num())
+	{
+		int32 BytesSent = 0;
+
+		if (!this->Socket->Send(Buffer.GetData() + Offset, Buffer.Num() - Offset, BytesSent))
+		{
+			return false;
+		}
+
+		Offset += BytesSent;
+	}
+
+	return Offset == Buffer.Num();
+}
+
+int32 FGizmoControlClient::ReceiveAcks(TArray<FGizmoControlAck>& Out_Acks, int32 MinAcks, double TimeoutSeconds)
+{
+	const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+	int32 NumReceived = 0;
+
+	while (this->Socket && FPlatformTime::Seconds() < EndTime)
+	{
+		if (this->Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(1)))
+		{
+			uint32 PendingBytes = 0;
+
+			while (this->Socket->HasPendingData(PendingBytes) && PendingBytes > 0)
+			{
+				const int32 Offset = this->ReceiveBuffer.AddUninitialized(PendingBytes);
+				int32 BytesRead = 0;
+
+				this->Socket->Recv(this->ReceiveBuffer.GetData() + Offset, PendingBytes, BytesRead);
+				this->ReceiveBuffer.SetNum(Offset + BytesRead);
+			}
+		}
+
+		int32 Consumed = 0;
+
+		while (this->ReceiveBuffer.Num() - Consumed >= FGizmoControlProtocol::SizeBytes)
+		{
+			uint32 MessageSize = 0;
+			FMemory::Memcpy(&MessageSize, this->ReceiveBuffer.GetData() + Consumed, sizeof(uint32));
+
+			if (this->ReceiveBuffer.Num() - Consumed - FGizmoControlProtocol::SizeBytes < (int32)MessageSize)
+			{
+				break;
+			}
+
+			FGizmoControlAck Ack;
+
+			if (FGizmoControlProtocol::ReadAck(this->ReceiveBuffer.GetData() + Consumed + FGizmoControlProtocol::SizeBytes, MessageSize, Ack))
+			{
+				Out_Acks.Add(Ack);
+				NumReceived++;
+			}
+
+			Consumed += FGizmoControlProtocol::SizeBytes + MessageSize;
+		}
+
+		this->ReceiveBuffer.RemoveAt(0, Consumed);
+
+		if (NumReceived >= MinAcks)
+		{
+			break;
+		}
+	}
+
+	return NumReceived;
+}
@@ -0,0 +1,268 @@
+#include "Net/Gizmo_Control_Server.h"
+
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "Common/TcpSocketBuilder.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "HAL/RunnableThread.h"
+
+// Bytes read from a socket per Recv call.
+static constexpr int32 GizmoControlReceiveChunk = 64 * 1024;
+
+// Server thread sleeps this long when no socket had anything to do.
+static constexpr float GizmoControlIdleSleep = 0.001f;
+
+FGizmoControlServer::~FGizmoControlServer()
+{
+	if (this->Thread)
+	{
+		this->Thread->Kill(true);
+		delete this->Thread;
+		this->Thread = nullptr;
+	}
+
+	for (FClient& EachClient : this->Clients)
+	{
+		this->CloseClient(EachClient);
+	}
+
+	this->Clients.Empty();
+
+	if (this->ListenSocket)
+	{
+		this->ListenSocket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(this->ListenSocket);
+		this->ListenSocket = nullptr;
+	}
+}
+
+bool FGizmoControlServer::Start(int32 In_Port)
+{
+	if (this->ListenSocket)
+	{
+		return false;
+	}
+
+	// Loopback only. Anything on the machine may connect, nothing from outside it.
+	const FIPv4Endpoint Endpoint(FIPv4Address(127, 0, 0, 1), In_Port);
+	this->ListenSocket = FTcpSocketBuilder(TEXT("GizmoControl")).AsNonBlocking().AsReusable().BoundToEndpoint(Endpoint).Listening(8);
+
+	if (!this->ListenSocket)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Control : Port %d could not be opened."), In_Port);
+		return false;
+	}
+
+	this->Port = this->ListenSocket->GetPortNo();
+	this->Thread = FRunnableThread::Create(this, TEXT("GizmoControl"), 0, TPri_Normal);
+
+	UE_LOG(LogTemp, Display, TEXT("Gizmo Control : Listening on 127.0.0.1:%d"), this->Port);
+	return true;
+}
+
+bool FGizmoControlServer::IsListening() const
+{
+	return this->ListenSocket && this->Thread;
+}
+
+int32 FGizmoControlServer::GetPort() const
+{
+	return this->Port;
+}
+
+bool FGizmoControlServer::Dequeue(FGizmoControlCommand& Out_Command)
+{
+	return this->Commands.Dequeue(Out_Command);
+}
+
+void FGizmoControlServer::SendAck(const FGizmoControlAck& Ack)
+{
+	this->Acks.Enqueue(Ack);
+}
+
+uint32 FGizmoControlServer::Run()
+{
+	while (!this->bStopping)
+	{
+		this->AcceptClients();
+
+		bool bBusy = false;
+
+		for (int32 ClientIndex = this->Clients.Num() - 1; ClientIndex >= 0; ClientIndex--)
+		{
+			bool bReceived = false;
+
+			if (!this->ReceiveFrom(this->Clients[ClientIndex], bReceived))
+			{
+				this->CloseClient(this->Clients[ClientIndex]);
+				this->Clients.RemoveAtSwap(ClientIndex);
+				continue;
+			}
+
+			bBusy |= bReceived;
+		}
+
+		FGizmoControlAck Ack;
+
+		while (this->Acks.Dequeue(Ack))
+		{
+			// Acks of clients that disconnected meanwhile are dropped.
+			FClient* Client = this->Clients.FindByPredicate([&Ack](const FClient& EachClient) { return EachClient.Id == Ack.ClientId; });
+
+			if (Client)
+			{
+				FGizmoControlProtocol::WriteAck(Client->SendBuffer, Ack);
+			}
+
+			bBusy = true;
+		}
+
+		for (int32 ClientIndex = this->Clients.Num() - 1; ClientIndex >= 0; ClientIndex--)
+		{
+			if (!this->SendTo(this->Clients[ClientIndex]))
+			{
+				this->CloseClient(this->Clients[ClientIndex]);
+				this->Clients.RemoveAtSwap(ClientIndex);
+			}
+		}
+
+		if (!bBusy)
+		{
+			FPlatformProcess::Sleep(GizmoControlIdleSleep);
+		}
+	}
+
+	return 0;
+}
+
+void FGizmoControlServer::Stop()
+{
+	this->bStopping = true;
+}
+
+void FGizmoControlServer::AcceptClients()
+{
+	bool bHasPendingConnection = false;
+
+	while (this->ListenSocket->HasPendingConnection(bHasPendingConnection) && bHasPendingConnection)
+	{
+		FSocket* Socket = this->ListenSocket->Accept(TEXT("GizmoControlClient"));
+
+		if (!Socket)
+		{
+			break;
+		}
+
+		Socket->SetNonBlocking(true);
+		Socket->SetNoDelay(true);
+
+		FClient& Client = this->Clients.AddDefaulted_GetRef();
+		Client.Id = this->NextClientId++;
+		Client.Socket = Socket;
+	}
+}
+
+bool FGizmoControlServer::ReceiveFrom(FClient& Client, bool& Out_bReceived)
+{
+	Out_bReceived = false;
+
+	while (true)
+	{
+		const int32 Offset = Client.ReceiveBuffer.AddUninitialized(GizmoControlReceiveChunk);
+		int32 BytesRead = 0;
+
+		// False on a closed or broken stream, true with zero bytes when nothing is pending.
+		const bool bConnected = Client.Socket->Recv(Client.ReceiveBuffer.GetData() + Offset, GizmoControlReceiveChunk, BytesRead);
+		Client.ReceiveBuffer.SetNum(Offset + BytesRead, false);
+
+		if (!bConnected)
+		{
+			return false;
+		}
+
+		if (BytesRead == 0)
+		{
+			break;
+		}
+
+		Out_bReceived = true;
+	}
+
+	int32 Consumed = 0;
+
+	while (Client.ReceiveBuffer.Num() - Consumed >= FGizmoControlProtocol::SizeBytes)
+	{
+		uint32 MessageSize = 0;
+		FMemory::Memcpy(&MessageSize, Client.ReceiveBuffer.GetData() + Consumed, sizeof(uint32));
+
+		// The stream can not be resynchronized after a bad size, so the connection is dropped.
+		if (MessageSize < (uint32)FGizmoControlProtocol::HeaderBytes || MessageSize > FGizmoControlProtocol::MaxMessageBytes)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Gizmo Control : Client %u sent a message of %u bytes and is disconnected."), Client.Id, MessageSize);
+			return false;
+		}
+
+		if (Client.ReceiveBuffer.Num() - Consumed - FGizmoControlProtocol::SizeBytes < (int32)MessageSize)
+		{
+			break;
+		}
+
+		FGizmoControlCommand Command;
+		Command.ClientId = Client.Id;
+
+		if (FGizmoControlProtocol::ReadCommand(Client.ReceiveBuffer.GetData() + Consumed + FGizmoControlProtocol::SizeBytes, MessageSize, Command))
+		{
+			this->Commands.Enqueue(MoveTemp(Command));
+		}
+
+		else
+		{
+			FGizmoControlAck Ack;
+			Ack.ClientId = Client.Id;
+			Ack.RequestId = Command.RequestId;
+			Ack.Status = EGizmoControlStatus::Malformed;
+
+			FGizmoControlProtocol::WriteAck(Client.SendBuffer, Ack);
+		}
+
+		Consumed += FGizmoControlProtocol::SizeBytes + MessageSize;
+	}
+
+	if (Consumed > 0)
+	{
+		Client.ReceiveBuffer.RemoveAt(0, Consumed, false);
+	}
+
+	return true;
+}
+
+bool FGizmoControlServer::SendTo(FClient& Client)
+{
+	if (Client.SendBuffer.IsEmpty())
+	{
+		return true;
+	}
+
+	int32 BytesSent = 0;
+
+	// Non blocking, whatever does not fit in the socket buffer now goes out on a later pass.
+	if (!Client.Socket->Send(Client.SendBuffer.GetData(), Client.SendBuffer.Num(), BytesSent))
+	{
+		return Client.Socket->GetConnectionState() == SCS_Connected;
+	}
+
+	Client.SendBuffer.RemoveAt(0, BytesSent, false);
+	return true;
+}
+
+void FGizmoControlServer::CloseClient(FClient& Client)
+{
+	if (!Client.Socket)
+	{
+		return;
+	}
+
+	Client.Socket->Close();
+	ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Client.Socket);
+	Client.Socket = nullptr;
+}
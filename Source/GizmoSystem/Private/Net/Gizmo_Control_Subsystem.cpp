@@ -0,0 +1,295 @@
+#include "Net/Gizmo_Control_Subsystem.h"
+#include "Gizmo_Stats.h"
+#include "Math/Gizmo_Math_Base.h"
+
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarGizmoControlPort(
+	TEXT("Gizmo.Control.Port"),
+	0,
+	TEXT("Loopback port of the gizmo control channel, opened when a game world starts. 0 keeps it closed."));
+
+void UGizmoControlSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const int32 Port = CVarGizmoControlPort.GetValueOnGameThread();
+
+	if (Port > 0)
+	{
+		this->StartControlServer(Port);
+	}
+}
+
+void UGizmoControlSubsystem::Deinitialize()
+{
+	this->StopControlServer();
+
+	Super::Deinitialize();
+}
+
+bool UGizmoControlSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UGizmoControlSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGizmoControlSubsystem, STATGROUP_Tickables);
+}
+
+bool UGizmoControlSubsystem::StartControlServer(int32 Port)
+{
+	if (this->Server)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Control : Server is already listening on %d."), this->Server->GetPort());
+		return false;
+	}
+
+	TUniquePtr<FGizmoControlServer> NewServer = MakeUnique<FGizmoControlServer>();
+
+	if (!NewServer->Start(Port))
+	{
+		return false;
+	}
+
+	this->Server = MoveTemp(NewServer);
+	return true;
+}
+
+void UGizmoControlSubsystem::StopControlServer()
+{
+	// Destructor stops the thread and closes every socket.
+	this->Server.Reset();
+	this->Targets.Empty();
+	this->GizmoBase.Reset();
+}
+
+int32 UGizmoControlSubsystem::GetControlPort() const
+{
+	return this->Server ? this->Server->GetPort() : 0;
+}
+
+void UGizmoControlSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!this->Server)
+	{
+		return;
+	}
+
+	FGizmoControlCommand Command;
+
+	while (this->Server->Dequeue(Command))
+	{
+		this->PendingAcks.Add(this->Execute(Command));
+	}
+
+	this->FlushWrites();
+
+	// Acks go out after the writes, so a client that waits for one sees its transforms applied.
+	for (const FGizmoControlAck& EachAck : this->PendingAcks)
+	{
+		this->Server->SendAck(EachAck);
+	}
+
+	this->PendingAcks.Reset();
+}
+
+USceneComponent* UGizmoControlSubsystem::ResolvePath(const FString& Path) const
+{
+	UObject* Object = FindObject<UObject>(nullptr, *Path);
+
+	if (USceneComponent* Component = Cast<USceneComponent>(Object))
+	{
+		return Component;
+	}
+
+	if (AActor* Actor = Cast<AActor>(Object))
+	{
+		return Actor->GetRootComponent();
+	}
+
+	return nullptr;
+}
+
+AGizmoMathBase* UGizmoControlSubsystem::FindGizmoBase()
+{
+	if (this->GizmoBase.IsValid())
+	{
+		return this->GizmoBase.Get();
+	}
+
+	for (TActorIterator<AGizmoMathBase> It(this->GetWorld()); It; ++It)
+	{
+		this->GizmoBase = *It;
+		return *It;
+	}
+
+	return nullptr;
+}
+
+FTransform& UGizmoControlSubsystem::GetPendingTransform(USceneComponent* Target)
+{
+	if (const int32* Index = this->PendingIndices.Find(Target))
+	{
+		return this->PendingWrites[*Index].Value;
+	}
+
+	const int32 Index = this->PendingWrites.Emplace(Target, Target->GetComponentTransform());
+	this->PendingIndices.Add(Target, Index);
+
+	return this->PendingWrites[Index].Value;
+}
+
+FGizmoControlAck UGizmoControlSubsystem::Execute(const FGizmoControlCommand& Command)
+{
+	FGizmoControlAck Ack;
+	Ack.ClientId = Command.ClientId;
+	Ack.RequestId = Command.RequestId;
+
+	switch (Command.Type)
+	{
+		case EGizmoControlMessage::Resolve:
+		{
+			USceneComponent* Target = this->ResolvePath(Command.Path);
+
+			if (!IsValid(Target) || Target->GetWorld() != this->GetWorld())
+			{
+				Ack.Status = EGizmoControlStatus::Not_Found;
+				break;
+			}
+
+			this->Targets.Add(Target->GetUniqueID(), Target);
+			Ack.Value = Target->GetUniqueID();
+			break;
+		}
+
+		case EGizmoControlMessage::Set_Transforms:
+		case EGizmoControlMessage::Apply_Deltas:
+		{
+			const bool bDelta = Command.Type == EGizmoControlMessage::Apply_Deltas;
+
+			for (int32 Index_Target = 0; Index_Target < Command.Ids.Num(); Index_Target++)
+			{
+				USceneComponent* Target = this->Targets.FindRef(Command.Ids[Index_Target]).Get();
+
+				// Static and stationary components can not move in a running game.
+				if (!IsValid(Target) || Target->Mobility != EComponentMobility::Movable)
+				{
+					continue;
+				}
+
+				const FTransform& Value = Command.Transforms[Index_Target];
+				FTransform& Pending = this->GetPendingTransform(Target);
+
+				if (bDelta)
+				{
+					Pending = FTransform(Value.GetRotation() * Pending.GetRotation(), Pending.GetLocation() + Value.GetLocation(), Pending.GetScale3D() * Value.GetScale3D());
+				}
+
+				else
+				{
+					Pending = Value;
+				}
+
+				Ack.Value++;
+			}
+
+			Ack.Status = (int32)Ack.Value == Command.Ids.Num() ? EGizmoControlStatus::Ok : EGizmoControlStatus::Partial;
+			break;
+		}
+
+		case EGizmoControlMessage::Select:
+		{
+			AGizmoMathBase* Base = this->FindGizmoBase();
+
+			if (!Base)
+			{
+				Ack.Status = EGizmoControlStatus::No_Gizmo;
+				break;
+			}
+
+			this->SelectScratch.Reset();
+
+			for (const uint32 EachId : Command.Ids)
+			{
+				USceneComponent* Target = this->Targets.FindRef(EachId).Get();
+
+				if (IsValid(Target))
+				{
+					this->SelectScratch.Add(Target);
+				}
+			}
+
+			// Gizmo reads its targets' transforms, so writes queued before the selection land first.
+			this->FlushWrites();
+			Base->SetGizmoTargets(this->SelectScratch, Command.bAppend);
+
+			Ack.Value = this->SelectScratch.Num();
+			Ack.Status = (int32)Ack.Value == Command.Ids.Num() ? EGizmoControlStatus::Ok : EGizmoControlStatus::Partial;
+			break;
+		}
+
+		case EGizmoControlMessage::Set_Axis:
+		{
+			AGizmoMathBase* Base = this->FindGizmoBase();
+
+			if (!Base)
+			{
+				Ack.Status = EGizmoControlStatus::No_Gizmo;
+				break;
+			}
+
+			Base->SetSelectedAxis(Command.Axis);
+			Ack.Value = (uint32)Base->GetSelectedAxis();
+			break;
+		}
+
+		default:
+		{
+			Ack.Status = EGizmoControlStatus::Unknown_Message;
+			break;
+		}
+	}
+
+	return Ack;
+}
+
+void UGizmoControlSubsystem::FlushWrites()
+{
+	for (const TPair<USceneComponent*, FTransform>& EachWrite : this->PendingWrites)
+	{
+		// Ids are weak, but a target resolved earlier this tick may have been destroyed by a later command's side effects.
+		if (!IsValid(EachWrite.Key))
+		{
+			continue;
+		}
+
+		EachWrite.Key->SetWorldTransform(EachWrite.Value, false, nullptr, ETeleportType::TeleportPhysics);
+		INC_DWORD_STAT(STAT_Gizmo_TransformWrites);
+	}
+
+	// A drag re-applies its own start transforms every frame, so only an idle gizmo is moved.
+	AGizmoMathBase* Base = this->PendingWrites.IsEmpty() ? nullptr : this->FindGizmoBase();
+
+	if (IsValid(Base) && !Base->bIsDragging)
+	{
+		Base->GetAllTargets(this->GizmoTargetScratch);
+
+		for (USceneComponent* EachTarget : this->GizmoTargetScratch)
+		{
+			if (this->PendingIndices.Contains(EachTarget))
+			{
+				Base->SyncToAnchor();
+				break;
+			}
+		}
+	}
+
+	this->PendingWrites.Reset();
+	this->PendingIndices.Reset();
+}
@@ -0,0 +1,440 @@
+#include "Net/Gizmo_Net_Component.h"
+
+#include "Components/SceneComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/World.h"
+
+// Targets of one drag the server accepts. A longer list is treated as a malicious client.
+static constexpr int32 GizmoNetMaxTargets = 4096;
+
+// Bits per quaternion component sent by smallest three.
+static constexpr int32 GizmoNetRotationBits = 15;
+
+// The three smallest components of a unit quaternion are within this range.
+static constexpr double GizmoNetRotationRange = 0.70710678118654752;
+
+static FGizmoNetDelta GizmoToNetDelta(const FGizmoDragDelta& Delta)
+{
+	FGizmoNetDelta NetDelta;
+	NetDelta.Translation = Delta.Translation;
+	NetDelta.Rotation = Delta.Rotation;
+	NetDelta.ScaleRatio = Delta.ScaleRatio;
+
+	return NetDelta;
+}
+
+// Smallest three : index of the largest component, then the other three. The largest is rebuilt from unit length, so the result is always a valid rotation.
+static void GizmoSerializeRotation(FArchive& Ar, FQuat& Rotation)
+{
+	const uint32 MaxValue = (1u << GizmoNetRotationBits) - 1;
+
+	uint32 LargestIndex = 0;
+	uint32 Packed[3] = {};
+
+	if (Ar.IsSaving())
+	{
+		const FQuat Normalized = Rotation.GetNormalized();
+		const double Components[4] = { Normalized.X, Normalized.Y, Normalized.Z, Normalized.W };
+
+		for (int32 Index = 1; Index < 4; Index++)
+		{
+			if (FMath::Abs(Components[Index]) > FMath::Abs(Components[LargestIndex]))
+			{
+				LargestIndex = Index;
+			}
+		}
+
+		// Q and -Q are the same rotation. Flipping to a positive largest component means its sign does not have to be sent.
+		const double Sign = Components[LargestIndex] < 0 ? -1 : 1;
+		int32 PackedIndex = 0;
+
+		for (int32 Index = 0; Index < 4; Index++)
+		{
+			if (Index != LargestIndex)
+			{
+				const double Unit = FMath::Clamp(Components[Index] * Sign / GizmoNetRotationRange, -1.0, 1.0) * 0.5 + 0.5;
+				Packed[PackedIndex++] = (uint32)FMath::RoundToInt(Unit * MaxValue);
+			}
+		}
+	}
+
+	Ar.SerializeBits(&LargestIndex, 2);
+
+	for (uint32& EachPacked : Packed)
+	{
+		Ar.SerializeBits(&EachPacked, GizmoNetRotationBits);
+	}
+
+	if (Ar.IsLoading())
+	{
+		double Components[4] = {};
+		double SumSquared = 0;
+		int32 PackedIndex = 0;
+
+		for (int32 Index = 0; Index < 4; Index++)
+		{
+			if (Index != LargestIndex)
+			{
+				Components[Index] = ((double)FMath::Min(Packed[PackedIndex++], MaxValue) / MaxValue * 2 - 1) * GizmoNetRotationRange;
+				SumSquared += Components[Index] * Components[Index];
+			}
+		}
+
+		Components[LargestIndex] = FMath::Sqrt(FMath::Max(1 - SumSquared, 0.0));
+
+		Rotation = FQuat(Components[0], Components[1], Components[2], Components[3]);
+		Rotation.Normalize();
+	}
+}
+
+bool FGizmoNetDelta::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	enum : uint8
+	{
+		Has_Translation = 1 << 0,
+		Has_Rotation = 1 << 1,
+		Has_Scale = 1 << 2,
+	};
+
+	uint8 Flags = 0;
+
+	if (Ar.IsSaving())
+	{
+		Flags |= this->Translation.IsNearlyZero(0.005) ? 0 : Has_Translation;
+		Flags |= this->Rotation.Equals(FQuat::Identity, 1e-5) ? 0 : Has_Rotation;
+		Flags |= this->ScaleRatio.Equals(FVector::OneVector, 1e-4) ? 0 : Has_Scale;
+	}
+
+	Ar.SerializeBits(&Flags, 3);
+	bOutSuccess = true;
+
+	// 1/100 unit translation, smallest three rotation, 1/10000 scale ratio. A typical single-axis move is a few bytes.
+	if (Flags & Has_Translation)
+	{
+		bOutSuccess &= SerializePackedVector<100, 30>(this->Translation, Ar);
+	}
+
+	else if (Ar.IsLoading())
+	{
+		this->Translation = FVector::ZeroVector;
+	}
+
+	if (Flags & Has_Rotation)
+	{
+		GizmoSerializeRotation(Ar, this->Rotation);
+	}
+
+	else if (Ar.IsLoading())
+	{
+		this->Rotation = FQuat::Identity;
+	}
+
+	if (Flags & Has_Scale)
+	{
+		bOutSuccess &= SerializePackedVector<10000, 24>(this->ScaleRatio, Ar);
+	}
+
+	else if (Ar.IsLoading())
+	{
+		this->ScaleRatio = FVector::OneVector;
+	}
+
+	// Reading past the end of a truncated bunch only sets the error flag, the values read are garbage.
+	if (Ar.IsError())
+	{
+		bOutSuccess = false;
+		return false;
+	}
+
+	return true;
+}
+
+FGizmoNetDelta FGizmoNetDelta::Interpolate(const FGizmoNetDelta& From, const FGizmoNetDelta& To, float Alpha)
+{
+	FGizmoNetDelta Result;
+	Result.Translation = FMath::Lerp(From.Translation, To.Translation, Alpha);
+	Result.Rotation = FQuat::Slerp(From.Rotation, To.Rotation, Alpha);
+	Result.ScaleRatio = FMath::Lerp(From.ScaleRatio, To.ScaleRatio, Alpha);
+
+	return Result;
+}
+
+UGizmoNetComponent::UGizmoNetComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	SetIsReplicatedByDefault(true);
+}
+
+void UGizmoNetComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// Only the newest delta is sent, so a burst of frames costs one RPC.
+	if (this->bHasPendingDelta)
+	{
+		const double CurrentTime = this->GetWorld()->GetTimeSeconds();
+
+		if (this->SendRate <= 0 || CurrentTime - this->LastSendTime >= 1.0 / this->SendRate)
+		{
+			this->ServerUpdateDrag(this->Drag.DragId, this->PendingDelta);
+			this->bHasPendingDelta = false;
+			this->LastSendTime = CurrentTime;
+		}
+	}
+
+	if (this->Drag.bInterpolate)
+	{
+		const float Alpha = 1.f - FMath::Exp(-this->InterpolationSpeed * DeltaTime);
+
+		this->Drag.Current = FGizmoNetDelta::Interpolate(this->Drag.Current, this->Drag.Goal, Alpha);
+		this->ApplyDragState(this->Drag.Current);
+	}
+}
+
+void UGizmoNetComponent::BeginDrag(const TArray<USceneComponent*>& Targets, const FGizmoDragDelta& Delta)
+{
+	FGizmoNetDragSettings Settings;
+	Settings.Pivot = Delta.Pivot;
+	Settings.ScaleFrame = Delta.ScaleFrame;
+	Settings.bScaleAboutPivot = Delta.bScaleAboutPivot;
+	Settings.ScaleSnap = Delta.ScaleSnap;
+	Settings.MinScale = Delta.MinScale;
+
+	// Targets are still at their start transforms, kept in case the server rejects the drag.
+	this->NextDragId++;
+	this->StartDragState(this->NextDragId, Targets, Settings);
+	this->bHasPendingDelta = false;
+
+	this->ServerBeginDrag(this->Drag.DragId, Targets, Settings);
+}
+
+void UGizmoNetComponent::UpdateDrag(const FGizmoDragDelta& Delta)
+{
+	this->PendingDelta = GizmoToNetDelta(Delta);
+	this->bHasPendingDelta = true;
+}
+
+void UGizmoNetComponent::EndDrag()
+{
+	if (this->Drag.DragId == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Added first, a listen server confirms within ServerEndDrag.
+	this->UnconfirmedDrags.Add(this->Drag);
+	this->ServerEndDrag(this->Drag.DragId, this->PendingDelta);
+
+	this->Drag = FDragState();
+	this->bHasPendingDelta = false;
+}
+
+UGizmoNetComponent* UGizmoNetComponent::FindForController(const APlayerController* PlayerController)
+{
+	if (!IsValid(PlayerController) || !IsValid(PlayerController->PlayerState))
+	{
+		return nullptr;
+	}
+
+	return PlayerController->PlayerState->FindComponentByClass<UGizmoNetComponent>();
+}
+
+bool UGizmoNetComponent::IsLocallyOwned() const
+{
+	// Player states are owned by their controller, which only exists on the server and the owning client.
+	const AActor* Owner = this->GetOwner();
+	const AController* Controller = IsValid(Owner) ? Cast<AController>(Owner->GetOwner()) : nullptr;
+
+	return IsValid(Controller) && Controller->IsLocalController();
+}
+
+void UGizmoNetComponent::StartDragState(int32 DragId, const TArray<USceneComponent*>& Targets, const FGizmoNetDragSettings& Settings)
+{
+	this->Drag = FDragState();
+	this->Drag.DragId = DragId;
+	this->Drag.Targets.Reserve(Targets.Num());
+	this->Drag.StartTransforms.Reserve(Targets.Num());
+
+	for (USceneComponent* EachTarget : Targets)
+	{
+		if (IsValid(EachTarget))
+		{
+			this->Drag.Targets.Add(EachTarget);
+			this->Drag.StartTransforms.Add(EachTarget->GetComponentTransform());
+		}
+	}
+
+	this->Drag.Settings.Pivot = Settings.Pivot;
+	this->Drag.Settings.ScaleFrame = Settings.ScaleFrame;
+	this->Drag.Settings.bScaleAboutPivot = Settings.bScaleAboutPivot;
+	this->Drag.Settings.ScaleSnap = Settings.ScaleSnap;
+	this->Drag.Settings.MinScale = Settings.MinScale;
+}
+
+void UGizmoNetComponent::ApplyDragState(const FGizmoNetDelta& Delta)
+{
+	FGizmoDragDelta DragDelta = this->Drag.Settings;
+	DragDelta.Translation = Delta.Translation;
+	DragDelta.Rotation = Delta.Rotation;
+	DragDelta.ScaleRatio = Delta.ScaleRatio;
+
+	for (int32 TargetIndex = 0; TargetIndex < this->Drag.Targets.Num(); TargetIndex++)
+	{
+		USceneComponent* EachTarget = this->Drag.Targets[TargetIndex].Get();
+
+		if (!IsValid(EachTarget))
+		{
+			continue;
+		}
+
+		const FTransform NewTransform = DragDelta.Apply(this->Drag.StartTransforms[TargetIndex]);
+
+		if (!NewTransform.Equals(EachTarget->GetComponentTransform()))
+		{
+			EachTarget->SetWorldTransform(NewTransform, false, nullptr, ETeleportType::None);
+		}
+	}
+}
+
+bool UGizmoNetComponent::CanDragTarget(const USceneComponent* Target) const
+{
+	if (!IsValid(Target) || Target->GetWorld() != this->GetWorld() || Target->Mobility != EComponentMobility::Movable)
+	{
+		return false;
+	}
+
+	// Other clients have to be able to resolve the target from the multicast.
+	const AActor* TargetOwner = Target->GetOwner();
+
+	if (!IsValid(TargetOwner) || !Target->IsSupportedForNetworking())
+	{
+		return false;
+	}
+
+	// Actors owned by another player are theirs to edit.
+	const APlayerController* TargetPlayer = Cast<APlayerController>(TargetOwner->GetNetOwner());
+	const AActor* Owner = this->GetOwner();
+
+	return !TargetPlayer || (IsValid(Owner) && TargetPlayer == Owner->GetOwner());
+}
+
+bool UGizmoNetComponent::ServerBeginDrag_Validate(int32 DragId, const TArray<USceneComponent*>& Targets, const FGizmoNetDragSettings& Settings)
+{
+	return Targets.Num() <= GizmoNetMaxTargets && !Settings.Pivot.ContainsNaN() && !Settings.ScaleFrame.ContainsNaN() && FMath::IsFinite(Settings.ScaleSnap) && FMath::IsFinite(Settings.MinScale);
+}
+
+void UGizmoNetComponent::ServerBeginDrag_Implementation(int32 DragId, const TArray<USceneComponent*>& Targets, const FGizmoNetDragSettings& Settings)
+{
+	TArray<USceneComponent*> AcceptedTargets;
+	AcceptedTargets.Reserve(Targets.Num());
+
+	for (USceneComponent* EachTarget : Targets)
+	{
+		if (this->CanDragTarget(EachTarget))
+		{
+			AcceptedTargets.Add(EachTarget);
+		}
+	}
+
+	if (AcceptedTargets.Num() < Targets.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Gizmo Net : Drag %d of %s refused %d of %d targets."), DragId, *GetNameSafe(this->GetOwner()), Targets.Num() - AcceptedTargets.Num(), Targets.Num());
+	}
+
+	this->StartDragState(DragId, AcceptedTargets, Settings);
+	this->MulticastBeginDrag(DragId, AcceptedTargets, Settings);
+}
+
+void UGizmoNetComponent::ServerUpdateDrag_Implementation(int32 DragId, const FGizmoNetDelta& Delta)
+{
+	// Late packets of an older drag.
+	if (DragId != this->Drag.DragId)
+	{
+		return;
+	}
+
+	this->ApplyDragState(Delta);
+	this->MulticastUpdateDrag(DragId, Delta);
+}
+
+void UGizmoNetComponent::ServerEndDrag_Implementation(int32 DragId, const FGizmoNetDelta& Delta)
+{
+	const bool bAccepted = DragId == this->Drag.DragId;
+
+	if (bAccepted)
+	{
+		this->ApplyDragState(Delta);
+		this->MulticastEndDrag(DragId, Delta);
+		this->Drag = FDragState();
+	}
+
+	this->ClientConfirmDrag(DragId, bAccepted);
+}
+
+void UGizmoNetComponent::ClientConfirmDrag_Implementation(int32 DragId, bool bAccepted)
+{
+	const int32 DragIndex = this->UnconfirmedDrags.IndexOfByPredicate([DragId](const FDragState& EachDrag)
+	{
+		return EachDrag.DragId == DragId;
+	});
+
+	if (DragIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FDragState Released = MoveTemp(this->UnconfirmedDrags[DragIndex]);
+	this->UnconfirmedDrags.RemoveAt(DragIndex);
+
+	if (bAccepted)
+	{
+		return;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("Gizmo Net : Server rejected drag %d, its targets are put back."), DragId);
+
+	// Server never applied the drag, so the targets go back to where the server and other clients still have them.
+	for (int32 TargetIndex = 0; TargetIndex < Released.Targets.Num(); TargetIndex++)
+	{
+		USceneComponent* EachTarget = Released.Targets[TargetIndex].Get();
+
+		if (IsValid(EachTarget))
+		{
+			EachTarget->SetWorldTransform(Released.StartTransforms[TargetIndex], false, nullptr, ETeleportType::TeleportPhysics);
+		}
+	}
+}
+
+void UGizmoNetComponent::MulticastBeginDrag_Implementation(int32 DragId, const TArray<USceneComponent*>& Targets, const FGizmoNetDragSettings& Settings)
+{
+	// Server already applies, the dragging client already moved its targets locally.
+	if (this->GetOwnerRole() == ROLE_Authority || this->IsLocallyOwned())
+	{
+		return;
+	}
+
+	this->StartDragState(DragId, Targets, Settings);
+}
+
+void UGizmoNetComponent::MulticastUpdateDrag_Implementation(int32 DragId, const FGizmoNetDelta& Delta)
+{
+	if (this->GetOwnerRole() == ROLE_Authority || this->IsLocallyOwned() || DragId != this->Drag.DragId)
+	{
+		return;
+	}
+
+	this->Drag.Goal = Delta;
+	this->Drag.bInterpolate = true;
+}
+
+void UGizmoNetComponent::MulticastEndDrag_Implementation(int32 DragId, const FGizmoNetDelta& Delta)
+{
+	if (this->GetOwnerRole() == ROLE_Authority || this->IsLocallyOwned() || DragId != this->Drag.DragId)
+	{
+		return;
+	}
+
+	this->ApplyDragState(Delta);
+	this->Drag = FDragState();
+}
@@ -0,0 +1,118 @@
+#include "Render/Gizmo_Late_Latch.h"
+#include "Input/Gizmo_Input_Processor.h"
+#include "Gizmo_Stats.h"
+
+#include "Components/SceneComponent.h"
+#include "RenderingThread.h"
+#include "SceneView.h"
+
+FGizmoLateLatchExtension::FGizmoLateLatchExtension(const FAutoRegister& AutoRegister, TSharedPtr<FGizmoInputProcessor> In_InputProcessor) : FSceneViewExtensionBase(AutoRegister), InputProcessor(In_InputProcessor)
+{
+
+}
+
+void FGizmoLateLatchExtension::SetParams(USceneComponent* In_GizmoRoot, const FGizmoLateLatchParams& In_Params)
+{
+	check(IsInGameThread());
+
+	this->GizmoRoot = In_GizmoRoot;
+	this->GameThreadParams = In_Params;
+}
+
+void FGizmoLateLatchExtension::SetupViewFamily(FSceneViewFamily& InViewFamily)
+{
+
+}
+
+void FGizmoLateLatchExtension::SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView)
+{
+
+}
+
+void FGizmoLateLatchExtension::BeginRenderViewFamily(FSceneViewFamily& InViewFamily)
+{
+	USceneComponent* Root = this->GizmoRoot.Get();
+	const bool bIsActive = this->GameThreadParams.bIsActive && IsValid(Root);
+
+	// Gathers the gizmo primitives on the game thread, the render thread only moves them.
+	this->LateUpdate.Setup(FTransform::Identity, Root, !bIsActive);
+
+	FGizmoLateLatchParams Params = this->GameThreadParams;
+	Params.bIsActive = bIsActive;
+	Params.Scene = bIsActive ? Root->GetWorld()->Scene : nullptr;
+
+	// Keeps the extension alive until the command ran, even if the gizmo is destroyed meanwhile.
+	TSharedRef<FGizmoLateLatchExtension, ESPMode::ThreadSafe> Self = StaticCastSharedRef<FGizmoLateLatchExtension>(this->AsShared());
+
+	ENQUEUE_RENDER_COMMAND(GizmoLateLatchParams)([Self, Params](FRHICommandListImmediate& RHICmdList)
+	{
+		Self->RenderThreadParams = Params;
+	});
+}
+
+void FGizmoLateLatchExtension::PreRenderViewFamily_RenderThread(FRDGBuilder& GraphBuilder, FSceneViewFamily& InViewFamily)
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_LateLatch);
+
+	const FGizmoLateLatchParams& Params = this->RenderThreadParams;
+
+	if (!Params.bIsActive || !Params.Scene || InViewFamily.Views.IsEmpty() || !InViewFamily.Views[0])
+	{
+		return;
+	}
+
+	FVector2D MousePosition = Params.MousePosition;
+	FVector2D LatestScreenPosition;
+	const TSharedPtr<FGizmoInputProcessor> Processor = this->InputProcessor.Pin();
+
+	if (Processor.IsValid() && Processor->GetLatestScreenPosition(LatestScreenPosition))
+	{
+		MousePosition = LatestScreenPosition + Params.ScreenToViewport;
+	}
+
+	// Matrices of the frame being drawn, not the ones the game thread used.
+	const FSceneView* View = InViewFamily.Views[0];
+
+	FGizmoViewState LateView;
+	LateView.ViewRect = View->UnscaledViewRect;
+	LateView.ViewProjectionMatrix = View->ViewMatrices.GetViewProjectionMatrix();
+	LateView.InvViewProjectionMatrix = View->ViewMatrices.GetInvViewProjectionMatrix();
+	LateView.ViewOrigin = View->ViewMatrices.GetViewOrigin();
+	LateView.ViewDirection = View->GetViewDirection();
+	LateView.bIsValid = true;
+
+	FVector Offset = FVector::ZeroVector;
+
+	if (Params.bUseScreenAxis)
+	{
+		if (!Params.ScreenAxis.bIsValid)
+		{
+			return;
+		}
+
+		Offset = Params.ScreenAxis.WorldAxis * Params.ScreenAxis.ToWorldDistance(MousePosition - Params.GrabMousePosition);
+	}
+
+	else
+	{
+		FVector Point;
+
+		if (!Params.Constraint.Solve(LateView, MousePosition, Point))
+		{
+			return;
+		}
+
+		Offset = Point - Params.GrabPoint;
+	}
+
+	FTransform LateTransform = Params.CommittedTransform;
+	LateTransform.SetLocation(Params.GrabGizmoLocation + Offset);
+
+	this->LateUpdate.Apply_RenderThread(Params.Scene, Params.CommittedTransform, LateTransform);
+}
+
+bool FGizmoLateLatchExtension::IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const
+{
+	const USceneComponent* Root = this->GizmoRoot.Get();
+	return this->GameThreadParams.bIsActive && IsValid(Root) && Context.GetWorld() == Root->GetWorld();
+}
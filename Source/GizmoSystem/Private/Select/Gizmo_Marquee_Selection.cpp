@@ -0,0 +1,347 @@
+#include "Select/Gizmo_Marquee_Selection.h"
+#include "Gizmo_Stats.h"
+#include "Math/Gizmo_Math_Solver.h"
+#include "Trace/CustomCollision.h"
+
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Components/StaticMeshComponent.h"
+#include "StaticMeshResources.h"
+#include "Math/VectorRegister.h"
+
+// Smallest rectangle side in pixels. A click without a drag still gets a valid frustum.
+static constexpr double GizmoMarqueeMinSize = 1;
+
+// True when every point is on the outer side of Plane, so the shape they span can not touch the frustum.
+static bool GizmoAllOutside(TConstArrayView<FVector> Points, const FPlane& Plane)
+{
+	for (const FVector& EachPoint : Points)
+	{
+		if (Plane.PlaneDot(EachPoint) <= 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FGizmoMarqueeSelection::Gather(const UWorld* World, const FVector& In_Origin, TFunctionRef<bool(const UPrimitiveComponent*)> Filter)
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_MarqueeGather);
+
+	this->Reset();
+
+	if (!World)
+	{
+		return;
+	}
+
+	this->Origin = In_Origin;
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		const AActor* Actor = *It;
+
+		if (Actor->IsHidden())
+		{
+			continue;
+		}
+
+		for (UActorComponent* EachComponent : Actor->GetComponents())
+		{
+			UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(EachComponent);
+
+			if (!Primitive || !Primitive->IsRegistered() || !Primitive->IsVisible() || !Filter(Primitive))
+			{
+				continue;
+			}
+
+			// Cached by the component on every transform update, nothing is recalculated here.
+			const FVector Center = Primitive->Bounds.Origin - this->Origin;
+			const FVector Extent = Primitive->Bounds.BoxExtent;
+
+			this->CenterX.Add(static_cast<float>(Center.X));
+			this->CenterY.Add(static_cast<float>(Center.Y));
+			this->CenterZ.Add(static_cast<float>(Center.Z));
+			this->ExtentX.Add(static_cast<float>(Extent.X));
+			this->ExtentY.Add(static_cast<float>(Extent.Y));
+			this->ExtentZ.Add(static_cast<float>(Extent.Z));
+			this->Components.Add(Primitive);
+		}
+	}
+
+	this->NumBounds = this->Components.Num();
+
+	const int32 NumPadded = Align(this->NumBounds, 4);
+
+	this->CenterX.SetNumZeroed(NumPadded);
+	this->CenterY.SetNumZeroed(NumPadded);
+	this->CenterZ.SetNumZeroed(NumPadded);
+	this->ExtentX.SetNumZeroed(NumPadded);
+	this->ExtentY.SetNumZeroed(NumPadded);
+	this->ExtentZ.SetNumZeroed(NumPadded);
+}
+
+void FGizmoMarqueeSelection::Reset()
+{
+	this->CenterX.Reset();
+	this->CenterY.Reset();
+	this->CenterZ.Reset();
+	this->ExtentX.Reset();
+	this->ExtentY.Reset();
+	this->ExtentZ.Reset();
+	this->Components.Reset();
+	this->Origin = FVector::ZeroVector;
+	this->NumBounds = 0;
+}
+
+bool FGizmoMarqueeSelection::IsEmpty() const
+{
+	return this->NumBounds == 0;
+}
+
+int32 FGizmoMarqueeSelection::Num() const
+{
+	return this->NumBounds;
+}
+
+bool FGizmoMarqueeSelection::BuildFrustum(const FGizmoViewState& View, const FVector2D& Start, const FVector2D& End, TArray<FPlane, TInlineAllocator<6>>& Out_Planes)
+{
+	Out_Planes.Reset();
+
+	const FVector2D Min(FMath::Min(Start.X, End.X), FMath::Min(Start.Y, End.Y));
+	const FVector2D Max(FMath::Max(FMath::Max(Start.X, End.X), Min.X + GizmoMarqueeMinSize), FMath::Max(FMath::Max(Start.Y, End.Y), Min.Y + GizmoMarqueeMinSize));
+
+	// Clockwise on screen, so consecutive corners span one side plane each.
+	const FVector2D Corners[4] = { Min, FVector2D(Max.X, Min.Y), Max, FVector2D(Min.X, Max.Y) };
+
+	FVector Origins[4];
+	FVector Directions[4];
+	FVector CenterOrigin;
+	FVector CenterDirection;
+
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		if (!View.DeprojectScreenToWorld(Corners[Index], Origins[Index], Directions[Index]))
+		{
+			return false;
+		}
+	}
+
+	if (!View.DeprojectScreenToWorld((Min + Max) * 0.5, CenterOrigin, CenterDirection))
+	{
+		return false;
+	}
+
+	// Ray origins are on the near plane. Works for perspective and orthographic views alike.
+	const FVector Inside = CenterOrigin + CenterDirection * 100;
+
+	Out_Planes.Add(FPlane(CenterOrigin, -View.ViewDirection));
+
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		const int32 Next = (Index + 1) % 4;
+		FPlane Plane(Origins[Index], Origins[Next], Origins[Index] + Directions[Index] * 1000);
+
+		if (Plane.PlaneDot(Inside) > 0)
+		{
+			Plane = Plane.Flip();
+		}
+
+		Out_Planes.Add(Plane);
+	}
+
+	return true;
+}
+
+int32 FGizmoMarqueeSelection::Select(const FGizmoViewState& View, const FVector2D& Start, const FVector2D& End, bool bRefine, TArray<UPrimitiveComponent*>& Out_Components) const
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_MarqueeSelect);
+
+	Out_Components.Reset();
+
+	TArray<FPlane, TInlineAllocator<6>> Planes;
+
+	if (this->NumBounds == 0 || !BuildFrustum(View, Start, End, Planes))
+	{
+		return 0;
+	}
+
+	// Planes rebased to the gather origin and splatted once.
+	struct FPlaneRegisters
+	{
+		VectorRegister4Float NX;
+		VectorRegister4Float NY;
+		VectorRegister4Float NZ;
+		VectorRegister4Float AbsNX;
+		VectorRegister4Float AbsNY;
+		VectorRegister4Float AbsNZ;
+		VectorRegister4Float W;
+	};
+
+	TArray<FPlaneRegisters, TInlineAllocator<6>> Registers;
+
+	for (const FPlane& EachPlane : Planes)
+	{
+		const FVector Normal = EachPlane.GetNormal();
+		const float W = static_cast<float>(EachPlane.W - FVector::DotProduct(Normal, this->Origin));
+
+		FPlaneRegisters& Register = Registers.AddDefaulted_GetRef();
+		Register.NX = VectorSetFloat1(static_cast<float>(Normal.X));
+		Register.NY = VectorSetFloat1(static_cast<float>(Normal.Y));
+		Register.NZ = VectorSetFloat1(static_cast<float>(Normal.Z));
+		Register.AbsNX = VectorSetFloat1(static_cast<float>(FMath::Abs(Normal.X)));
+		Register.AbsNY = VectorSetFloat1(static_cast<float>(FMath::Abs(Normal.Y)));
+		Register.AbsNZ = VectorSetFloat1(static_cast<float>(FMath::Abs(Normal.Z)));
+		Register.W = VectorSetFloat1(W);
+	}
+
+	const VectorRegister4Float Zero = VectorZeroFloat();
+
+	for (int32 Index = 0; Index < this->NumBounds; Index += 4)
+	{
+		const VectorRegister4Float CX = VectorLoadAligned(&this->CenterX[Index]);
+		const VectorRegister4Float CY = VectorLoadAligned(&this->CenterY[Index]);
+		const VectorRegister4Float CZ = VectorLoadAligned(&this->CenterZ[Index]);
+		const VectorRegister4Float EX = VectorLoadAligned(&this->ExtentX[Index]);
+		const VectorRegister4Float EY = VectorLoadAligned(&this->ExtentY[Index]);
+		const VectorRegister4Float EZ = VectorLoadAligned(&this->ExtentZ[Index]);
+
+		// Outside: fully beyond one plane. Crossing: some part beyond at least one plane.
+		VectorRegister4Float Outside = Zero;
+		VectorRegister4Float Crossing = Zero;
+
+		for (const FPlaneRegisters& EachPlane : Registers)
+		{
+			const VectorRegister4Float Distance = VectorSubtract(VectorMultiplyAdd(EachPlane.NX, CX, VectorMultiplyAdd(EachPlane.NY, CY, VectorMultiply(EachPlane.NZ, CZ))), EachPlane.W);
+			const VectorRegister4Float Radius = VectorMultiplyAdd(EachPlane.AbsNX, EX, VectorMultiplyAdd(EachPlane.AbsNY, EY, VectorMultiply(EachPlane.AbsNZ, EZ)));
+
+			Outside = VectorBitwiseOr(Outside, VectorCompareGT(Distance, Radius));
+			Crossing = VectorBitwiseOr(Crossing, VectorCompareGT(VectorAdd(Distance, Radius), Zero));
+		}
+
+		const int32 OutsideBits = VectorMaskBits(Outside);
+
+		if (OutsideBits == 0xF)
+		{
+			continue;
+		}
+
+		const int32 CrossingBits = VectorMaskBits(Crossing);
+		const int32 NumLanes = FMath::Min(4, this->NumBounds - Index);
+
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			if (OutsideBits & (1 << Lane))
+			{
+				continue;
+			}
+
+			UPrimitiveComponent* Component = this->Components[Index + Lane].Get();
+
+			if (!Component)
+			{
+				continue;
+			}
+
+			// Boxes fully inside need no refinement.
+			if (bRefine && (CrossingBits & (1 << Lane)) && !this->Refine(Component, Planes))
+			{
+				continue;
+			}
+
+			Out_Components.Add(Component);
+		}
+	}
+
+	return Out_Components.Num();
+}
+
+bool FGizmoMarqueeSelection::Refine(const UPrimitiveComponent* Component, TConstArrayView<FPlane> Planes) const
+{
+	const FTransform& Transform = Component->GetComponentTransform();
+
+	// Hull corners in world space. Rejected only when all of them are beyond the same plane.
+	if (const UCustomCollision* Collision = Cast<UCustomCollision>(Component))
+	{
+		TArray<FVector, TInlineAllocator<16>> Corners;
+
+		for (const FVector& EachCorner : Collision->Corners)
+		{
+			Corners.Add(Transform.TransformPosition(EachCorner));
+		}
+
+		for (const FPlane& EachPlane : Planes)
+		{
+			if (GizmoAllOutside(Corners, EachPlane))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component);
+	const UStaticMesh* Mesh = MeshComponent ? MeshComponent->GetStaticMesh() : nullptr;
+	const FStaticMeshRenderData* RenderData = Mesh ? Mesh->GetRenderData() : nullptr;
+
+	// Other primitives and meshes without CPU side data keep the box result.
+	if (!RenderData || RenderData->LODResources.Num() == 0)
+	{
+		return true;
+	}
+
+	const FStaticMeshLODResources& LOD = RenderData->LODResources[0];
+	const FPositionVertexBuffer& Positions = LOD.VertexBuffers.PositionVertexBuffer;
+	const FIndexArrayView Indices = LOD.IndexBuffer.GetArrayView();
+
+	if (!Positions.GetVertexData() || Indices.Num() == 0)
+	{
+		return true;
+	}
+
+	// Planes moved into mesh space once, instead of every vertex into world space.
+	const FVector AxisX = Transform.TransformVector(FVector::XAxisVector);
+	const FVector AxisY = Transform.TransformVector(FVector::YAxisVector);
+	const FVector AxisZ = Transform.TransformVector(FVector::ZAxisVector);
+
+	TArray<FPlane, TInlineAllocator<6>> LocalPlanes;
+
+	for (const FPlane& EachPlane : Planes)
+	{
+		const FVector Normal = EachPlane.GetNormal();
+		LocalPlanes.Add(FPlane(FVector(FVector::DotProduct(Normal, AxisX), FVector::DotProduct(Normal, AxisY), FVector::DotProduct(Normal, AxisZ)), EachPlane.W - FVector::DotProduct(Normal, Transform.GetLocation())));
+	}
+
+	// First triangle that no single plane rejects selects the mesh.
+	for (int32 Index = 0; Index + 2 < Indices.Num(); Index += 3)
+	{
+		const FVector Triangle[3] =
+		{
+			FVector(Positions.VertexPosition(Indices[Index])),
+			FVector(Positions.VertexPosition(Indices[Index + 1])),
+			FVector(Positions.VertexPosition(Indices[Index + 2]))
+		};
+
+		bool bRejected = false;
+
+		for (const FPlane& EachPlane : LocalPlanes)
+		{
+			if (GizmoAllOutside(Triangle, EachPlane))
+			{
+				bRejected = true;
+				break;
+			}
+		}
+
+		if (!bRejected)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
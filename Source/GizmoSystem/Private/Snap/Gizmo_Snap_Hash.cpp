@@ -0,0 +1,330 @@
+#include "Snap/Gizmo_Snap_Hash.h"
+
+#include "Math/Gizmo_Math_Solver.h"
+
+// Cells per block edge as a power of two. 8 x 8 x 8 cells share one entry of the coarse grid.
+static constexpr int32 GizmoSnapBlockShift = 3;
+
+static FIntVector GizmoSnapToBlock(const FIntVector& Cell)
+{
+	// Arithmetic shift floors negative cells too.
+	return FIntVector(Cell.X >> GizmoSnapBlockShift, Cell.Y >> GizmoSnapBlockShift, Cell.Z >> GizmoSnapBlockShift);
+}
+
+FGizmoSnapHash::FGizmoSnapHash(double InCellSize)
+{
+	this->CellSize = FMath::Max(InCellSize, 1.0);
+	this->InvCellSize = 1.0 / this->CellSize;
+}
+
+FIntVector FGizmoSnapHash::ToCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt32(Location.X * this->InvCellSize), FMath::FloorToInt32(Location.Y * this->InvCellSize), FMath::FloorToInt32(Location.Z * this->InvCellSize));
+}
+
+void FGizmoSnapHash::Write(TFunctionRef<void(FBuffer&)> Update)
+{
+	FScopeLock WriteScope(&this->WriteMutex);
+
+	const int32 BackIndex = 1 - this->ReadIndex.load();
+
+	{
+		FWriteScopeLock WriteLock(this->Buffers[BackIndex].Lock);
+		Update(this->Buffers[BackIndex]);
+	}
+
+	// Queries move to the updated buffer, the previous one catches up behind them.
+	this->ReadIndex = BackIndex;
+
+	FWriteScopeLock WriteLock(this->Buffers[1 - BackIndex].Lock);
+	Update(this->Buffers[1 - BackIndex]);
+}
+
+void FGizmoSnapHash::AddEntries(FBuffer& Buffer, const FIntVector& Cell, TConstArrayView<FEntry> Entries)
+{
+	TArray<FEntry>& CellEntries = Buffer.Cells.FindOrAdd(Cell);
+
+	if (CellEntries.IsEmpty())
+	{
+		Buffer.Blocks.FindOrAdd(GizmoSnapToBlock(Cell))++;
+
+		Buffer.OccupiedMin = FIntVector(FMath::Min(Buffer.OccupiedMin.X, Cell.X), FMath::Min(Buffer.OccupiedMin.Y, Cell.Y), FMath::Min(Buffer.OccupiedMin.Z, Cell.Z));
+		Buffer.OccupiedMax = FIntVector(FMath::Max(Buffer.OccupiedMax.X, Cell.X), FMath::Max(Buffer.OccupiedMax.Y, Cell.Y), FMath::Max(Buffer.OccupiedMax.Z, Cell.Z));
+	}
+
+	CellEntries.Append(Entries.GetData(), Entries.Num());
+	Buffer.NumPoints += Entries.Num();
+}
+
+void FGizmoSnapHash::SetSource(uint32 SourceId, TConstArrayView<FVector> Points)
+{
+	TMap<FIntVector, TArray<FEntry>> Buckets;
+
+	for (const FVector& EachPoint : Points)
+	{
+		Buckets.FindOrAdd(this->ToCell(EachPoint)).Add({ EachPoint, SourceId });
+	}
+
+	this->Write([SourceId, &Buckets](FBuffer& Buffer)
+		{
+			FGizmoSnapHash::RemoveSourceLocked(Buffer, SourceId);
+
+			if (Buckets.IsEmpty())
+			{
+				return;
+			}
+
+			TArray<FIntVector>& TouchedCells = Buffer.SourceCells.Add(SourceId);
+			TouchedCells.Reserve(Buckets.Num());
+
+			for (const TPair<FIntVector, TArray<FEntry>>& EachBucket : Buckets)
+			{
+				FGizmoSnapHash::AddEntries(Buffer, EachBucket.Key, EachBucket.Value);
+				TouchedCells.Add(EachBucket.Key);
+			}
+		});
+}
+
+void FGizmoSnapHash::RemoveSource(uint32 SourceId)
+{
+	this->Write([SourceId](FBuffer& Buffer)
+		{
+			FGizmoSnapHash::RemoveSourceLocked(Buffer, SourceId);
+		});
+}
+
+void FGizmoSnapHash::RemoveSourceLocked(FBuffer& Buffer, uint32 SourceId)
+{
+	TArray<FIntVector> TouchedCells;
+
+	if (!Buffer.SourceCells.RemoveAndCopyValue(SourceId, TouchedCells))
+	{
+		return;
+	}
+
+	for (const FIntVector& EachCell : TouchedCells)
+	{
+		TArray<FEntry>* Entries = Buffer.Cells.Find(EachCell);
+
+		if (!Entries)
+		{
+			continue;
+		}
+
+		Buffer.NumPoints -= Entries->RemoveAllSwap([SourceId](const FEntry& EachEntry)
+			{
+				return EachEntry.SourceId == SourceId;
+			});
+
+		if (!Entries->IsEmpty())
+		{
+			continue;
+		}
+
+		Buffer.Cells.Remove(EachCell);
+
+		const FIntVector Block = GizmoSnapToBlock(EachCell);
+		int32* NumBlockCells = Buffer.Blocks.Find(Block);
+
+		if (NumBlockCells && --(*NumBlockCells) <= 0)
+		{
+			Buffer.Blocks.Remove(Block);
+		}
+	}
+
+	if (Buffer.Cells.IsEmpty())
+	{
+		Buffer.OccupiedMin = FIntVector(MAX_int32);
+		Buffer.OccupiedMax = FIntVector(MIN_int32);
+	}
+}
+
+void FGizmoSnapHash::Reset()
+{
+	this->Write([](FBuffer& Buffer)
+		{
+			Buffer.Cells.Reset();
+			Buffer.SourceCells.Reset();
+			Buffer.Blocks.Reset();
+			Buffer.NumPoints = 0;
+			Buffer.OccupiedMin = FIntVector(MAX_int32);
+			Buffer.OccupiedMax = FIntVector(MIN_int32);
+		});
+}
+
+int32 FGizmoSnapHash::QueryScreen(const FGizmoViewState& View, const FVector2D& ScreenPosition, double PixelRadius, double MaxDistance, int32 MaxCandidates, const TSet<uint32>& ExcludedSources, TArray<FGizmoSnapCandidate>& Out_Candidates) const
+{
+	Out_Candidates.Reset();
+
+	FVector RayOrigin;
+	FVector RayDirection;
+	FVector EdgeOrigin;
+	FVector EdgeDirection;
+
+	if (MaxCandidates <= 0 || !View.DeprojectScreenToWorld(ScreenPosition, RayOrigin, RayDirection) || !View.DeprojectScreenToWorld(ScreenPosition + FVector2D(PixelRadius, 0), EdgeOrigin, EdgeDirection))
+	{
+		return 0;
+	}
+
+	// Pixel radius as the half angle of a cone around the cursor ray.
+	const double CosAngle = FMath::Clamp(FVector::DotProduct(RayDirection, EdgeDirection), 0.01, 1.0);
+	const double TanAngle = FMath::Sqrt(1 - CosAngle * CosAngle) / CosAngle;
+	const double TanAngleSquared = TanAngle * TanAngle;
+
+	// Newest buffer, or the previous one while an update holds it.
+	const int32 NewestIndex = this->ReadIndex.load();
+	const FBuffer* Buffer = nullptr;
+
+	for (int32 Attempt = 0; Attempt < 2 && !Buffer; Attempt++)
+	{
+		const FBuffer& EachBuffer = this->Buffers[NewestIndex ^ Attempt];
+
+		if (EachBuffer.Lock.TryReadLock())
+		{
+			Buffer = &EachBuffer;
+		}
+	}
+
+	if (!Buffer)
+	{
+		return 0;
+	}
+
+	// Nothing to find, skip the walk out to MaxDistance.
+	if (Buffer->NumPoints == 0)
+	{
+		Buffer->Lock.ReadUnlock();
+		return 0;
+	}
+
+	// Depth range of the occupied bounds along the ray. Slices outside it can not hold a point.
+	const FVector OccupiedLower = FVector(Buffer->OccupiedMin) * this->CellSize;
+	const FVector OccupiedUpper = FVector(Buffer->OccupiedMax + FIntVector(1)) * this->CellSize;
+	const double CenterDepth = FVector::DotProduct((OccupiedLower + OccupiedUpper) * 0.5 - RayOrigin, RayDirection);
+	const double HalfDepth = FVector::DotProduct((OccupiedUpper - OccupiedLower) * 0.5, RayDirection.GetAbs());
+
+	const double StartDistance = FMath::Max(0.0, CenterDepth - HalfDepth - this->CellSize);
+	const double EndDistance = FMath::Min(MaxDistance, CenterDepth + HalfDepth + this->CellSize);
+
+	double NearestDepth = TNumericLimits<double>::Max();
+	FIntVector PreviousMin(1, 1, 1);
+	FIntVector PreviousMax(0, 0, 0);
+
+	for (double Distance = StartDistance; Distance <= EndDistance; Distance += this->CellSize)
+	{
+		if (Out_Candidates.Num() >= MaxCandidates && Distance > NearestDepth + this->CellSize * 2)
+		{
+			break;
+		}
+
+		// Cell box around this slice of the cone, clamped to the occupied cells. Boxes only grow and slide along the ray, so cells of the previous box are skipped.
+		const FVector Center = RayOrigin + RayDirection * Distance;
+		const FVector Radius = FVector((Distance + this->CellSize) * TanAngle + this->CellSize * 0.5);
+		const FIntVector UnclampedMin = this->ToCell(Center - Radius);
+		const FIntVector UnclampedMax = this->ToCell(Center + Radius);
+		const FIntVector Min(FMath::Max(UnclampedMin.X, Buffer->OccupiedMin.X), FMath::Max(UnclampedMin.Y, Buffer->OccupiedMin.Y), FMath::Max(UnclampedMin.Z, Buffer->OccupiedMin.Z));
+		const FIntVector Max(FMath::Min(UnclampedMax.X, Buffer->OccupiedMax.X), FMath::Min(UnclampedMax.Y, Buffer->OccupiedMax.Y), FMath::Min(UnclampedMax.Z, Buffer->OccupiedMax.Z));
+
+		const FIntVector BlockMin = GizmoSnapToBlock(Min);
+		const FIntVector BlockMax = GizmoSnapToBlock(Max);
+
+		for (int32 BlockX = BlockMin.X; BlockX <= BlockMax.X; BlockX++)
+		{
+			for (int32 BlockY = BlockMin.Y; BlockY <= BlockMax.Y; BlockY++)
+			{
+				for (int32 BlockZ = BlockMin.Z; BlockZ <= BlockMax.Z; BlockZ++)
+				{
+					// Empty block, none of its cells is probed.
+					if (!Buffer->Blocks.Contains(FIntVector(BlockX, BlockY, BlockZ)))
+					{
+						continue;
+					}
+
+					const FIntVector CellMin(FMath::Max(Min.X, BlockX << GizmoSnapBlockShift), FMath::Max(Min.Y, BlockY << GizmoSnapBlockShift), FMath::Max(Min.Z, BlockZ << GizmoSnapBlockShift));
+					const FIntVector CellMax(FMath::Min(Max.X, ((BlockX + 1) << GizmoSnapBlockShift) - 1), FMath::Min(Max.Y, ((BlockY + 1) << GizmoSnapBlockShift) - 1), FMath::Min(Max.Z, ((BlockZ + 1) << GizmoSnapBlockShift) - 1));
+
+					for (int32 X = CellMin.X; X <= CellMax.X; X++)
+					{
+						for (int32 Y = CellMin.Y; Y <= CellMax.Y; Y++)
+						{
+							for (int32 Z = CellMin.Z; Z <= CellMax.Z; Z++)
+							{
+								const bool bVisited = X >= PreviousMin.X && X <= PreviousMax.X && Y >= PreviousMin.Y && Y <= PreviousMax.Y && Z >= PreviousMin.Z && Z <= PreviousMax.Z;
+								const TArray<FEntry>* Entries = bVisited ? nullptr : Buffer->Cells.Find(FIntVector(X, Y, Z));
+
+								if (!Entries)
+								{
+									continue;
+								}
+
+								for (const FEntry& EachEntry : *Entries)
+								{
+									// Cheap cone test first, the projection only runs for points that pass it.
+									const FVector ToPoint = EachEntry.Location - RayOrigin;
+									const double Depth = FVector::DotProduct(ToPoint, RayDirection);
+
+									if (Depth <= 0 || Depth > MaxDistance || ToPoint.SizeSquared() - Depth * Depth > Depth * Depth * TanAngleSquared || ExcludedSources.Contains(EachEntry.SourceId))
+									{
+										continue;
+									}
+
+									FVector2D PointScreenPosition;
+
+									if (!View.ProjectWorldToScreen(EachEntry.Location, PointScreenPosition))
+									{
+										continue;
+									}
+
+									const double ScreenDistance = FVector2D::Distance(PointScreenPosition, ScreenPosition);
+
+									if (ScreenDistance > PixelRadius)
+									{
+										continue;
+									}
+
+									FGizmoSnapCandidate& Candidate = Out_Candidates.AddDefaulted_GetRef();
+									Candidate.Location = EachEntry.Location;
+									Candidate.ScreenDistance = ScreenDistance;
+									Candidate.Depth = Depth;
+									Candidate.SourceId = EachEntry.SourceId;
+
+									NearestDepth = FMath::Min(NearestDepth, Depth);
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		PreviousMin = Min;
+		PreviousMax = Max;
+	}
+
+	Buffer->Lock.ReadUnlock();
+
+	Out_Candidates.Sort([](const FGizmoSnapCandidate& A, const FGizmoSnapCandidate& B)
+		{
+			return A.ScreenDistance == B.ScreenDistance ? A.Depth < B.Depth : A.ScreenDistance < B.ScreenDistance;
+		});
+
+	if (Out_Candidates.Num() > MaxCandidates)
+	{
+		Out_Candidates.SetNum(MaxCandidates);
+	}
+
+	return Out_Candidates.Num();
+}
+
+int32 FGizmoSnapHash::GetNumPoints() const
+{
+	const FBuffer& Buffer = this->Buffers[this->ReadIndex.load()];
+
+	FReadScopeLock ReadLock(Buffer.Lock);
+	return Buffer.NumPoints;
+}
+
+double FGizmoSnapHash::GetCellSize() const
+{
+	return this->CellSize;
+}
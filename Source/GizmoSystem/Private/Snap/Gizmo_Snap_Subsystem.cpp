@@ -0,0 +1,447 @@
+#include "Snap/Gizmo_Snap_Subsystem.h"
+#include "Gizmo_Stats.h"
+#include "Math/Gizmo_Math_Solver.h"
+#include "Trace/CustomCollision.h"
+#include "Trace/Gizmo_Trace_Move.h"
+#include "Math/Gizmo_Math_Base.h"
+#include "Math/Gizmo_Math_Move.h"
+#include "Math/Gizmo_Math_Rotate.h"
+#include "Math/Gizmo_Math_Scale.h"
+
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshSocket.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "StaticMeshResources.h"
+
+// Far plane of snap queries. Points further away are too small on screen to be useful targets.
+static constexpr double GizmoSnapMaxDistance = 100000;
+
+void UGizmoSnapSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	this->Hash = MakeShared<FGizmoSnapHash, ESPMode::ThreadSafe>();
+}
+
+void UGizmoSnapSubsystem::Deinitialize()
+{
+	this->PendingTask.Wait();
+
+	UWorld* World = this->GetWorld();
+
+	if (World)
+	{
+		World->RemoveOnActorSpawnedHandler(this->ActorSpawnedHandle);
+		World->RemoveOnActorDestroyededHandler(this->ActorDestroyedHandle);
+	}
+
+	FWorldDelegates::LevelAddedToWorld.Remove(this->LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(this->LevelRemovedHandle);
+
+	for (const TPair<uint32, TWeakObjectPtr<USceneComponent>>& EachSource : this->Sources)
+	{
+		if (USceneComponent* Component = EachSource.Value.Get())
+		{
+			Component->TransformUpdated.RemoveAll(this);
+		}
+	}
+
+	this->Sources.Empty();
+	this->DirtySources.Empty();
+	this->RemovedSources.Empty();
+	this->SuspendedSources.Empty();
+	this->SuspendedDirtySources.Empty();
+	this->MeshPoints.Empty();
+	this->Hash.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UGizmoSnapSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UGizmoSnapSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGizmoSnapSubsystem, STATGROUP_Tickables);
+}
+
+void UGizmoSnapSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		this->AddActor(*It);
+	}
+
+	this->ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UGizmoSnapSubsystem::AddActor));
+	this->ActorDestroyedHandle = InWorld.AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &UGizmoSnapSubsystem::RemoveActor));
+	this->LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UGizmoSnapSubsystem::OnLevelAdded);
+	this->LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UGizmoSnapSubsystem::OnLevelRemoved);
+
+	// The initial build goes out on the first tick like any other batch.
+}
+
+void UGizmoSnapSubsystem::OnLevelAdded(ULevel* Level, UWorld* InWorld)
+{
+	if (!Level || InWorld != this->GetWorld())
+	{
+		return;
+	}
+
+	for (AActor* EachActor : Level->Actors)
+	{
+		this->AddActor(EachActor);
+	}
+}
+
+void UGizmoSnapSubsystem::OnLevelRemoved(ULevel* Level, UWorld* InWorld)
+{
+	if (!Level || InWorld != this->GetWorld())
+	{
+		return;
+	}
+
+	for (AActor* EachActor : Level->Actors)
+	{
+		this->RemoveActor(EachActor);
+	}
+}
+
+void UGizmoSnapSubsystem::AddActor(AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	TInlineComponentArray<USceneComponent*> Components(Actor);
+
+	for (USceneComponent* EachComponent : Components)
+	{
+		if (this->IsSnapSource(EachComponent))
+		{
+			this->RegisterSnapComponent(EachComponent);
+		}
+	}
+}
+
+void UGizmoSnapSubsystem::RemoveActor(AActor* Actor)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	TInlineComponentArray<USceneComponent*> Components(Actor);
+
+	for (USceneComponent* EachComponent : Components)
+	{
+		this->UnregisterSnapComponent(EachComponent);
+	}
+}
+
+bool UGizmoSnapSubsystem::IsSnapSource(const USceneComponent* Component) const
+{
+	if (!IsValid(Component))
+	{
+		return false;
+	}
+
+	// Instances would need one source per instance.
+	if (Component->IsA<UInstancedStaticMeshComponent>())
+	{
+		return false;
+	}
+
+	// Gizmo handles are never snap targets.
+	const AActor* Owner = Component->GetOwner();
+
+	if (Owner && (Owner->IsA<AGizmoMathBase>() || Owner->IsA<AGizmoMathMove>() || Owner->IsA<AGizmoMathRotate>() || Owner->IsA<AGizmoMathScale>() || Owner->IsA<AGizmoTraceMove>()))
+	{
+		return false;
+	}
+
+	if (const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component))
+	{
+		return MeshComponent->GetStaticMesh() != nullptr;
+	}
+
+	return Component->IsA<UCustomCollision>();
+}
+
+void UGizmoSnapSubsystem::RegisterSnapComponent(USceneComponent* Component)
+{
+	if (!IsValid(Component))
+	{
+		return;
+	}
+
+	const uint32 SourceId = Component->GetUniqueID();
+
+	if (this->Sources.Contains(SourceId))
+	{
+		return;
+	}
+
+	this->Sources.Add(SourceId, Component);
+	this->RemovedSources.Remove(SourceId);
+	this->DirtySources.Add(SourceId);
+
+	// Static sources are read once.
+	if (Component->Mobility == EComponentMobility::Movable)
+	{
+		Component->TransformUpdated.AddUObject(this, &UGizmoSnapSubsystem::OnSourceMoved);
+	}
+}
+
+void UGizmoSnapSubsystem::UnregisterSnapComponent(USceneComponent* Component)
+{
+	if (!Component)
+	{
+		return;
+	}
+
+	const uint32 SourceId = Component->GetUniqueID();
+
+	if (this->Sources.Remove(SourceId) == 0)
+	{
+		return;
+	}
+
+	Component->TransformUpdated.RemoveAll(this);
+	this->DirtySources.Remove(SourceId);
+	this->RemovedSources.Add(SourceId);
+}
+
+void UGizmoSnapSubsystem::MarkDirty(const USceneComponent* Component)
+{
+	if (Component && this->Sources.Contains(Component->GetUniqueID()))
+	{
+		this->DirtySources.Add(Component->GetUniqueID());
+	}
+}
+
+void UGizmoSnapSubsystem::SuspendSources(const TSet<uint32>& SourceIds)
+{
+	this->ResumeSources();
+	this->SuspendedSources = SourceIds;
+}
+
+void UGizmoSnapSubsystem::ResumeSources()
+{
+	for (const uint32 EachId : this->SuspendedDirtySources)
+	{
+		// Unregistered while suspended, the removal is already queued.
+		if (this->Sources.Contains(EachId))
+		{
+			this->DirtySources.Add(EachId);
+		}
+	}
+
+	this->SuspendedSources.Reset();
+	this->SuspendedDirtySources.Reset();
+}
+
+void UGizmoSnapSubsystem::OnSourceMoved(USceneComponent* Component, EUpdateTransformFlags Flags, ETeleportType Teleport)
+{
+	if (!Component)
+	{
+		return;
+	}
+
+	const uint32 SourceId = Component->GetUniqueID();
+
+	if (this->SuspendedSources.Contains(SourceId))
+	{
+		this->SuspendedDirtySources.Add(SourceId);
+		return;
+	}
+
+	this->DirtySources.Add(SourceId);
+}
+
+bool UGizmoSnapSubsystem::GatherSource(USceneComponent* Component, FSourceUpdate& Out_Update)
+{
+	Out_Update.SourceId = Component->GetUniqueID();
+	Out_Update.Transform = Component->GetComponentTransform();
+
+	if (const UCustomCollision* Collision = Cast<UCustomCollision>(Component))
+	{
+		Out_Update.LocalPoints = Collision->Corners;
+		return true;
+	}
+
+	const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component);
+	UStaticMesh* Mesh = MeshComponent ? MeshComponent->GetStaticMesh() : nullptr;
+
+	if (!Mesh)
+	{
+		return false;
+	}
+
+	TSharedPtr<FMeshPoints, ESPMode::ThreadSafe>& Points = this->MeshPoints.FindOrAdd(Mesh);
+
+	// Vertex data is copied once per mesh. Cooked meshes without CPU access only contribute their sockets.
+	if (!Points.IsValid())
+	{
+		Points = MakeShared<FMeshPoints, ESPMode::ThreadSafe>();
+
+		const FStaticMeshRenderData* RenderData = Mesh->GetRenderData();
+
+		if (RenderData && RenderData->LODResources.Num() > 0)
+		{
+			const FPositionVertexBuffer& Positions = RenderData->LODResources[0].VertexBuffers.PositionVertexBuffer;
+
+			if (Positions.GetVertexData() && Positions.GetNumVertices() > 0)
+			{
+				Points->Points.SetNumUninitialized(Positions.GetNumVertices());
+				FMemory::Memcpy(Points->Points.GetData(), Positions.GetVertexData(), Positions.GetNumVertices() * sizeof(FVector3f));
+			}
+		}
+
+		for (const UStaticMeshSocket* EachSocket : Mesh->Sockets)
+		{
+			if (EachSocket)
+			{
+				Points->Points.Add(FVector3f(EachSocket->RelativeLocation));
+			}
+		}
+	}
+
+	Out_Update.Mesh = Points;
+	return true;
+}
+
+void UGizmoSnapSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (this->DirtySources.IsEmpty() && this->RemovedSources.IsEmpty())
+	{
+		return;
+	}
+
+	// One batch in flight at a time. Sources dirtied meanwhile stay queued and go out together with the next one.
+	if (!this->PendingTask.IsCompleted())
+	{
+		return;
+	}
+
+	this->FlushUpdates();
+}
+
+void UGizmoSnapSubsystem::FlushUpdates()
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_SnapGather);
+
+	TArray<FSourceUpdate> Updates;
+	Updates.Reserve(this->DirtySources.Num() + this->RemovedSources.Num());
+
+	for (const uint32 EachId : this->RemovedSources)
+	{
+		FSourceUpdate& Update = Updates.AddDefaulted_GetRef();
+		Update.SourceId = EachId;
+		Update.bRemove = true;
+	}
+
+	for (const uint32 EachId : this->DirtySources)
+	{
+		const TWeakObjectPtr<USceneComponent>* Source = this->Sources.Find(EachId);
+		USceneComponent* Component = Source ? Source->Get() : nullptr;
+
+		// Components that went away without an unregister, e.g. destroyed directly.
+		if (!Component)
+		{
+			this->Sources.Remove(EachId);
+
+			FSourceUpdate& Update = Updates.AddDefaulted_GetRef();
+			Update.SourceId = EachId;
+			Update.bRemove = true;
+			continue;
+		}
+
+		FSourceUpdate Update;
+
+		if (this->GatherSource(Component, Update))
+		{
+			Updates.Add(MoveTemp(Update));
+		}
+	}
+
+	this->DirtySources.Reset();
+	this->RemovedSources.Reset();
+
+	if (Updates.IsEmpty())
+	{
+		return;
+	}
+
+	this->PendingTask = this->Pipe.Launch(TEXT("GizmoSnapUpdate"), [Hash = this->Hash, Updates = MoveTemp(Updates)]() mutable
+	{
+		GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_SnapBuild);
+
+		TArray<FVector> WorldPoints;
+
+		for (FSourceUpdate& EachUpdate : Updates)
+		{
+			if (EachUpdate.bRemove)
+			{
+				Hash->RemoveSource(EachUpdate.SourceId);
+				continue;
+			}
+
+			WorldPoints.Reset();
+
+			if (EachUpdate.Mesh.IsValid())
+			{
+				FMeshPoints& Mesh = *EachUpdate.Mesh;
+
+				// Split normals and UVs duplicate positions. The pipe is serial, so the shared mesh entry is only touched here.
+				if (!Mesh.bDeduplicated)
+				{
+					Mesh.Points = TSet<FVector3f>(Mesh.Points).Array();
+					Mesh.bDeduplicated = true;
+				}
+
+				WorldPoints.Reserve(Mesh.Points.Num() + EachUpdate.LocalPoints.Num());
+
+				for (const FVector3f& EachPoint : Mesh.Points)
+				{
+					WorldPoints.Add(EachUpdate.Transform.TransformPosition(FVector(EachPoint)));
+				}
+			}
+
+			for (const FVector& EachPoint : EachUpdate.LocalPoints)
+			{
+				WorldPoints.Add(EachUpdate.Transform.TransformPosition(EachPoint));
+			}
+
+			Hash->SetSource(EachUpdate.SourceId, WorldPoints);
+		}
+	});
+}
+
+int32 UGizmoSnapSubsystem::FindSnapCandidates(const FGizmoViewState& View, const FVector2D& ScreenPosition, float PixelRadius, int32 MaxCandidates, const TSet<uint32>& ExcludedSources, TArray<FGizmoSnapCandidate>& Out_Candidates) const
+{
+	GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_SnapQuery);
+
+	if (!this->Hash.IsValid())
+	{
+		Out_Candidates.Reset();
+		return 0;
+	}
+
+	return this->Hash->QueryScreen(View, ScreenPosition, PixelRadius, GizmoSnapMaxDistance, MaxCandidates, ExcludedSources, Out_Candidates);
+}
+
+int32 UGizmoSnapSubsystem::GetNumSnapPoints() const
+{
+	return this->Hash.IsValid() ? this->Hash->GetNumPoints() : 0;
+}
@@ -0,0 +1,238 @@
+#include "Targets/Gizmo_Instance_Targets.h"
+
+#include "Gizmo_Stats.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+
+// Unselected instances between two selected ones up to which both are written with one call. Resending a few unchanged transforms is cheaper than another call.
+static constexpr int32 GizmoInstanceMaxRunGap = 16;
+
+void FGizmoInstanceDrag::Begin(TConstArrayView<FGizmoInstanceTarget> Targets)
+{
+	this->End();
+
+	// Same component may be listed more than once.
+	TMap<UInstancedStaticMeshComponent*, TArray<int32>> IndicesByComponent;
+
+	for (const FGizmoInstanceTarget& EachTarget : Targets)
+	{
+		if (!IsValid(EachTarget.Component))
+		{
+			continue;
+		}
+
+		const int32 NumInstances = EachTarget.Component->GetInstanceCount();
+		TArray<int32>& Indices = IndicesByComponent.FindOrAdd(EachTarget.Component);
+
+		for (const int32 EachIndex : EachTarget.InstanceIndices)
+		{
+			if (EachIndex >= 0 && EachIndex < NumInstances)
+			{
+				Indices.Add(EachIndex);
+			}
+		}
+	}
+
+	for (TPair<UInstancedStaticMeshComponent*, TArray<int32>>& EachPair : IndicesByComponent)
+	{
+		UInstancedStaticMeshComponent* Component = EachPair.Key;
+		TArray<int32>& Indices = EachPair.Value;
+
+		if (Indices.IsEmpty())
+		{
+			continue;
+		}
+
+		Indices.Sort();
+
+		FBatch& Batch = this->Batches.AddDefaulted_GetRef();
+		Batch.Component = Component;
+
+		int32 PreviousIndex = INDEX_NONE;
+
+		for (const int32 EachIndex : Indices)
+		{
+			if (EachIndex == PreviousIndex)
+			{
+				continue;
+			}
+
+			if (Batch.Runs.IsEmpty() || EachIndex - PreviousIndex > GizmoInstanceMaxRunGap + 1)
+			{
+				Batch.Runs.AddDefaulted_GetRef().StartIndex = EachIndex;
+			}
+
+			FRun& Run = Batch.Runs.Last();
+
+			// Gap instances are resent unchanged.
+			for (int32 Index = Run.StartIndex + Run.Transforms.Num(); Index <= EachIndex; Index++)
+			{
+				Component->GetInstanceTransform(Index, Run.Transforms.AddDefaulted_GetRef(), true);
+			}
+
+			Run.Offsets.Add(EachIndex - Run.StartIndex);
+			Run.StartTransforms.Add(Run.Transforms.Last());
+
+			PreviousIndex = EachIndex;
+		}
+	}
+}
+
+int32 FGizmoInstanceDrag::Apply(TFunctionRef<FTransform(const FTransform&)> Solver)
+{
+	int32 NumChanged = 0;
+
+	for (FBatch& EachBatch : this->Batches)
+	{
+		UInstancedStaticMeshComponent* Component = EachBatch.Component.Get();
+
+		if (!IsValid(Component))
+		{
+			continue;
+		}
+
+		int32 NumBatchChanged = 0;
+		int32 LastDirtyRun = INDEX_NONE;
+
+		for (int32 RunIndex = 0; RunIndex < EachBatch.Runs.Num(); RunIndex++)
+		{
+			FRun& Run = EachBatch.Runs[RunIndex];
+
+			for (int32 SelectedIndex = 0; SelectedIndex < Run.Offsets.Num(); SelectedIndex++)
+			{
+				const FTransform NewTransform = Solver(Run.StartTransforms[SelectedIndex]);
+				FTransform& Transform = Run.Transforms[Run.Offsets[SelectedIndex]];
+
+				if (!NewTransform.Equals(Transform))
+				{
+					Transform = NewTransform;
+					Run.bDirty = true;
+					NumBatchChanged++;
+				}
+			}
+
+			if (Run.bDirty)
+			{
+				LastDirtyRun = RunIndex;
+			}
+		}
+
+		if (NumBatchChanged == 0)
+		{
+			continue;
+		}
+
+		// Without bodies and navigation relevance, per frame updates only touch the render instance buffer.
+		if (!EachBatch.bWritten)
+		{
+			EachBatch.CollisionEnabled = Component->GetCollisionEnabled();
+			EachBatch.bAffectedNavigation = Component->CanEverAffectNavigation();
+
+			if (EachBatch.CollisionEnabled != ECollisionEnabled::NoCollision)
+			{
+				Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			}
+
+			if (EachBatch.bAffectedNavigation)
+			{
+				Component->SetCanEverAffectNavigation(false);
+			}
+
+			EachBatch.bWritten = true;
+		}
+
+		// Render state is marked dirty once per component, by its last write.
+		for (int32 RunIndex = 0; RunIndex <= LastDirtyRun; RunIndex++)
+		{
+			FRun& Run = EachBatch.Runs[RunIndex];
+
+			if (!Run.bDirty)
+			{
+				continue;
+			}
+
+			Component->BatchUpdateInstancesTransforms(Run.StartIndex, Run.Transforms, true, RunIndex == LastDirtyRun, false);
+			INC_DWORD_STAT(STAT_Gizmo_InstanceBatches);
+			Run.bDirty = false;
+		}
+
+		NumChanged += NumBatchChanged;
+	}
+
+	return NumChanged;
+}
+
+void FGizmoInstanceDrag::End()
+{
+	for (FBatch& EachBatch : this->Batches)
+	{
+		UInstancedStaticMeshComponent* Component = EachBatch.Component.Get();
+
+		if (!IsValid(Component) || !EachBatch.bWritten)
+		{
+			continue;
+		}
+
+		for (int32 RunIndex = 0; RunIndex < EachBatch.Runs.Num(); RunIndex++)
+		{
+			Component->BatchUpdateInstancesTransforms(EachBatch.Runs[RunIndex].StartIndex, EachBatch.Runs[RunIndex].Transforms, true, RunIndex == EachBatch.Runs.Num() - 1, true);
+		}
+
+		// Bodies are recreated and navigation is re-registered at the final transforms.
+		if (EachBatch.CollisionEnabled != ECollisionEnabled::NoCollision)
+		{
+			Component->SetCollisionEnabled(EachBatch.CollisionEnabled);
+		}
+
+		if (EachBatch.bAffectedNavigation)
+		{
+			Component->SetCanEverAffectNavigation(true);
+		}
+
+		if (UHierarchicalInstancedStaticMeshComponent* Hierarchical = Cast<UHierarchicalInstancedStaticMeshComponent>(Component))
+		{
+			Hierarchical->BuildTreeIfOutdated(true, false);
+		}
+	}
+
+	this->Batches.Reset();
+}
+
+bool FGizmoInstanceDrag::IsEmpty() const
+{
+	return this->Batches.IsEmpty();
+}
+
+int32 FGizmoInstanceDrag::GetNumInstances() const
+{
+	int32 NumInstances = 0;
+
+	for (const FBatch& EachBatch : this->Batches)
+	{
+		for (const FRun& EachRun : EachBatch.Runs)
+		{
+			NumInstances += EachRun.StartTransforms.Num();
+		}
+	}
+
+	return NumInstances;
+}
+
+FVector FGizmoInstanceDrag::GetStartLocationSum() const
+{
+	FVector Sum = FVector::ZeroVector;
+
+	for (const FBatch& EachBatch : this->Batches)
+	{
+		for (const FRun& EachRun : EachBatch.Runs)
+		{
+			for (const FTransform& EachTransform : EachRun.StartTransforms)
+			{
+				Sum += EachTransform.GetLocation();
+			}
+		}
+	}
+
+	return Sum;
+}
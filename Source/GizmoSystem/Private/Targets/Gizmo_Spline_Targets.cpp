@@ -0,0 +1,310 @@
+#include "Targets/Gizmo_Spline_Targets.h"
+
+#include "Gizmo_Stats.h"
+
+#include "Components/SplineComponent.h"
+
+// Same tangents as FInterpCurve::AutoSetTangents with zero tension computes for one point, without touching the rest of the curve.
+template<typename T>
+static void GizmoUpdateAutoTangent(FInterpCurve<T>& Curve, int32 PointIndex, bool bStationaryEndpoints)
+{
+	const int32 NumPoints = Curve.Points.Num();
+	const int32 LastPoint = NumPoints - 1;
+
+	if (PointIndex < 0 || PointIndex > LastPoint)
+	{
+		return;
+	}
+
+	FInterpCurvePoint<T>& ThisPoint = Curve.Points[PointIndex];
+
+	const int32 PrevIndex = (PointIndex == 0) ? (Curve.bIsLooped ? LastPoint : 0) : (PointIndex - 1);
+	const int32 NextIndex = (PointIndex == LastPoint) ? (Curve.bIsLooped ? 0 : LastPoint) : (PointIndex + 1);
+
+	const FInterpCurvePoint<T>& PrevPoint = Curve.Points[PrevIndex];
+	const FInterpCurvePoint<T>& NextPoint = Curve.Points[NextIndex];
+
+	if (ThisPoint.InterpMode == CIM_CurveAuto || ThisPoint.InterpMode == CIM_CurveAutoClamped)
+	{
+		if (bStationaryEndpoints && (PointIndex == 0 || (PointIndex == LastPoint && !Curve.bIsLooped)))
+		{
+			ThisPoint.ArriveTangent = T(ForceInit);
+			ThisPoint.LeaveTangent = T(ForceInit);
+		}
+
+		else if (PrevPoint.IsCurveKey())
+		{
+			const float PrevTime = (Curve.bIsLooped && PointIndex == 0) ? (ThisPoint.InVal - Curve.LoopKeyOffset) : PrevPoint.InVal;
+			const float NextTime = (Curve.bIsLooped && PointIndex == LastPoint) ? (ThisPoint.InVal + Curve.LoopKeyOffset) : NextPoint.InVal;
+
+			T Tangent;
+			ComputeCurveTangent(PrevTime, PrevPoint.OutVal, ThisPoint.InVal, ThisPoint.OutVal, NextTime, NextPoint.OutVal, 0.f, ThisPoint.InterpMode == CIM_CurveAutoClamped, Tangent);
+
+			ThisPoint.ArriveTangent = Tangent;
+			ThisPoint.LeaveTangent = Tangent;
+		}
+
+		// After a linear or constant segment the tangent continues the previous one, so there is no kink.
+		else
+		{
+			ThisPoint.ArriveTangent = PrevPoint.ArriveTangent;
+			ThisPoint.LeaveTangent = PrevPoint.LeaveTangent;
+		}
+	}
+
+	else if (ThisPoint.InterpMode == CIM_Linear)
+	{
+		const T Tangent = NextPoint.OutVal - ThisPoint.OutVal;
+
+		ThisPoint.ArriveTangent = Tangent;
+		ThisPoint.LeaveTangent = Tangent;
+	}
+
+	else if (ThisPoint.InterpMode == CIM_Constant)
+	{
+		ThisPoint.ArriveTangent = T(ForceInit);
+		ThisPoint.LeaveTangent = T(ForceInit);
+	}
+}
+
+bool FGizmoSplineDrag::GetHandleTransform(const USplineComponent* Spline, int32 PointIndex, EGizmoSplineHandle Handle, FTransform& Out_Transform)
+{
+	if (!IsValid(Spline) || PointIndex < 0 || PointIndex >= Spline->GetNumberOfSplinePoints())
+	{
+		return false;
+	}
+
+	const FVector Location = Spline->GetLocationAtSplinePoint(PointIndex, ESplineCoordinateSpace::World);
+
+	switch (Handle)
+	{
+		case EGizmoSplineHandle::Arrive_Tangent:
+			Out_Transform = FTransform(Location - Spline->GetArriveTangentAtSplinePoint(PointIndex, ESplineCoordinateSpace::World));
+			break;
+
+		case EGizmoSplineHandle::Leave_Tangent:
+			Out_Transform = FTransform(Location + Spline->GetLeaveTangentAtSplinePoint(PointIndex, ESplineCoordinateSpace::World));
+			break;
+
+		default:
+			Out_Transform = FTransform(Spline->GetQuaternionAtSplinePoint(PointIndex, ESplineCoordinateSpace::World), Location, Spline->GetScaleAtSplinePoint(PointIndex));
+			break;
+	}
+
+	return true;
+}
+
+void FGizmoSplineDrag::Begin(TConstArrayView<FGizmoSplineTarget> Targets)
+{
+	this->End();
+
+	for (const FGizmoSplineTarget& EachTarget : Targets)
+	{
+		USplineComponent* Spline = EachTarget.Component;
+
+		if (!IsValid(Spline))
+		{
+			continue;
+		}
+
+		FBatch* Batch = this->Batches.FindByPredicate([Spline](const FBatch& EachBatch)
+			{
+				return EachBatch.Component.Get() == Spline;
+			});
+
+		if (!Batch)
+		{
+			Batch = &this->Batches.AddDefaulted_GetRef();
+			Batch->Component = Spline;
+		}
+
+		const FSplineCurves& Curves = Spline->SplineCurves;
+
+		for (const int32 EachIndex : EachTarget.PointIndices)
+		{
+			FHandle Handle;
+			Handle.PointIndex = EachIndex;
+			Handle.Type = EachTarget.Handle;
+
+			const bool bDuplicate = Batch->Handles.ContainsByPredicate([&Handle](const FHandle& EachHandle)
+				{
+					return EachHandle.PointIndex == Handle.PointIndex && EachHandle.Type == Handle.Type;
+				});
+
+			if (bDuplicate || !GetHandleTransform(Spline, EachIndex, EachTarget.Handle, Handle.StartTransform) || !Curves.Rotation.Points.IsValidIndex(EachIndex))
+			{
+				continue;
+			}
+
+			const FInterpCurvePoint<FVector>& Position = Curves.Position.Points[EachIndex];
+
+			Handle.Transform = Handle.StartTransform;
+			Handle.StartArriveTangent = Position.ArriveTangent;
+			Handle.StartLeaveTangent = Position.LeaveTangent;
+			Handle.StartInterpMode = Position.InterpMode;
+			Handle.StartRotation = Curves.Rotation.Points[EachIndex].OutVal;
+
+			Batch->Handles.Add(Handle);
+		}
+	}
+
+	this->Batches.RemoveAll([](const FBatch& EachBatch)
+		{
+			return EachBatch.Handles.IsEmpty();
+		});
+}
+
+int32 FGizmoSplineDrag::Apply(TFunctionRef<FTransform(const FTransform&)> Solver)
+{
+	int32 NumWritten = 0;
+
+	for (FBatch& EachBatch : this->Batches)
+	{
+		USplineComponent* Spline = EachBatch.Component.Get();
+
+		if (!IsValid(Spline))
+		{
+			continue;
+		}
+
+		FSplineCurves& Curves = Spline->SplineCurves;
+		const FTransform& ComponentTransform = Spline->GetComponentTransform();
+		const FQuat ComponentRotation = ComponentTransform.GetRotation();
+
+		this->DirtyPoints.Reset();
+
+		for (FHandle& EachHandle : EachBatch.Handles)
+		{
+			const FTransform NewTransform = Solver(EachHandle.StartTransform);
+
+			// Points may have been removed by someone else during the drag.
+			if (NewTransform.Equals(EachHandle.Transform) || !Curves.Position.Points.IsValidIndex(EachHandle.PointIndex) || !Curves.Rotation.Points.IsValidIndex(EachHandle.PointIndex))
+			{
+				continue;
+			}
+
+			EachHandle.Transform = NewTransform;
+			this->DirtyPoints.Add(EachHandle.PointIndex);
+
+			FInterpCurvePoint<FVector>& Position = Curves.Position.Points[EachHandle.PointIndex];
+
+			if (EachHandle.Type != EGizmoSplineHandle::Point)
+			{
+				const FVector Handle = ComponentTransform.InverseTransformPosition(NewTransform.GetLocation());
+				const FVector Tangent = EachHandle.Type == EGizmoSplineHandle::Leave_Tangent ? Handle - Position.OutVal : Position.OutVal - Handle;
+
+				Position.ArriveTangent = Tangent;
+				Position.LeaveTangent = Tangent;
+				Position.InterpMode = CIM_CurveUser;
+				continue;
+			}
+
+			Position.OutVal = ComponentTransform.InverseTransformPosition(NewTransform.GetLocation());
+
+			if (Curves.Scale.Points.IsValidIndex(EachHandle.PointIndex))
+			{
+				Curves.Scale.Points[EachHandle.PointIndex].OutVal = NewTransform.GetScale3D();
+			}
+
+			// World delta rotation brought into spline space. Tangents turn with the point, like in the spline editor.
+			const FQuat WorldDelta = NewTransform.GetRotation() * EachHandle.StartTransform.GetRotation().Inverse();
+			const FQuat LocalDelta = ComponentRotation.Inverse() * WorldDelta * ComponentRotation;
+
+			if (LocalDelta.Equals(FQuat::Identity))
+			{
+				Position.ArriveTangent = EachHandle.StartArriveTangent;
+				Position.LeaveTangent = EachHandle.StartLeaveTangent;
+				Position.InterpMode = EachHandle.StartInterpMode;
+				Curves.Rotation.Points[EachHandle.PointIndex].OutVal = EachHandle.StartRotation;
+			}
+
+			else
+			{
+				Position.ArriveTangent = LocalDelta.RotateVector(EachHandle.StartArriveTangent);
+				Position.LeaveTangent = LocalDelta.RotateVector(EachHandle.StartLeaveTangent);
+				Position.InterpMode = CIM_CurveUser;
+				Curves.Rotation.Points[EachHandle.PointIndex].OutVal = LocalDelta * EachHandle.StartRotation;
+			}
+		}
+
+		if (this->DirtyPoints.IsEmpty())
+		{
+			continue;
+		}
+
+		// Auto and linear tangents depend on the direct neighbours only, so the segments around each edited point are all that change.
+		// In index order like AutoSetTangents, since a point after a linear segment copies the tangent before it. Rotation tangents wait for End.
+		const int32 NumPoints = Curves.Position.Points.Num();
+		this->DirtyPoints.Sort();
+
+		for (const int32 EachIndex : this->DirtyPoints)
+		{
+			for (int32 Offset = -1; Offset <= 1; Offset++)
+			{
+				const int32 Neighbour = Curves.Position.bIsLooped ? (EachIndex + Offset + NumPoints) % NumPoints : EachIndex + Offset;
+				GizmoUpdateAutoTangent(Curves.Position, Neighbour, Spline->bStationaryEndpoints);
+
+				if (Curves.Scale.Points.Num() == NumPoints)
+				{
+					GizmoUpdateAutoTangent(Curves.Scale, Neighbour, Spline->bStationaryEndpoints);
+				}
+			}
+		}
+
+		INC_DWORD_STAT_BY(STAT_Gizmo_TransformWrites, this->DirtyPoints.Num());
+		NumWritten += this->DirtyPoints.Num();
+		EachBatch.bWritten = true;
+	}
+
+	return NumWritten;
+}
+
+void FGizmoSplineDrag::End(TArray<USplineComponent*>* Out_Splines)
+{
+	for (FBatch& EachBatch : this->Batches)
+	{
+		USplineComponent* Spline = EachBatch.Component.Get();
+
+		if (!IsValid(Spline) || !EachBatch.bWritten)
+		{
+			continue;
+		}
+
+		// Full tangent pass, reparameterization table and render state, once per drag.
+		Spline->UpdateSpline();
+
+		if (Out_Splines)
+		{
+			Out_Splines->Add(Spline);
+		}
+	}
+
+	this->Batches.Reset();
+}
+
+int32 FGizmoSplineDrag::GetNumHandles() const
+{
+	int32 NumHandles = 0;
+
+	for (const FBatch& EachBatch : this->Batches)
+	{
+		NumHandles += EachBatch.Handles.Num();
+	}
+
+	return NumHandles;
+}
+
+FVector FGizmoSplineDrag::GetStartLocationSum() const
+{
+	FVector Sum = FVector::ZeroVector;
+
+	for (const FBatch& EachBatch : this->Batches)
+	{
+		for (const FHandle& EachHandle : EachBatch.Handles)
+		{
+			Sum += EachHandle.StartTransform.GetLocation();
+		}
+	}
+
+	return Sum;
+}
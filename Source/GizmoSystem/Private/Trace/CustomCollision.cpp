@@ -1,4 +1,6 @@
 #include "Trace/CustomCollision.h"
+#include "Gizmo_Stats.h"
+#include "Snap/Gizmo_Snap_Subsystem.h"
 #include "PhysicsEngine/BodySetup.h"
 #include "PhysicsEngine/ConvexElem.h"
 
@@ -61,6 +63,8 @@ void UCustomCollision::UpdateBodySetup()
 
 void UCustomCollision::UpdateCollision()
 {
+    GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_UpdateCollision);
+
     if (!CustomBodySetup)
     {
         return;
@@ -79,6 +83,7 @@ void UCustomCollision::UpdateCollision()
     // Invalidate any old physics data and rebuild the collision meshes.
     CustomBodySetup->InvalidatePhysicsData();
     CustomBodySetup->CreatePhysicsMeshes();
+    INC_DWORD_STAT(STAT_Gizmo_Cooks);
 
     // Ensure collision is enabled.
     SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
@@ -116,6 +121,21 @@ TArray<FVector> UCustomCollision::GeneratePyramidVertices(float Height, FVector2
     return Vertices;
 }
 
+void UCustomCollision::GetHullPlanes(TArray<FPlane>& Out_Planes)
+{
+    Out_Planes.Reset();
+
+    // The cooked convex already has the hull faces, GetBodySetup cooks it on first use.
+    UBodySetup* BodySetup = GetBodySetup();
+
+    if (!BodySetup || BodySetup->AggGeom.ConvexElems.IsEmpty())
+    {
+        return;
+    }
+
+    BodySetup->AggGeom.ConvexElems[0].GetPlanes(Out_Planes);
+}
+
 #if WITH_EDITOR
 
 void UCustomCollision::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
@@ -154,6 +174,14 @@ bool UCustomCollision::SetExtents(TArray<FVector> New_Corners)
     UpdateCollision();
     MarkRenderStateDirty();
 
+    if (UWorld* World = GetWorld())
+    {
+        if (UGizmoSnapSubsystem* Snap = World->GetSubsystem<UGizmoSnapSubsystem>())
+        {
+            Snap->MarkDirty(this);
+        }
+    }
+
     return true;
 }
 
@@ -168,6 +196,8 @@ FCustomBoxSceneProxy::FCustomBoxSceneProxy(const UCustomCollision* InComponent)
 
 void FCustomBoxSceneProxy::GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const
 {
+    GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_ProxyDraw);
+
     const FMatrix LocalToWorldMatrix = GetLocalToWorld();
     const int32 NumVerts = BoxVertices.Num();
 
@@ -187,6 +217,7 @@ void FCustomBoxSceneProxy::GetDynamicMeshElements(const TArray<const FSceneView*
         if (VisibilityMap & (1 << ViewIndex))
         {
             FPrimitiveDrawInterface* PDI = Collector.GetPDI(ViewIndex);
+            INC_DWORD_STAT_BY(STAT_Gizmo_LinesDrawn, NumVerts * (NumVerts - 1) / 2);
             
             // General case: Draw all edges connecting every vertex pair
             for (int32 i = 0; i < NumVerts; ++i)
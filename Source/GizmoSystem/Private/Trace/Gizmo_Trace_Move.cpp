@@ -1,5 +1,11 @@
 #include "Trace/Gizmo_Trace_Move.h"
 
+#include "Gizmo_Stats.h"
+#include "Math/Gizmo_Math_Base.h"
+#include "Math/Gizmo_Math_Axis_Mask.h"
+
+#include "Engine/World.h"
+
 AGizmoTraceMove::AGizmoTraceMove()
 {
     PrimaryActorTick.bCanEverTick = true;
@@ -10,30 +16,388 @@ AGizmoTraceMove::AGizmoTraceMove()
     XAxis = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("XAxis"));
     XAxis->SetupAttachment(Root);
     XAxis->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-    //XAxis->OnClicked.AddDynamic(this, &AGizmoTraceMove::OnAxisSelected);
 
     YAxis = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("YAxis"));
     YAxis->SetupAttachment(Root);
     YAxis->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-    //YAxis->OnClicked.AddDynamic(this, &AGizmoTraceMove::OnAxisSelected);
 
     ZAxis = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ZAxis"));
     ZAxis->SetupAttachment(Root);
     ZAxis->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-    //ZAxis->OnClicked.AddDynamic(this, &AGizmoTraceMove::OnAxisSelected);
 }
 
 void AGizmoTraceMove::BeginPlay()
 {
     Super::BeginPlay();
+
+    this->GizmoBase = Cast<AGizmoMathBase>(this->GetParentActor());
+
+    if (IsValid(this->GizmoBase))
+    {
+        // Input frame is captured in the base tick.
+        this->AddTickPrerequisiteActor(this->GizmoBase);
+        this->PlayerController = UGameplayStatics::GetPlayerController(this->GetWorld(), this->GizmoBase->PlayerIndex);
+    }
+
+    else
+    {
+        this->PlayerController = UGameplayStatics::GetPlayerController(this->GetWorld(), 0);
+    }
+
+    this->SetupAxis(XAxis);
+    this->SetupAxis(YAxis);
+    this->SetupAxis(ZAxis);
+
+    this->PickTraceDelegate.BindUObject(this, &AGizmoTraceMove::OnPickTraceDone);
+    this->DragTraceDelegate.BindUObject(this, &AGizmoTraceMove::OnDragTraceDone);
 }
 
 void AGizmoTraceMove::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+    if (this->bIsDragging)
+    {
+        this->EndGrab();
+    }
+
+    // Traces still in flight are dropped by the delegates.
+    this->PickTraceDelegate.Unbind();
+    this->DragTraceDelegate.Unbind();
+
     Super::EndPlay(EndPlayReason);
 }
 
 void AGizmoTraceMove::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
-}
\ No newline at end of file
+
+    GIZMO_SCOPE_CYCLE_COUNTER(STAT_Gizmo_MoveSystem);
+
+    const bool bWasMouseDown = this->bMouseDown;
+
+    if (!this->CaptureView() || !this->HasTarget())
+    {
+        if (this->bIsDragging)
+        {
+            this->EndGrab();
+        }
+
+        return;
+    }
+
+    if (this->bIsDragging)
+    {
+        if (!this->bMouseDown)
+        {
+            this->EndGrab();
+        }
+
+        else
+        {
+            this->UpdateDrag();
+            this->IssueDragTrace();
+        }
+    }
+
+    // Pick issued on the press arrived during this frame's async trace processing.
+    else if (this->bPickResultReady)
+    {
+        this->bPickResultReady = false;
+
+        if (this->bMouseDown && this->PickedAxis.IsValid())
+        {
+            this->BeginGrab();
+        }
+    }
+
+    else if (this->bMouseDown && !bWasMouseDown)
+    {
+        this->IssuePickTrace();
+    }
+
+    this->Track();
+}
+
+bool AGizmoTraceMove::CaptureView()
+{
+    if (IsValid(this->GizmoBase))
+    {
+        this->View = this->GizmoBase->InputFrame.View;
+        this->MousePosition = this->GizmoBase->InputFrame.MousePosition;
+    }
+
+    else
+    {
+        float MouseX = 0;
+        float MouseY = 0;
+
+        if (!IsValid(this->PlayerController) || !this->View.Capture(this->PlayerController) || !this->PlayerController->GetMousePosition(MouseX, MouseY))
+        {
+            return false;
+        }
+
+        this->MousePosition = FVector2D(MouseX, MouseY);
+    }
+
+    this->bMouseDown = IsValid(this->PlayerController) && this->PlayerController->IsInputKeyDown(EKeys::LeftMouseButton);
+
+    return this->View.bIsValid;
+}
+
+bool AGizmoTraceMove::HasTarget() const
+{
+    return IsValid(this->GizmoBase) ? this->GizmoBase->HasAnchor() : IsValid(this->Target);
+}
+
+FTransform AGizmoTraceMove::GetTargetTransform() const
+{
+    return IsValid(this->GizmoBase) ? this->GizmoBase->GetAnchorTransform() : this->Target->GetComponentTransform();
+}
+
+FVector AGizmoTraceMove::GetAxisVector(ESelectedAxis Axis) const
+{
+    const FQuat Frame = this->bMoveLocal ? this->GetTargetTransform().GetRotation() : FQuat::Identity;
+    const EGizmoAxisMask Mask = GizmoAxisMaskFromSelected(Axis, GizmoTranslateAxes);
+
+    return GizmoAxisCount(Mask, GizmoTranslateAxes) == 1 ? GizmoAxisSum(Mask, GizmoTranslateAxes, Frame) : FVector::ZeroVector;
+}
+
+ESelectedAxis AGizmoTraceMove::GetAxisEnum(const UPrimitiveComponent* Axis) const
+{
+    if (Axis == nullptr)
+    {
+        return ESelectedAxis::Null_Axis;
+    }
+
+    if (Axis == XAxis)
+    {
+        return ESelectedAxis::X_Axis;
+    }
+
+    if (Axis == YAxis)
+    {
+        return ESelectedAxis::Y_Axis;
+    }
+
+    if (Axis == ZAxis)
+    {
+        return ESelectedAxis::Z_Axis;
+    }
+
+    return ESelectedAxis::Null_Axis;
+}
+
+void AGizmoTraceMove::SetupAxis(UStaticMeshComponent* Axis)
+{
+    if (!IsValid(Axis))
+    {
+        return;
+    }
+
+    // Overlap instead of block, so the pick trace reports axes in front of the first blocking surface without stopping at them.
+    Axis->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+    Axis->SetCollisionResponseToAllChannels(ECR_Ignore);
+    Axis->SetCollisionResponseToChannel(this->TraceChannel, ECR_Overlap);
+    Axis->SetGenerateOverlapEvents(false);
+    Axis->SetCastShadow(false);
+}
+
+void AGizmoTraceMove::GetQueryParams(FCollisionQueryParams& Out_Params, bool bIgnoreSelf) const
+{
+    Out_Params = FCollisionQueryParams(SCENE_QUERY_STAT(GizmoTraceMove), false);
+
+    // Targets never block their own gizmo or the surface under them.
+    if (IsValid(this->GizmoBase))
+    {
+        Out_Params.AddIgnoredActor(this->GizmoBase);
+
+        TArray<USceneComponent*> Targets;
+        this->GizmoBase->GetAllTargets(Targets);
+
+        for (const USceneComponent* EachTarget : Targets)
+        {
+            Out_Params.AddIgnoredActor(EachTarget->GetOwner());
+        }
+    }
+
+    else if (IsValid(this->Target))
+    {
+        Out_Params.AddIgnoredActor(this->Target->GetOwner());
+    }
+
+    if (bIgnoreSelf)
+    {
+        Out_Params.AddIgnoredActor(this);
+    }
+}
+
+void AGizmoTraceMove::IssuePickTrace()
+{
+    FVector RayOrigin;
+    FVector RayDirection;
+
+    if (!this->View.DeprojectScreenToWorld(this->MousePosition, RayOrigin, RayDirection))
+    {
+        return;
+    }
+
+    FCollisionQueryParams QueryParams;
+    this->GetQueryParams(QueryParams, false);
+
+    this->GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Multi, RayOrigin, RayOrigin + RayDirection * this->TraceDistance, this->TraceChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &this->PickTraceDelegate, this->TraceGeneration);
+}
+
+void AGizmoTraceMove::IssueDragTrace()
+{
+    FVector RayOrigin;
+    FVector RayDirection;
+
+    if (!this->View.DeprojectScreenToWorld(this->MousePosition, RayOrigin, RayDirection))
+    {
+        return;
+    }
+
+    FCollisionQueryParams QueryParams;
+    this->GetQueryParams(QueryParams, true);
+
+    this->GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, RayOrigin, RayOrigin + RayDirection * this->TraceDistance, this->TraceChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &this->DragTraceDelegate, this->TraceGeneration);
+}
+
+void AGizmoTraceMove::OnPickTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    if (Datum.UserData != this->TraceGeneration)
+    {
+        return;
+    }
+
+    this->PickedAxis = nullptr;
+    double NearestDistance = TNumericLimits<double>::Max();
+
+    for (const FHitResult& EachHit : Datum.OutHits)
+    {
+        UPrimitiveComponent* HitComponent = EachHit.GetComponent();
+
+        if (this->GetAxisEnum(HitComponent) != ESelectedAxis::Null_Axis && EachHit.Distance < NearestDistance)
+        {
+            this->PickedAxis = HitComponent;
+            this->PickedLocation = EachHit.ImpactPoint;
+            NearestDistance = EachHit.Distance;
+        }
+    }
+
+    this->bPickResultReady = true;
+}
+
+void AGizmoTraceMove::OnDragTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    if (Datum.UserData != this->TraceGeneration)
+    {
+        return;
+    }
+
+    this->bDragResultHit = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit;
+
+    if (this->bDragResultHit)
+    {
+        this->DragHitLocation = Datum.OutHits[0].ImpactPoint;
+    }
+}
+
+void AGizmoTraceMove::BeginGrab()
+{
+    this->AxisEnum = this->GetAxisEnum(this->PickedAxis.Get());
+    this->GrabTargetTransform = this->GetTargetTransform();
+
+    const FVector Origin = this->GrabTargetTransform.GetLocation();
+
+    if (!this->GrabConstraint.InitForAxis(this->View, Origin, this->GetAxisVector(this->AxisEnum)))
+    {
+        this->AxisEnum = ESelectedAxis::Null_Axis;
+        return;
+    }
+
+    // Point on the axis next to where the handle was hit, so the grab itself does not move the target.
+    this->GrabPoint = Origin + this->GrabConstraint.Axis * FVector::DotProduct(this->PickedLocation - Origin, this->GrabConstraint.Axis);
+
+    if (IsValid(this->GizmoBase))
+    {
+        this->GizmoBase->BeginDrag();
+    }
+
+    this->TraceGeneration++;
+    this->bDragResultHit = false;
+    this->SurfaceOffset = FVector::ZeroVector;
+    this->bIsDragging = true;
+}
+
+void AGizmoTraceMove::UpdateDrag()
+{
+    FVector SolvedPoint;
+    const bool bSolved = this->GrabConstraint.Solve(this->View, this->MousePosition, SolvedPoint);
+
+    FVector Point;
+
+    // Surface under the cursor from last tick's trace, projected onto the axis. Empty space falls back to the ray-plane solver.
+    if (this->bDragResultHit)
+    {
+        Point = this->GrabConstraint.Origin + this->GrabConstraint.Axis * FVector::DotProduct(this->DragHitLocation - this->GrabConstraint.Origin, this->GrabConstraint.Axis);
+
+        if (bSolved)
+        {
+            this->SurfaceOffset = Point - SolvedPoint;
+        }
+    }
+
+    else if (bSolved)
+    {
+        Point = SolvedPoint + this->SurfaceOffset;
+    }
+
+    else
+    {
+        return;
+    }
+
+    FGizmoDragDelta Delta;
+    Delta.Translation = Point - this->GrabPoint;
+    Delta.Pivot = this->GrabConstraint.Origin;
+
+    if (IsValid(this->GizmoBase))
+    {
+        this->GizmoBase->ApplyDragDelta(Delta);
+    }
+
+    else
+    {
+        this->Target->SetWorldTransform(Delta.Apply(this->GrabTargetTransform), false, nullptr, ETeleportType::None);
+    }
+}
+
+void AGizmoTraceMove::EndGrab()
+{
+    if (IsValid(this->GizmoBase))
+    {
+        this->GizmoBase->EndDrag();
+    }
+
+    this->TraceGeneration++;
+    this->bDragResultHit = false;
+    this->bIsDragging = false;
+    this->AxisEnum = ESelectedAxis::Null_Axis;
+}
+
+void AGizmoTraceMove::Track()
+{
+    const FTransform TargetTransform = this->GetTargetTransform();
+
+    this->GetRootComponent()->SetWorldRotation(this->bMoveLocal ? TargetTransform.GetRotation() : FQuat::Identity);
+
+    if (IsValid(this->GizmoBase))
+    {
+        this->GizmoBase->GetRootComponent()->SetWorldLocation(TargetTransform.GetLocation(), false, nullptr, ETeleportType::None);
+    }
+
+    else
+    {
+        this->SetActorLocation(TargetTransform.GetLocation());
+    }
+}
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Engine/StreamableManager.h"
+
+#include "Gizmo_Asset_Subsystem.generated.h"
+
+class UStaticMesh;
+class UStaticMeshComponent;
+class UMaterialInterface;
+
+/*
+* Loads gizmo meshes and materials asynchronously, once per engine, and keeps them resident for every gizmo that asked for them.
+* Gizmos only hold soft references, so nothing is loaded while their class default objects are constructed
+* and the cooker only follows the references of gizmo classes that are actually used.
+*/
+UCLASS()
+class GIZMOSYSTEM_API UGizmoAssetSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	FStreamableManager StreamableManager;
+
+	// Keep the requested assets alive after their gizmos are destroyed, so the next spawn is instant.
+	TArray<TSharedPtr<FStreamableHandle>> Handles;
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// Returns nullptr while the engine is not initialized.
+	static UGizmoAssetSubsystem* Get();
+
+	// Calls OnLoaded on the game thread when every path is resident. Immediately if they already are.
+	virtual void RequestAssets(const TArray<FSoftObjectPath>& Paths, FStreamableDelegate OnLoaded);
+
+	// Starts loading without waiting for the result. Call it before the first gizmo spawns to hide the load.
+	virtual void Preload(const TArray<FSoftObjectPath>& Paths);
+
+	// Assigns the mesh and the material only when the handle has none, so Blueprint and SetArrowMesh overrides are kept.
+	static void ApplyToHandle(UStaticMeshComponent* Handle, const TSoftObjectPtr<UStaticMesh>& Mesh, const TSoftObjectPtr<UMaterialInterface>& Material);
+
+};
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "Gizmo_Benchmark_Commandlet.generated.h"
+
+// Result of one scripted scenario. Values are per frame, allocations are the game thread's.
+struct FGizmoBenchmarkResult
+{
+	FString Name;
+	double MsPerFrame = 0;
+	double AllocsPerFrame = 0;
+	double TransformUpdatesPerFrame = 0;
+
+	// Absolute budget checked on top of the baseline. 0 has none.
+	double MaxMsPerFrame = 0;
+
+	// Set when the scenario could not run to the end. Its values are not meaningful and it counts as a regression.
+	bool bFailed = false;
+};
+
+/*
+* Headless performance run of the gizmo hot paths. Drives move, rotate, SetExtents and snap queries with injected input and compares against Config/GizmoBenchmarkBaseline.csv.
+* UnrealEditor-Cmd <Project> -run=GizmoBenchmark -nullrhi -unattended [-Frames=N] [-Tolerance=0.25] [-Filter=Move] [-WriteBaseline]
+* -Replay=<path> runs a recorded input session instead of the scripted scenarios and fails when the targets diverge from the recording.
+* Returns non zero when a scenario fails, regresses, goes over its absolute budget or has no measured baseline.
+*/
+UCLASS()
+class GIZMOSYSTEM_API UGizmoBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual UWorld* CreateBenchmarkWorld();
+	virtual void DestroyBenchmarkWorld(UWorld* World);
+
+	virtual FGizmoBenchmarkResult RunGizmoScenario(const FString& Name, UClass* GizmoClass, int32 NumTargets, bool bMoveLocal);
+	virtual FGizmoBenchmarkResult RunExtentsScenario(const FString& Name, int32 NumCorners);
+
+	// One screen query per frame against a hash of NumPoints points. A frame is a single query, budgeted at 0.1 ms.
+	virtual FGizmoBenchmarkResult RunSnapScenario(const FString& Name, int32 NumPoints);
+
+	// Sends one transform batch for every target per frame through the control channel and waits for its ack. Has to apply at least 20000 transforms per second.
+	virtual FGizmoBenchmarkResult RunControlScenario(const FString& Name, int32 NumTargets);
+
+	// Plays every recorded frame. Out_NumMismatches counts the frames whose target transforms are not bit-identical to the recording.
+	virtual FGizmoBenchmarkResult RunReplayScenario(const FString& Name, const FString& RecordingPath, int32& Out_NumMismatches);
+
+	virtual FString GetBaselinePath() const;
+	virtual bool LoadBaseline(TMap<FString, FGizmoBenchmarkResult>& Out_Baseline) const;
+	virtual bool SaveBaseline(const TArray<FGizmoBenchmarkResult>& Results) const;
+
+	int32 NumFrames = 240;
+	int32 NumWarmupFrames = 16;
+	double Tolerance = 0.25;
+
+public:
+
+	UGizmoBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+};
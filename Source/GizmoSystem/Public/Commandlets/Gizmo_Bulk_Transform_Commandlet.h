@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "Gizmo_Bulk_Transform_Commandlet.generated.h"
+
+class UWorld;
+class AActor;
+class UPackage;
+
+// Point the rotation and scale of a bulk pass happen about.
+enum class EGizmoBulkPivot : uint8
+{
+	// Center of the bounds of the selected actors' locations, per level.
+	Selection,
+
+	// Every actor about its own location.
+	Each,
+
+	// A fixed world location.
+	Fixed,
+};
+
+// Selection and operation of one run, parsed once from the command line.
+struct FGizmoBulkTransformSettings
+{
+	// Selection. Every set filter has to match, at least one is required. Class is a native class name or a class path, /Game/BP_Door.BP_Door_C for Blueprints.
+	UClass* Class = nullptr;
+	FName Tag;
+
+	// Name or label of an actor in the same level with a UCustomCollision. Actors whose location is inside its hull are selected.
+	FString Volume;
+
+	FVector Offset = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	FVector ScaleRatio = FVector::OneVector;
+
+	EGizmoBulkPivot PivotMode = EGizmoBulkPivot::Selection;
+	FVector Pivot = FVector::ZeroVector;
+
+	// Absolute world grid for locations, degrees for rotations, scale steps. 0 disables each.
+	double GridSize = 0;
+	double RotationSnap = 0;
+	double ScaleSnap = 0;
+
+	bool bDryRun = false;
+
+	// Levels loaded together. Their packages are saved and garbage collected together before the next batch.
+	int32 BatchSize = 16;
+};
+
+/*
+* Applies the gizmo solvers to every selected actor of many levels without opening the editor. Editor builds only.
+* UnrealEditor-Cmd <Project> -run=GizmoBulkTransform -unattended (-Maps=/Game/A+/Game/B | -MapPath=/Game/Maps)
+*	[-Class=StaticMeshActor] [-Tag=Name] [-Volume=ActorName]
+*	[-Offset=X,Y,Z] [-Rotate=Pitch,Yaw,Roll] [-Scale=X,Y,Z] [-Pivot=Selection|Each|X,Y,Z] [-Grid=N] [-RotationSnap=N] [-ScaleSnap=N]
+*	[-Batch=16] [-DryRun]
+* Returns non zero when an argument is malformed or a level could not be loaded or saved. World Partition levels only have their always loaded actors visited.
+*/
+UCLASS()
+class GIZMOSYSTEM_API UGizmoBulkTransformCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+
+	virtual bool ParseSettings(const FString& Params, FGizmoBulkTransformSettings& Out_Settings) const;
+	virtual bool GatherMaps(const FString& Params, TArray<FString>& Out_PackageNames) const;
+
+	virtual void InitializeLevel(UWorld* World);
+	virtual void CleanupLevel(UWorld* World);
+
+	virtual int32 SelectActors(UWorld* World, const FGizmoBulkTransformSettings& Settings, TArray<AActor*>& Out_Actors) const;
+
+	// Returns the number of actors that moved. Their packages, external actor packages included, are added to Out_DirtyPackages.
+	virtual int32 TransformActors(const TArray<AActor*>& Actors, const FGizmoBulkTransformSettings& Settings, TSet<UPackage*>& Out_DirtyPackages) const;
+
+	virtual int32 SavePackages(const TSet<UPackage*>& Packages) const;
+
+public:
+
+	UGizmoBulkTransformCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+};
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Gizmo_Enums.h"
+
+struct FGizmoDiagnosticEvent
+{
+	EGizmoDiagnostic Reason = EGizmoDiagnostic::Max;
+
+	// Same reason reported on consecutive calls is folded into one event.
+	uint32 Count = 0;
+	uint64 FirstFrame = 0;
+	uint64 LastFrame = 0;
+	double LastTime = 0;
+};
+
+// Fixed size history of why a gizmo skipped its update. Reporting does not allocate, so it can run every frame.
+class GIZMOSYSTEM_API FGizmoDiagnostics
+{
+public:
+
+	FGizmoDiagnostics();
+	~FGizmoDiagnostics();
+
+	FGizmoDiagnostics(const FGizmoDiagnostics&) = delete;
+	FGizmoDiagnostics& operator=(const FGizmoDiagnostics&) = delete;
+
+	// Name and world of Owner are used by the on-screen line and the dump.
+	void SetOwner(const UObject* In_Owner);
+
+	void Report(EGizmoDiagnostic Reason);
+	void Reset();
+
+	// Updates one keyed on-screen line with the latest event, at most a few times per second.
+	void ShowOnScreen();
+
+	void Dump(FOutputDevice& Ar) const;
+
+	uint32 GetTotal(EGizmoDiagnostic Reason) const;
+
+	static const TCHAR* GetReasonText(EGizmoDiagnostic Reason);
+
+	// Gizmo.DumpDiagnostics
+	static void DumpAll(FOutputDevice& Ar);
+
+	static constexpr int32 Capacity = 32;
+
+private:
+
+	FGizmoDiagnosticEvent Events[Capacity];
+	int32 Head = 0;
+	int32 Num = 0;
+
+	uint32 Totals[(int32)EGizmoDiagnostic::Max] = {};
+
+	TWeakObjectPtr<const UObject> Owner;
+	double LastShownTime = 0;
+
+};
@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Gizmo_Enums.h"
+
+#include <atomic>
+
+#include "Gizmo_Telemetry.generated.h"
+
+USTRUCT(BlueprintType)
+struct GIZMOSYSTEM_API FGizmoTelemetrySummary
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 Count = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	float Mean = 0;
+
+	// Percentiles are read from the histogram and are exact to about 6 percent.
+	UPROPERTY(BlueprintReadOnly)
+	float P50 = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	float P95 = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	float P99 = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	float Max = 0;
+
+	// Drag latency samples above Gizmo.Telemetry.LatencyBudgetMs. Zero for the other metrics.
+	UPROPERTY(BlueprintReadOnly)
+	int64 NumOverBudget = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int64 NumDrags = 0;
+};
+
+/*
+* Log-linear histogram of non negative integers. 8 buckets per power of two, so every bucket is within 1/8 of its value.
+* Recording is a few relaxed atomic adds, any thread can record while another one reads.
+*/
+class GIZMOSYSTEM_API FGizmoHistogram
+{
+public:
+
+	void Record(uint64 Value);
+	void Reset();
+
+	uint64 GetCount() const;
+	uint64 GetSum() const;
+	uint64 GetMax() const;
+
+	// Middle of the bucket that holds the given fraction (0 - 1) of all values.
+	uint64 GetPercentile(double Fraction) const;
+
+	uint64 GetBucketCount(int32 BucketIndex) const;
+
+	static int32 GetBucketIndex(uint64 Value);
+	static uint64 GetBucketLow(int32 BucketIndex);
+	static uint64 GetBucketHigh(int32 BucketIndex);
+
+	static constexpr int32 SubBucketBits = 3;
+	static constexpr int32 MaxExponent = 40;
+	static constexpr int32 NumBuckets = (MaxExponent - SubBucketBits + 2) << SubBucketBits;
+
+private:
+
+	std::atomic<uint64> Buckets[NumBuckets] = {};
+	std::atomic<uint64> Count = 0;
+	std::atomic<uint64> Sum = 0;
+	std::atomic<uint64> Max = 0;
+
+};
+
+// Drag responsiveness of one gizmo base. Every value is also recorded into the global aggregate.
+class GIZMOSYSTEM_API FGizmoTelemetry
+{
+public:
+
+	FGizmoTelemetry();
+	~FGizmoTelemetry();
+
+	FGizmoTelemetry(const FGizmoTelemetry&) = delete;
+	FGizmoTelemetry& operator=(const FGizmoTelemetry&) = delete;
+
+	// Name of Owner is used by the dump.
+	void SetOwner(const UObject* In_Owner);
+
+	// Any thread.
+	void Record(EGizmoTelemetryMetric Metric, uint64 Value);
+	void RecordDrag();
+
+	void Reset();
+
+	FGizmoTelemetrySummary GetSummary(EGizmoTelemetryMetric Metric) const;
+	const FGizmoHistogram& GetHistogram(EGizmoTelemetryMetric Metric) const;
+
+	static FGizmoTelemetry& GetGlobal();
+
+	static const TCHAR* GetMetricName(EGizmoTelemetryMetric Metric);
+
+	// Gizmo.DumpTelemetry [Path]. One summary row per gizmo and metric, plus the non empty buckets in <Path>_Buckets.csv.
+	static bool DumpAll(const FString& Path);
+
+	// Saved/Gizmo/GizmoTelemetry_<timestamp>.csv
+	static FString GetDefaultPath();
+
+private:
+
+	explicit FGizmoTelemetry(bool In_bIsGlobal);
+
+	FGizmoHistogram Histograms[(int32)EGizmoTelemetryMetric::Max];
+	std::atomic<uint64> NumDrags = 0;
+	std::atomic<uint64> NumOverBudget = 0;
+
+	TWeakObjectPtr<const UObject> Owner;
+	bool bIsGlobal = false;
+
+};
+
+// Records the time from construction to the end of the scope.
+class FGizmoTelemetryTimer
+{
+public:
+
+	FGizmoTelemetryTimer(FGizmoTelemetry& In_Telemetry, EGizmoTelemetryMetric In_Metric) : Telemetry(In_Telemetry), Metric(In_Metric), StartCycles(FPlatformTime::Cycles64())
+	{
+
+	}
+
+	~FGizmoTelemetryTimer()
+	{
+		this->Telemetry.Record(this->Metric, (uint64)(FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - this->StartCycles) * 1000000));
+	}
+
+private:
+
+	FGizmoTelemetry& Telemetry;
+	EGizmoTelemetryMetric Metric;
+	uint64 StartCycles;
+
+};
@@ -8,8 +8,13 @@
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
 
+#include "Gizmo_Enums.h"
+#include "Debug/Gizmo_Telemetry.h"
+
 #include "GizmoSystemBPLibrary.generated.h"
 
+class AGizmoMathBase;
+
 UCLASS()
 class UGizmoSystemBPLibrary : public UBlueprintFunctionLibrary
 {
@@ -21,7 +26,34 @@ class UGizmoSystemBPLibrary : public UBlueprintFunctionLibrary
 	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Is Vectors Coincident", ToolTip = "See if two normal vectors are coincident (nearly parallel and point in the same direction).", Keywords = "vector, math, coincident"), Category = "FF_GizmoSystem")
 	static bool IsVectorsCoincident(const FVector V1, const FVector V2, float ParallelCosineThreshold);
 
-	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Is Vectors Coincident", ToolTip = "See if two normal vectors are coincident (nearly parallel and point in the same direction).", Keywords = "vector, math, coincident"), Category = "FF_GizmoSystem")
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Add Local Rotation With Quat", ToolTip = "Rotates a component around a local axis by an angle in degrees.", Keywords = "rotation, quat, local, axis, angle"), Category = "FF_GizmoSystem")
 	static void AddLocalRotWithQuat(USceneComponent* TargetObject, const FVector RotationAxis, float RotationAngle);
 
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Is Vectors Parallel (Batch)", ToolTip = "Is Vectors Parallel for every pair of V1 and V2, four pairs at a time. A single element array is used for every pair.", Keywords = "vector, math, parallel, batch, array"), Category = "FF_GizmoSystem")
+	static bool IsVectorsParallelBatch(const TArray<FVector>& V1, const TArray<FVector>& V2, float ParallelCosineThreshold, TArray<bool>& Out_Mask);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Is Vectors Coincident (Batch)", ToolTip = "Is Vectors Coincident for every pair of V1 and V2, four pairs at a time. A single element array is used for every pair.", Keywords = "vector, math, coincident, batch, array"), Category = "FF_GizmoSystem")
+	static bool IsVectorsCoincidentBatch(const TArray<FVector>& V1, const TArray<FVector>& V2, float ParallelCosineThreshold, TArray<bool>& Out_Mask);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Axis Angle To Quat (Batch)", ToolTip = "Converts axes and angles in degrees to quaternions, four at a time. Axes are normalized, zero axes give identity. A single element array is used for every entry.", Keywords = "rotation, quat, axis, angle, batch, array"), Category = "FF_GizmoSystem")
+	static bool AxisAngleToQuatBatch(const TArray<FVector>& RotationAxes, const TArray<float>& RotationAngles, TArray<FQuat>& Out_Quats);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Add Local Rotation With Quat (Batch)", ToolTip = "Add Local Rotation With Quat for every component. Rotations of a component listed more than once are combined and written once. A single element axis or angle array is used for every component.", Keywords = "rotation, quat, local, axis, angle, batch, array"), Category = "FF_GizmoSystem")
+	static int32 AddLocalRotWithQuatBatch(const TArray<USceneComponent*>& TargetObjects, const TArray<FVector>& RotationAxes, const TArray<float>& RotationAngles);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Replay Gizmo Journal", ToolTip = "Applies the last journaled transform of every target that can be found in the world of the context object. Components of actors spawned at runtime can not be found in another session. Empty path uses Saved/Gizmo/GizmoJournal.bin. Returns the number of targets changed.", Keywords = "gizmo, journal, recovery, crash", WorldContext = "WorldContextObject"), Category = "FF_GizmoSystem")
+	static int32 ReplayGizmoJournal(const UObject* WorldContextObject, const FString& JournalPath);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Preload Gizmo Assets", ToolTip = "Starts streaming the meshes and materials of a gizmo class in the background, so its first spawn does not wait for them. The base gizmo class preloads its move, rotate and scale children.", Keywords = "gizmo, preload, async, stream"), Category = "FF_GizmoSystem")
+	static void PreloadGizmoAssets(TSubclassOf<AActor> GizmoClass);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Get Gizmo Telemetry", ToolTip = "Count, mean, percentiles and max of a drag metric. Times are in milliseconds. Without a gizmo base the aggregate of every gizmo is returned.", Keywords = "gizmo, telemetry, latency, histogram, performance"), Category = "FF_GizmoSystem")
+	static FGizmoTelemetrySummary GetGizmoTelemetry(const AGizmoMathBase* GizmoBase, EGizmoTelemetryMetric Metric);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Reset Gizmo Telemetry", ToolTip = "Clears the telemetry of a gizmo base. Without a gizmo base the aggregate of every gizmo is cleared.", Keywords = "gizmo, telemetry, reset"), Category = "FF_GizmoSystem")
+	static void ResetGizmoTelemetry(AGizmoMathBase* GizmoBase);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Dump Gizmo Telemetry", ToolTip = "Writes the telemetry of every gizmo to CSV, like Gizmo.DumpTelemetry. Empty path uses Saved/Gizmo/GizmoTelemetry_<timestamp>.csv.", Keywords = "gizmo, telemetry, csv, dump"), Category = "FF_GizmoSystem")
+	static bool DumpGizmoTelemetry(const FString& Path);
+
 };
\ No newline at end of file
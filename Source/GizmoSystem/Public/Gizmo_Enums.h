@@ -12,4 +12,66 @@ enum class ESelectedAxis : uint8
 	YZ_Axis		UMETA(DisplayName = "YZ Axis"),
 	XYZ_Axis	UMETA(DisplayName = "XYZ Axis"),
 };
-ENUM_CLASS_FLAGS(ESelectedAxis)
\ No newline at end of file
+
+// One bit per constrained axis. Any combination is solved by the same code, see Math/Gizmo_Math_Axis_Mask.h.
+UENUM(meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EGizmoAxisMask : uint16
+{
+	None			= 0			UMETA(Hidden),
+	Translate_X		= 1 << 0	UMETA(DisplayName = "Translate X"),
+	Translate_Y		= 1 << 1	UMETA(DisplayName = "Translate Y"),
+	Translate_Z		= 1 << 2	UMETA(DisplayName = "Translate Z"),
+	Rotate_X		= 1 << 3	UMETA(DisplayName = "Rotate X"),
+	Rotate_Y		= 1 << 4	UMETA(DisplayName = "Rotate Y"),
+	Rotate_Z		= 1 << 5	UMETA(DisplayName = "Rotate Z"),
+	Scale_X			= 1 << 6	UMETA(DisplayName = "Scale X"),
+	Scale_Y			= 1 << 7	UMETA(DisplayName = "Scale Y"),
+	Scale_Z			= 1 << 8	UMETA(DisplayName = "Scale Z"),
+	Screen			= 1 << 9	UMETA(DisplayName = "Screen"),
+	View_Plane		= 1 << 10	UMETA(DisplayName = "View Plane"),
+};
+ENUM_CLASS_FLAGS(EGizmoAxisMask)
+
+UENUM(BlueprintType)
+enum class EScalePivot : uint8
+{
+	// Every target about its own location.
+	Target_Origin		UMETA(DisplayName = "Target Origin"),
+
+	// All targets about the gizmo's location, along the gizmo's axes.
+	Gizmo_Origin		UMETA(DisplayName = "Gizmo Origin"),
+
+	// All targets about the average of their locations, along the anchor's axes.
+	Selection_Center	UMETA(DisplayName = "Selection Center"),
+};
+
+UENUM(BlueprintType)
+enum class EGizmoDiagnostic : uint8
+{
+	Base_Invalid	UMETA(DisplayName = "Base Invalid"),
+	Target_Invalid	UMETA(DisplayName = "Target Invalid"),
+	No_Movement		UMETA(DisplayName = "No Movement"),
+	Not_In_View		UMETA(DisplayName = "Not In View"),
+	Forbidden_Key	UMETA(DisplayName = "Forbidden Key"),
+	Not_Visible		UMETA(DisplayName = "Not Visible"),
+	Max				UMETA(Hidden),
+};
+
+// Times are recorded in microseconds and reported in milliseconds, the others per drag frame.
+UENUM(BlueprintType)
+enum class EGizmoTelemetryMetric : uint8
+{
+	Drag_Latency		UMETA(DisplayName = "Drag Latency"),
+	Solver_Time			UMETA(DisplayName = "Solver Time"),
+	Transform_Writes	UMETA(DisplayName = "Transform Writes"),
+	Coalesced_Samples	UMETA(DisplayName = "Coalesced Samples"),
+	Max					UMETA(Hidden),
+};
+
+UENUM(BlueprintType)
+enum class EGizmoSplineHandle : uint8
+{
+	Point			UMETA(DisplayName = "Point"),
+	Arrive_Tangent	UMETA(DisplayName = "Arrive Tangent"),
+	Leave_Tangent	UMETA(DisplayName = "Leave Tangent"),
+};
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// "stat GizmoSystem" in game, "-trace=cpu,gizmo" for Insights.
+DECLARE_STATS_GROUP(TEXT("GizmoSystem"), STATGROUP_GizmoSystem, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Base Tick"), STAT_Gizmo_BaseTick, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Capture Input"), STAT_Gizmo_CaptureInput, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Size Scaling"), STAT_Gizmo_SizeScaling, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hover"), STAT_Gizmo_Hover, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pick Handle"), STAT_Gizmo_PickHandle, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Transform Check"), STAT_Gizmo_TransformCheck, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Move System"), STAT_Gizmo_MoveSystem, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Rotate System"), STAT_Gizmo_RotateSystem, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scale System"), STAT_Gizmo_ScaleSystem, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply To Targets"), STAT_Gizmo_ApplyToTargets, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Collision"), STAT_Gizmo_UpdateCollision, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Collision Proxy Draw"), STAT_Gizmo_ProxyDraw, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Late Latch"), STAT_Gizmo_LateLatch, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Snap Gather"), STAT_Gizmo_SnapGather, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Snap Build"), STAT_Gizmo_SnapBuild, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Snap Query"), STAT_Gizmo_SnapQuery, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Marquee Gather"), STAT_Gizmo_MarqueeGather, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Marquee Select"), STAT_Gizmo_MarqueeSelect, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Transform Writes"), STAT_Gizmo_TransformWrites, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Collision Cooks"), STAT_Gizmo_Cooks, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Lines Drawn"), STAT_Gizmo_LinesDrawn, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Picks"), STAT_Gizmo_Picks, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Instance Batch Updates"), STAT_Gizmo_InstanceBatches, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Surface Traces"), STAT_Gizmo_SurfaceTraces, STATGROUP_GizmoSystem, GIZMOSYSTEM_API);
+
+// Dedicated channel, so gizmo scopes can be recorded without the rest of the cpu channel.
+UE_TRACE_CHANNEL_EXTERN(GizmoChannel, GIZMOSYSTEM_API);
+
+// Stat and Insights scope together. Stats compile out of Test and Shipping. The trace scope stays in Test and compiles out of Shipping unless the target enables trace there.
+#define GIZMO_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(#Stat, GizmoChannel)
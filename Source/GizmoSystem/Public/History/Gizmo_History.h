@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class USceneComponent;
+
+// Per-target change of one drag. Translation in 1/100 units, rotation as a 16 bit quaternion, scale in 1/10000.
+struct FGizmoQuantizedDelta
+{
+	int32 Translation[3] = {};
+	int16 Rotation[4] = {};
+	int32 Scale[3] = {};
+
+	static FGizmoQuantizedDelta Quantize(const FTransform& Start, const FTransform& End);
+
+	// Redo applies the delta to Current, undo applies its inverse.
+	FTransform Apply(const FTransform& Current, bool bInverse) const;
+
+	bool IsIdentity() const;
+	bool operator==(const FGizmoQuantizedDelta& Other) const;
+};
+
+// True when an ancestor of Target is in Targets and Target follows it in location, rotation and scale.
+GIZMOSYSTEM_API bool GizmoIsCarriedByTarget(const USceneComponent* Target, const TSet<const USceneComponent*>& Targets);
+
+// Undo and redo of gizmo drags. One entry per drag, stored as target set plus quantized deltas in two fixed size rings.
+// Oldest entries are evicted when a ring is full, so memory never grows past the capacity.
+// Targets carried by a targeted ancestor are not recorded, the ancestor's delta moves them.
+class GIZMOSYSTEM_API FGizmoHistory
+{
+public:
+
+	// Resizing drops the recorded history. Setting the current capacity again keeps it.
+	void SetCapacity(int64 In_CapacityBytes);
+
+	// Records the change from StartTransforms to the current transforms of Targets. Drops everything that could be redone.
+	bool Commit(TConstArrayView<TWeakObjectPtr<USceneComponent>> Targets, TConstArrayView<FTransform> StartTransforms);
+
+	// Out_Targets receives the targets that were written, if given.
+	bool Undo(TArray<USceneComponent*>* Out_Targets = nullptr);
+	bool Redo(TArray<USceneComponent*>* Out_Targets = nullptr);
+
+	bool CanUndo() const;
+	bool CanRedo() const;
+
+	void Reset();
+
+	int32 GetNumEntries() const;
+	int64 GetUsedBytes() const;
+
+	// Upper bound for entries, so the descriptor array stays flat as well.
+	static constexpr int32 MaxEntries = 1024;
+
+private:
+
+	struct FEntry
+	{
+		int32 TargetOffset = 0;
+		int32 DeltaOffset = 0;
+		int32 NumTargets = 0;
+
+		// All targets moved by the same delta, only one is stored.
+		bool bSharedDelta = false;
+
+		int32 GetNumDeltas() const { return this->bSharedDelta ? 1 : this->NumTargets; }
+	};
+
+	// Places NumTargets targets and NumDeltas deltas after the newest entry, evicting the oldest entries in the way.
+	bool Allocate(int32 NumTargets, int32 NumDeltas, int32& Out_TargetOffset, int32& Out_DeltaOffset);
+
+	bool ApplyEntry(const FEntry& Entry, bool bInverse, TArray<USceneComponent*>* Out_Targets);
+
+	// Sized together from the capacity, one slot each per target, so a drag whose deltas all differ still fits.
+	TArray<TWeakObjectPtr<USceneComponent>> TargetRing;
+	TArray<FGizmoQuantizedDelta> DeltaRing;
+	TArray<FEntry> Entries;
+
+	int64 CapacityBytes = 0;
+
+	// Entries before this index are applied and can be undone.
+	int32 Cursor = 0;
+
+};
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include "UObject/ObjectKey.h"
+
+#include <atomic>
+
+class USceneComponent;
+class UWorld;
+class IFileHandle;
+
+enum class EGizmoJournalStatus : uint8
+{
+	Open,
+	File_Failed,
+	Thread_Failed,
+	Write_Failed,
+};
+
+struct FGizmoJournalRecord
+{
+	// Path name of the target component, without the PIE prefix.
+	FString TargetPath;
+	FTransform Transform;
+};
+
+/*
+* Append-only binary log of committed gizmo edits. Records are queued by the game thread and written and flushed by a background thread.
+* Layout : header, then per record [payload size][payload][crc32 of payload]. A torn record at the end (crash while writing) fails its crc and ends the replay.
+* An existing file with another header is moved aside and a new one is started. Truncate empties the file once everything queued before it is written.
+* Opened through UGizmoJournalSubsystem, so there is only one writer per file.
+* Targets are found again by path, so components of actors spawned at runtime can not be replayed in another session.
+*/
+class GIZMOSYSTEM_API FGizmoJournal : public FRunnable
+{
+public:
+
+	FGizmoJournal(const FString& In_FilePath);
+	virtual ~FGizmoJournal() override;
+
+	bool IsOpen() const;
+	EGizmoJournalStatus GetStatus() const;
+	const FString& GetFilePath() const;
+
+	// Game thread. Resolves the paths of Targets ahead of Append, so committing a large drag does not build them.
+	void CachePaths(TConstArrayView<USceneComponent*> Targets);
+
+	// Game thread. Queues the current world transform of Target.
+	void Append(const USceneComponent* Target);
+
+	// Game thread. Drops every record queued or written so far, e.g. once the edits they hold are saved.
+	void Truncate();
+
+	// Reads all intact records through a memory mapped view of the file.
+	static bool Read(const FString& FilePath, TArray<FGizmoJournalRecord>& Out_Records);
+
+	// Applies the last recorded transform of every target that can be found. Paths are resolved in World's PIE instance when World is a PIE world.
+	// Returns the number of targets changed.
+	static int32 Replay(const FString& FilePath, const UWorld* World = nullptr);
+
+	static FString GetDefaultPath();
+
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+
+	// Background thread. Serializes everything queued so far and flushes once.
+	void WritePending();
+
+	// Background thread. Starts the file over with only the header.
+	bool Reopen();
+
+	// Writes and flushes. False and the journal stops when the file could not be written.
+	bool WriteAndFlush(const uint8* Data, int64 Size);
+
+	// Game thread only.
+	const FString& GetTargetPath(const USceneComponent* Target);
+
+	FString FilePath;
+	TUniquePtr<IFileHandle> File;
+	std::atomic<EGizmoJournalStatus> Status = EGizmoJournalStatus::File_Failed;
+
+	// Grows with every distinct target journaled in the session.
+	TMap<TObjectKey<USceneComponent>, FString> PathCache;
+
+	// A record without a target path marks a Truncate.
+	TQueue<FGizmoJournalRecord, EQueueMode::Spsc> Pending;
+	TArray<uint8> WriteBuffer;
+
+	FEvent* WakeEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+	std::atomic<bool> bStopping = false;
+
+};
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+
+#include "Gizmo_Journal_Subsystem.generated.h"
+
+class FGizmoJournal;
+class UPackage;
+class FObjectPostSaveContext;
+
+/*
+* Owns the open gizmo journals, one per file for the whole process, so gizmos journaling to the same path share a single writer.
+* A journal is truncated when its last gizmo ends play with the session (quit or end of PIE), when the engine shuts down and after a map is saved,
+* so ReplayGizmoJournal only ever sees the edits of a session that did not end cleanly.
+*/
+UCLASS()
+class GIZMOSYSTEM_API UGizmoJournalSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	struct FOpenJournal
+	{
+		TSharedPtr<FGizmoJournal> Journal;
+		int32 NumUsers = 0;
+	};
+
+	// Keyed by full file path.
+	TMap<FString, FOpenJournal> Journals;
+
+#if WITH_EDITOR
+	FDelegateHandle PackageSavedHandle;
+
+	virtual void OnPackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext SaveContext);
+#endif
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Returns nullptr while the engine is not initialized.
+	static UGizmoJournalSubsystem* Get();
+
+	// Opens the journal at FilePath on first use and shares it with every later caller. Empty uses Saved/Gizmo/GizmoJournal.bin.
+	virtual TSharedPtr<FGizmoJournal> AcquireJournal(const FString& FilePath);
+
+	// Closes the journal once its last user released it. bSessionEnded truncates it first, there is nothing left to recover.
+	virtual void ReleaseJournal(const TSharedPtr<FGizmoJournal>& Journal, bool bSessionEnded);
+
+	// Truncates every open journal. Call it once the edits they hold are saved, e.g. after writing a save game.
+	UFUNCTION(BlueprintCallable)
+	virtual void CheckpointJournals();
+
+};
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/Application/IInputProcessor.h"
+
+// Records every cursor move Slate receives between two game frames, so gizmos can integrate them in order instead of one per-frame delta.
+class GIZMOSYSTEM_API FGizmoInputProcessor : public IInputProcessor
+{
+public:
+
+	virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override;
+	virtual bool HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	virtual const TCHAR* GetDebugName() const override;
+
+	// Moves all pending samples (desktop space, oldest first) into Out_Samples. Out_OldestTime is the platform time the first of them arrived, zero when there were none.
+	void ConsumeSamples(TArray<FVector2D>& Out_Samples, double& Out_OldestTime);
+
+	// Samples merged into the newest one because the buffer was full.
+	int32 GetNumCoalesced() const;
+
+	// Newest cursor position in desktop space. Safe to call from the render thread.
+	bool GetLatestScreenPosition(FVector2D& Out_ScreenPosition) const;
+
+	// Upper bound for samples kept between two consumes.
+	static constexpr int32 MaxPendingSamples = 256;
+
+private:
+
+	TArray<FVector2D> PendingSamples;
+	double OldestPendingTime = 0;
+	int32 NumCoalesced = 0;
+
+	mutable FCriticalSection LatestLock;
+	FVector2D LatestScreenPosition = FVector2D::ZeroVector;
+	bool bHasLatestScreenPosition = false;
+
+};
@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InputCoreTypes.h"
+
+#include "Gizmo_Enums.h"
+#include "Math/Gizmo_Math_Solver.h"
+
+class AGizmoMathBase;
+class USceneComponent;
+
+// One recorded base tick. Keys and axis are complete here, the file only stores them when they change.
+struct FGizmoInputRecordFrame
+{
+	float DeltaTime = 0;
+	FGizmoInputFrame Input;
+	TArray<FKey> Keys;
+	ESelectedAxis Axis = ESelectedAxis::Null_Axis;
+
+	// Index into FGizmoInputRecording::TargetSnapshots when the target set changed on this frame, otherwise INDEX_NONE.
+	int32 TargetSnapshot = INDEX_NONE;
+
+	// Crc of the target transforms before this frame was applied.
+	uint32 TargetChecksum = 0;
+};
+
+struct FGizmoInputRecording
+{
+	FString GizmoClassPath;
+
+	// bMoveLocal or bRotateLocal of the child gizmo, or its ScalePivot. Every other setting comes from the class defaults.
+	uint8 ChildMode = 0;
+
+	TArray<FGizmoInputRecordFrame> Frames;
+
+	// World transforms of the targets, in GetAllTargets order.
+	TArray<TArray<FTransform>> TargetSnapshots;
+
+	// Crc of the target transforms after the last frame.
+	uint32 FinalChecksum = 0;
+	bool bHasFinalChecksum = false;
+};
+
+/*
+* Records the input a gizmo base consumes, one record per tick, so a drag can be replayed headless with bit-identical results.
+* Layout : header [magic][version][gizmo class][mode], then per frame [flags][delta time][mouse position][target crc] followed by the fields named in flags.
+* View, keys, axis and targets are only written when they changed. The cursor ray is not stored, it is deprojected from the view on replay.
+*/
+class GIZMOSYSTEM_API FGizmoInputRecorder
+{
+public:
+
+	FGizmoInputRecorder(const FString& In_FilePath);
+
+	// Writes the end record with the final target crc.
+	~FGizmoInputRecorder();
+
+	bool IsOpen() const;
+
+	// Game thread. Call after the base captured its input frame, before the child gizmo ticks.
+	void RecordFrame(const AGizmoMathBase* Base, float DeltaTime);
+
+	static bool Read(const FString& FilePath, FGizmoInputRecording& Out_Recording);
+
+	static uint32 GetTargetsChecksum(TConstArrayView<USceneComponent*> Targets);
+
+	// Saved/Gizmo/GizmoInput_<timestamp>.gzr, so a session never overwrites the previous one.
+	static FString GetDefaultPath();
+
+private:
+
+	void WriteHeader(const AGizmoMathBase* Base);
+
+	FString FilePath;
+	TUniquePtr<FArchive> Writer;
+	bool bHeaderWritten = false;
+
+	// State written last, fields are only written again when they differ.
+	FGizmoViewState LastView;
+	bool bHasLastView = false;
+	TArray<FKey> LastKeys;
+	ESelectedAxis LastAxis = ESelectedAxis::Null_Axis;
+	TArray<TWeakObjectPtr<USceneComponent>> LastTargets;
+
+	// Reused every frame.
+	TArray<USceneComponent*> Targets;
+
+	int32 NumFrames = 0;
+
+};
+
+/*
+* Drives a new gizmo base in World from a recording. Call ApplyFrame before each world tick and Finish after the last one.
+* Targets are spawned flat on one holder actor, so recordings with parented targets only match when the parents were not targets too.
+*/
+class GIZMOSYSTEM_API FGizmoInputReplayer
+{
+public:
+
+	FGizmoInputReplayer(const FGizmoInputRecording& In_Recording);
+
+	// Spawns the gizmo base, its child gizmo and enough targets for the largest snapshot.
+	bool Begin(UWorld* World);
+
+	// Checks the targets against the recorded crc, then injects the frame. Returns the delta time to tick the world with.
+	float ApplyFrame(int32 FrameIndex);
+
+	// Checks the final crc. Returns true when every frame matched.
+	bool Finish();
+
+	AGizmoMathBase* GetGizmoBase() const;
+	TConstArrayView<USceneComponent*> GetTargetPool() const;
+
+	int32 GetNumMismatches() const;
+
+private:
+
+	bool CheckTargets(uint32 Expected, int32 FrameIndex);
+
+	const FGizmoInputRecording& Recording;
+
+	TWeakObjectPtr<AGizmoMathBase> GizmoBase;
+
+	// Owned by a holder actor in the replay world.
+	TArray<USceneComponent*> TargetPool;
+	TArray<USceneComponent*> ActiveTargets;
+
+	int32 NumMismatches = 0;
+
+};
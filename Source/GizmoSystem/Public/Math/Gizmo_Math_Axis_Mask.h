@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Gizmo_Enums.h"
+
+inline constexpr EGizmoAxisMask GizmoTranslateAxes = EGizmoAxisMask::Translate_X | EGizmoAxisMask::Translate_Y | EGizmoAxisMask::Translate_Z;
+inline constexpr EGizmoAxisMask GizmoRotateAxes = EGizmoAxisMask::Rotate_X | EGizmoAxisMask::Rotate_Y | EGizmoAxisMask::Rotate_Z;
+inline constexpr EGizmoAxisMask GizmoScaleAxes = EGizmoAxisMask::Scale_X | EGizmoAxisMask::Scale_Y | EGizmoAxisMask::Scale_Z;
+
+// Mask of a handle selected by ESelectedAxis, in the translate, rotate or scale family. XYZ is the view plane for translation and screen rotation for rotation.
+GIZMOSYSTEM_API EGizmoAxisMask GizmoAxisMaskFromSelected(ESelectedAxis Axis, EGizmoAxisMask Family);
+
+// X, Y and Z bits of Family in Mask as bits 0 to 2.
+GIZMOSYSTEM_API uint32 GizmoAxisBits(EGizmoAxisMask Mask, EGizmoAxisMask Family);
+GIZMOSYSTEM_API int32 GizmoAxisCount(EGizmoAxisMask Mask, EGizmoAxisMask Family);
+
+// Sum of the Frame axes whose bits of Family are set. The axis itself when exactly one is.
+GIZMOSYSTEM_API FVector GizmoAxisSum(EGizmoAxisMask Mask, EGizmoAxisMask Family, const FQuat& Frame);
+
+// Translation constraint of a mask. Built once per grab, then every offset is constrained with a single matrix projection.
+struct GIZMOSYSTEM_API FGizmoAxisProjection
+{
+	// Maps an offset onto the allowed axis, plane or volume.
+	FMatrix Projection = FMatrix::Identity;
+
+	// Set for single axis masks.
+	FVector Axis = FVector::ZeroVector;
+
+	// Set for two axis masks and the view plane.
+	FVector PlaneNormal = FVector::ZeroVector;
+
+	int32 NumAxes = 0;
+
+	// Returns false when Mask has no translation bit and no view plane bit.
+	bool Init(EGizmoAxisMask Mask, const FQuat& Frame, const FVector& ViewDirection);
+
+	FORCEINLINE FVector Project(const FVector& Offset) const
+	{
+		return this->Projection.TransformVector(Offset);
+	}
+};
@@ -7,9 +7,22 @@
 
 #include "Gizmo_Includes.h"
 #include "Gizmo_Enums.h"
+#include "Gizmo_Math_Solver.h"
+#include "History/Gizmo_History.h"
+#include "Targets/Gizmo_Instance_Targets.h"
+#include "Targets/Gizmo_Spline_Targets.h"
+#include "Select/Gizmo_Marquee_Selection.h"
+#include "Debug/Gizmo_Telemetry.h"
 
 #include "Gizmo_Math_Base.generated.h"
 
+class FGizmoInputProcessor;
+class FGizmoJournal;
+class FGizmoInputRecorder;
+class UGizmoNetComponent;
+class FGizmoLateLatchExtension;
+struct FGizmoLateLatchParams;
+
 UCLASS()
 class GIZMOSYSTEM_API AGizmoMathBase : public AActor
 {
@@ -27,6 +40,72 @@ protected:
 	APlayerController* PlayerController = nullptr;
 	UCapsuleComponent* CapsuleComponent = nullptr;
 
+	// Targets and their world transforms captured when the current drag started.
+	TArray<TWeakObjectPtr<USceneComponent>> DragTargets;
+	TArray<FTransform> DragStartTransforms;
+
+	// Snap sources of the targets and their children. Suspended in the snap subsystem for the length of the drag.
+	TSet<uint32> DragSnapSources;
+
+	// InstanceTargets captured when the current drag started.
+	FGizmoInstanceDrag InstanceDrag;
+
+	// SplineTargets captured when the current drag started.
+	FGizmoSplineDrag SplineDrag;
+
+	// Collects every cursor move between frames. Shared by all gizmos through InputFrame.
+	TSharedPtr<FGizmoInputProcessor> InputProcessor;
+	int32 NumCoalescedSeen = 0;
+
+	// Builds InputFrame from the player controller and the input processor. Runs first in Tick.
+	virtual void CaptureInputFrame();
+
+	// One entry per drag, committed by EndDrag.
+	FGizmoHistory History;
+	int32 AppliedHistoryCapacityKB = INDEX_NONE;
+
+	// Found on the player state at drag start when bReplicateEdits is set.
+	TWeakObjectPtr<UGizmoNetComponent> NetComponent;
+	bool bNetDragStarted = false;
+
+	// Shared through UGizmoJournalSubsystem. Acquired in BeginPlay when bEnableJournal is set, released in EndPlay.
+	TSharedPtr<FGizmoJournal> Journal;
+
+	// Writes the current transforms of Targets to the journal, if there is one.
+	virtual void JournalTargets(TConstArrayView<USceneComponent*> Targets);
+
+	// Created in BeginPlay when bRecordInput is set.
+	TSharedPtr<FGizmoInputRecorder> InputRecorder;
+
+	// Replaces the next captured frame. Set by InjectInput.
+	TOptional<FGizmoInputFrame> InjectedInputFrame;
+
+	// Created on first use when bEnableLateLatch is set.
+	TSharedPtr<FGizmoLateLatchExtension, ESPMode::ThreadSafe> LateLatchExtension;
+
+	// Re-picks the hovered handle only when the cursor, the view or the gizmo footprint changed since the last pick.
+	virtual void HoverCallback();
+	virtual UPrimitiveComponent* PickHandle(const FVector2D& ScreenPosition) const;
+	virtual void SetHandleHighlight(UPrimitiveComponent* Handle, float Highlight);
+
+	// Handle cache of the current child gizmo and the inputs of the last pick.
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> HoverHandles;
+
+	TWeakObjectPtr<AActor> HoverHandlesOwner;
+	FVector2D HoverMousePosition = FVector2D::ZeroVector;
+	FMatrix HoverViewProjection = FMatrix::Identity;
+	FTransform HoverGizmoTransform = FTransform::Identity;
+	bool bHoverPicked = false;
+
+	// Bounds gathered by BeginMarquee, tested by every update until EndMarquee.
+	FGizmoMarqueeSelection Marquee;
+
+	// Gizmo actors, hidden actors and actors whose root can not move are never marquee selected.
+	virtual bool IsMarqueeSelectable(const UPrimitiveComponent* Component) const;
+
+	// Root components of the owners of Components, without duplicates.
+	virtual void GetMarqueeTargets(TConstArrayView<UPrimitiveComponent*> Components, TArray<USceneComponent*>& Out_Targets) const;
+
 public:	
 
 	// Sets default values for this actor's properties.
@@ -44,6 +123,90 @@ public:
 	virtual bool DetectMovementCallback();
 	virtual bool IsGizmoInViewCallback();
 
+// Drag.
+public:
+
+	// Captures start transforms of all targets. Gizmos call this when a handle is grabbed.
+	virtual void BeginDrag();
+
+	// Clears the captured drag state. Gizmos call this when a handle is released.
+	virtual void EndDrag();
+
+	// Ids of the dragged components and their children, to keep the selection out of its own snap queries.
+	const TSet<uint32>& GetDragSnapSources() const;
+
+	// Calls Solver once per target with its drag start transform and writes changed results in a single pass.
+	virtual void ApplyToTargets(TFunctionRef<FTransform(const FTransform&)> Solver);
+
+	// Applies Delta to every target's drag start transform. Gizmos call this every frame while dragging.
+	virtual void ApplyDragDelta(const FGizmoDragDelta& Delta);
+
+	// Average location of all targets at drag start.
+	virtual FVector GetSelectionCenter() const;
+
+	// Gizmo is placed and oriented on the anchor. GizmoTarget, or the first instance or spline target without one.
+	virtual bool HasAnchor() const;
+	virtual FTransform GetAnchorTransform() const;
+
+	// Moves the gizmo onto its anchor. For code that moves targets without the gizmo, like the control channel.
+	virtual void SyncToAnchor();
+
+	UFUNCTION(BlueprintCallable)
+	virtual void GetAllTargets(TArray<USceneComponent*>& Out_Targets) const;
+
+	// First becomes GizmoTarget unless bAppend keeps the current one. Ignored while dragging.
+	UFUNCTION(BlueprintCallable)
+	virtual void SetGizmoTargets(const TArray<USceneComponent*>& Targets, bool bAppend);
+
+// Marquee.
+public:
+
+	// Gathers the bounds of every selectable primitive once. Call when the rectangle drag starts.
+	UFUNCTION(BlueprintCallable)
+	virtual void BeginMarquee();
+
+	// Actors inside the rectangle between Start and End in viewport space, for a live preview. Targets are not changed.
+	UFUNCTION(BlueprintCallable)
+	virtual int32 UpdateMarquee(FVector2D Start, FVector2D End, bool bRefine, TArray<USceneComponent*>& Out_Targets);
+
+	// Selects the actors inside the rectangle and releases the gathered bounds.
+	UFUNCTION(BlueprintCallable)
+	virtual int32 EndMarquee(FVector2D Start, FVector2D End, bool bRefine, bool bAppend);
+
+	// Reverts the last drag on all of its targets. Not available while dragging.
+	UFUNCTION(BlueprintCallable)
+	virtual bool Undo();
+
+	UFUNCTION(BlueprintCallable)
+	virtual bool Redo();
+
+	UFUNCTION(BlueprintPure)
+	virtual bool CanUndo() const;
+
+	UFUNCTION(BlueprintPure)
+	virtual bool CanRedo() const;
+
+	// False when bEnableJournal is set but the file or its writer thread could not be opened. The reason is in the log.
+	UFUNCTION(BlueprintPure)
+	virtual bool IsJournalOpen() const;
+
+	// Uses Frame and Keys instead of the player's input on the next tick. For headless runs, benchmarks and replays.
+	// Drag latency is only recorded when Frame.InputTime holds the platform time the input arrived in this process.
+	virtual void InjectInput(const FGizmoInputFrame& Frame, const TArray<FKey>& Keys);
+
+	const TSet<FKey>& GetPressedKeys() const;
+
+	// Axis of the child move, rotate or scale gizmo. Lets headless and remote callers pick a handle without a click.
+	UFUNCTION(BlueprintPure)
+	virtual ESelectedAxis GetSelectedAxis() const;
+
+	// Every child gizmo begins the drag on its next tick, where the cursor was at the end of the last frame.
+	UFUNCTION(BlueprintCallable)
+	virtual void SetSelectedAxis(ESelectedAxis Axis);
+
+	// Hands this frame's solver state to the render thread. No-op unless bEnableLateLatch is set.
+	virtual void SetLateLatchParams(const FGizmoLateLatchParams& Params);
+
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (AllowPrivateAccess = "true"))
 	USceneComponent* Root = nullptr;
 
@@ -58,6 +221,31 @@ public:
 
 	UPROPERTY(BlueprintReadWrite)
 	USceneComponent* GizmoTarget = nullptr;
+
+	// Additional targets manipulated together with GizmoTarget.
+	UPROPERTY(BlueprintReadWrite)
+	TArray<USceneComponent*> GizmoTargets;
+
+	// Instances of instanced static mesh components manipulated together with the component targets.
+	UPROPERTY(BlueprintReadWrite)
+	TArray<FGizmoInstanceTarget> InstanceTargets;
+
+	// Spline points or tangents manipulated together with the component targets.
+	UPROPERTY(BlueprintReadWrite)
+	TArray<FGizmoSplineTarget> SplineTargets;
+
+	// Called on release for every spline edited by the drag, after its single UpdateSpline. Rebuild dependent spline meshes here.
+	UPROPERTY(BlueprintAssignable)
+	FGizmoSplineCommitted OnSplineCommitted;
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bIsDragging = false;
+
+	// Input of the current frame. Child gizmos tick after the base, so they always read this frame's input.
+	FGizmoInputFrame InputFrame;
+
+	// Drag latency, solver time, transform writes and coalesced samples of every drag frame. Child gizmos record their solver time here.
+	FGizmoTelemetry Telemetry;
 	
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	int32 GizmoSizeMultiplier = 1150;
@@ -65,4 +253,44 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	TArray<FKey> ForbiddenKeys;
 
+	// Re-solves the gizmo placement on the render thread with the newest cursor position just before drawing.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bEnableLateLatch = false;
+
+	// Handle materials must read the highlight amount from custom primitive data at HoverDataIndex.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bEnableHover = false;
+
+	// Custom primitive data slot the highlight amount is written to. Hover never creates material instances or rebuilds render state.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	int32 HoverDataIndex = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	UPrimitiveComponent* HoveredHandle = nullptr;
+
+	// Memory reserved for undo history. Oldest drags are dropped when it is full.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	int32 HistoryCapacityKB = 1024;
+
+	// Streams drags through the UGizmoNetComponent on the player state, so the server and other clients follow them.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bReplicateEdits = false;
+
+	// Records every committed edit to an append-only file, so a session can be recovered with ReplayGizmoJournal after a crash.
+	// The file is truncated when the session ends cleanly and after a save, see UGizmoJournalSubsystem.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bEnableJournal = false;
+
+	// Empty uses Saved/Gizmo/GizmoJournal.bin.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FString JournalPath;
+
+	// Records the input of every tick, so the session can be replayed headless with GizmoBenchmark -Replay=<path>.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bRecordInput = false;
+
+	// Empty uses Saved/Gizmo/GizmoInput_<timestamp>.gzr.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FString InputRecordingPath;
+
 };
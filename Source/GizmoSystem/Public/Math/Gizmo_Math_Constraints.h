@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Engine/EngineTypes.h"
+
+#include "Gizmo_Math_Axis_Mask.h"
+
+class UWorld;
+class UPrimitiveComponent;
+
+// Stages of the move constraint pipeline. They always run in declaration order.
+enum class EGizmoConstraintStage : uint8
+{
+	None		= 0,
+	Axis_Mask	= 1 << 0,
+	Grid_Snap	= 1 << 1,
+	Clamp		= 1 << 2,
+	Sweep		= 1 << 3,
+};
+ENUM_CLASS_FLAGS(EGizmoConstraintStage)
+
+// Everything the stages read. Built once on grab, so the per-frame solve only does arithmetic.
+struct GIZMOSYSTEM_API FGizmoConstraintContext
+{
+	EGizmoConstraintStage Stages = EGizmoConstraintStage::None;
+
+	// Pivot at grab. Offsets are relative to it.
+	FVector Start = FVector::ZeroVector;
+
+	// Axis mask. Projects an offset onto the grabbed axis or plane, identity for free moves.
+	FMatrix Projection = FMatrix::Identity;
+
+	// Grabbed axis, zero for planes and free moves. Grid snap steps along it.
+	FVector Axis = FVector::ZeroVector;
+
+	// Gizmo frame at grab. Planes and free moves snap to a grid aligned with it.
+	FQuat Frame = FQuat::Identity;
+
+	double GridSize = 0;
+	FBox Volume = FBox(ForceInit);
+
+	// Sweep. The component's own collision geometry is moved by the offset from its grab location and rotation.
+	const UWorld* World = nullptr;
+	TWeakObjectPtr<UPrimitiveComponent> SweepComponent;
+	FVector SweepStart = FVector::ZeroVector;
+	FQuat SweepRotation = FQuat::Identity;
+	FComponentQueryParams SweepParams;
+
+	// Only hits on components that block this channel stop the move.
+	TEnumAsByte<ECollisionChannel> SweepChannel = ECC_WorldStatic;
+
+	// Takes the axis mask stage from a grabbed handle's projection, and the grid frame from the gizmo.
+	void Init(const FGizmoAxisProjection& AxisProjection, const FQuat& InFrame);
+};
+
+struct FGizmoAxisMaskStage
+{
+	static constexpr EGizmoConstraintStage Stage = EGizmoConstraintStage::Axis_Mask;
+
+	static FORCEINLINE FVector Apply(const FGizmoConstraintContext& Context, const FVector& Offset)
+	{
+		return Context.Projection.TransformVector(Offset);
+	}
+};
+
+/*
+* Steps of GridSize along the grabbed axis, per axis of Frame otherwise, so a local plane snaps in its own space.
+* Re-masked, so plane moves stay in their plane. The view plane has no axes of its own and snaps per world axis.
+*/
+struct FGizmoGridSnapStage
+{
+	static constexpr EGizmoConstraintStage Stage = EGizmoConstraintStage::Grid_Snap;
+
+	static FORCEINLINE FVector Apply(const FGizmoConstraintContext& Context, const FVector& Offset)
+	{
+		if (!Context.Axis.IsZero())
+		{
+			return Context.Axis * FMath::GridSnap(FVector::DotProduct(Offset, Context.Axis), Context.GridSize);
+		}
+
+		const FVector Local = Context.Frame.UnrotateVector(Offset);
+		const FVector Snapped(FMath::GridSnap(Local.X, Context.GridSize), FMath::GridSnap(Local.Y, Context.GridSize), FMath::GridSnap(Local.Z, Context.GridSize));
+
+		return Context.Projection.TransformVector(Context.Frame.RotateVector(Snapped));
+	}
+};
+
+// Shortens the move so the pivot stays inside Volume. Direction is kept, so the axis or plane constraint holds.
+struct FGizmoClampStage
+{
+	static constexpr EGizmoConstraintStage Stage = EGizmoConstraintStage::Clamp;
+
+	static FORCEINLINE FVector Apply(const FGizmoConstraintContext& Context, const FVector& Offset)
+	{
+		const FVector End = Context.Start + Offset;
+
+		if (Context.Volume.IsInsideOrOn(End))
+		{
+			return Offset;
+		}
+
+		// Grabbed outside the volume, pulled straight back in.
+		if (!Context.Volume.IsInsideOrOn(Context.Start))
+		{
+			return Context.Volume.GetClosestPointTo(End) - Context.Start;
+		}
+
+		double Fraction = 1;
+
+		for (int32 Index = 0; Index < 3; ++Index)
+		{
+			if (End[Index] > Context.Volume.Max[Index])
+			{
+				Fraction = FMath::Min(Fraction, (Context.Volume.Max[Index] - Context.Start[Index]) / Offset[Index]);
+			}
+
+			else if (End[Index] < Context.Volume.Min[Index])
+			{
+				Fraction = FMath::Min(Fraction, (Context.Volume.Min[Index] - Context.Start[Index]) / Offset[Index]);
+			}
+		}
+
+		return Offset * FMath::Max(Fraction, 0.0);
+	}
+};
+
+// Stops the move at the first hit of the swept component's geometry on a component that blocks SweepChannel.
+struct GIZMOSYSTEM_API FGizmoSweepStage
+{
+	static constexpr EGizmoConstraintStage Stage = EGizmoConstraintStage::Sweep;
+
+	static FVector Apply(const FGizmoConstraintContext& Context, const FVector& Offset);
+};
+
+// Stages folded into one inlined kernel at compile time.
+template<typename... TStages>
+struct TGizmoConstraintPipeline
+{
+	static constexpr EGizmoConstraintStage Stages = (TStages::Stage | ... | EGizmoConstraintStage::None);
+
+	static FORCEINLINE FVector Apply(const FGizmoConstraintContext& Context, FVector Offset)
+	{
+		((Offset = TStages::Apply(Context, Offset)), ...);
+		return Offset;
+	}
+};
+
+using FGizmoMaskPipeline = TGizmoConstraintPipeline<FGizmoAxisMaskStage>;
+using FGizmoMaskSnapPipeline = TGizmoConstraintPipeline<FGizmoAxisMaskStage, FGizmoGridSnapStage>;
+using FGizmoMaskClampPipeline = TGizmoConstraintPipeline<FGizmoAxisMaskStage, FGizmoClampStage>;
+using FGizmoMaskSnapClampPipeline = TGizmoConstraintPipeline<FGizmoAxisMaskStage, FGizmoGridSnapStage, FGizmoClampStage>;
+
+// Picks the specialized pipeline for Context.Stages, or runs the enabled stages one by one for other combinations.
+GIZMOSYSTEM_API FVector GizmoApplyConstraints(const FGizmoConstraintContext& Context, const FVector& Offset);
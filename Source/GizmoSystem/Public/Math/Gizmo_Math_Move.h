@@ -6,6 +6,10 @@
 #include "GameFramework/Actor.h"
 
 #include "Gizmo_Math_Base.h"
+#include "Debug/Gizmo_Diagnostics.h"
+#include "Gizmo_Math_Solver.h"
+#include "Gizmo_Math_Constraints.h"
+#include "Snap/Gizmo_Snap_Hash.h"
 
 #include "Gizmo_Math_Move.generated.h"
 
@@ -24,17 +28,63 @@ protected:
 
 	APlayerController* PlayerController = nullptr;
 
+	// Why the last updates were skipped. Shown on screen with bEnableDebugMode, printed by Gizmo.DumpDiagnostics.
+	FGizmoDiagnostics Diagnostics;
+
 	virtual void InitHandles();
+	virtual void LoadAssets();
+	virtual void ApplyAssets();
 	virtual void TransformSystem();
 	virtual bool Transform_Check();
-	virtual void Transform_World();
-	virtual void Transform_Local();
+	virtual bool Transform_World(const FVector2D& ScreenPosition, FVector& Out_Offset);
+	virtual bool Transform_Local(const FVector2D& ScreenPosition, FVector& Out_Offset);
 	virtual void Transform_Track();
 	virtual void BindDelegates();
+	virtual bool BeginGrab(const FVector2D& MousePosition);
+	virtual EGizmoAxisMask GetAxisMask() const;
+	virtual ESelectedAxis GetAxisEnum(const UPrimitiveComponent* Handle) const;
+
+	// Drops the selection onto the surface under the cursor. Returns false when there is nothing new to apply.
+	virtual bool Surface_Solve(const FVector2D& ScreenPosition, FGizmoDragDelta& Out_Delta);
+
+	// Pulls the dragged pivot onto the nearest snap point on screen, kept on the grabbed axis or plane. Returns false when nothing is in range.
+	virtual bool Snap_Offset(FVector& InOut_Offset);
 
 	UFUNCTION()
 	virtual void OnClickedEvent(UPrimitiveComponent* TouchComponent, FKey PressedButton);
 
+	UFUNCTION()
+	virtual void OnReleasedEvent(UPrimitiveComponent* TouchComponent, FKey ReleasedButton);
+
+	// Local axis projected into the viewport on grab. Local mode reuses it for the whole drag.
+	FGizmoScreenAxis GrabScreenAxis;
+
+	// Mask of the grabbed handle and its projection in the gizmo frame.
+	EGizmoAxisMask GrabAxisMask = EGizmoAxisMask::None;
+	FGizmoAxisProjection GrabProjection;
+
+	// Axis or plane constraint and the constrained point under the cursor on grab.
+	FGizmoConstraintPlane GrabConstraint;
+	FVector GrabPoint = FVector::ZeroVector;
+	bool bHasGrabPoint = false;
+	FVector GrabGizmoLocation = FVector::ZeroVector;
+	FVector2D GrabMousePosition = FVector2D::ZeroVector;
+	ESelectedAxis GrabAxisEnum = ESelectedAxis::Null_Axis;
+
+	// Surface mode. The trace is only repeated when the cursor or the view moved, otherwise SurfaceHit is reused.
+	FTransform GrabAnchorTransform = FTransform::Identity;
+	FBox SurfaceLocalBounds = FBox(ForceInit);
+	FCollisionQueryParams SurfaceQueryParams;
+	FVector2D SurfaceTraceMousePosition = FVector2D::ZeroVector;
+	FMatrix SurfaceTraceViewProjection = FMatrix::Identity;
+	bool bHasSurfaceTrace = false;
+
+	// Axis mask, grid snap, clamp and sweep settings of the current drag. Every solved offset goes through them.
+	FGizmoConstraintContext GrabConstraints;
+
+	// Reused between frames. Snap points of the dragged selection are skipped through AGizmoMathBase::GetDragSnapSources.
+	TArray<FGizmoSnapCandidate> SnapCandidates;
+
 public:	
 
 	// Sets default values for this actor's properties.
@@ -43,9 +93,25 @@ public:
 	// Called every frame.
 	virtual void Tick(float DeltaTime) override;
 
+	// Soft references of the handle visuals. Preload them from the class default object to hide the first spawn.
+	virtual TArray<FSoftObjectPath> GetAssetPaths() const;
+
 	UFUNCTION(BlueprintCallable)
 	virtual void SetArrowMesh(UStaticMesh* In_Mesh);
 
+	// Loaded asynchronously on BeginPlay and assigned to handles which have no mesh or material of their own.
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UStaticMesh> AxisMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/GizmoSystem/Meshes/SM_Gizmo_Move_Axis.SM_Gizmo_Move_Axis")));
+
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UMaterialInterface> Material_X = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/GizmoSystem/Materials/MI_Gizmo_X.MI_Gizmo_X")));
+
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UMaterialInterface> Material_Y = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/GizmoSystem/Materials/MI_Gizmo_Y.MI_Gizmo_Y")));
+
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UMaterialInterface> Material_Z = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/GizmoSystem/Materials/MI_Gizmo_Z.MI_Gizmo_Z")));
+
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (AllowPrivateAccess = "true"))
 	USceneComponent* Root = nullptr;
 
@@ -67,12 +133,61 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	ESelectedAxis AxisEnum = ESelectedAxis::Null_Axis;
 
+	// Replaces the mask of the selected handle when set, e.g. to drag X and Z with one handle. Rotation and scale bits are ignored.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (Bitmask, BitmaskEnum = "/Script/GizmoSystem.EGizmoAxisMask"))
+	int32 AxisMaskOverride = 0;
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
 	bool bMoveLocal = true;
 
+	// Not used anymore, world and local drags both track the cursor exactly. Kept for Blueprints that set it.
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
 	float MoveMultiplier = 5;
 
+	// Any handle drags the selection across the surface under the cursor, resting on the bounds of GizmoTarget.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
+	bool bSurfaceDrag = false;
+
+	// Surface mode turns the selection so its up axis follows the hit normal. Heading is kept.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
+	bool bAlignToSurface = false;
+
+	// Cursor travel in pixels below which the last surface hit is reused.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	float SurfaceTraceTolerance = 1;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TEnumAsByte<ECollisionChannel> SurfaceTraceChannel = ECC_Visibility;
+
+	// Pivot snaps to mesh vertices, mesh sockets and custom collision corners near the cursor. Not used in surface mode.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
+	bool bSnapToPoints = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	float SnapPixelRadius = 12;
+
+	// Offset moves in steps of GridSize along the grabbed axis, per world axis otherwise. 0 disables it. Snapping to points takes precedence.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
+	float GridSize = 0;
+
+	// Pivot can not leave ClampVolume.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bClampToVolume = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FBox ClampVolume = FBox(ForceInit);
+
+	// GizmoTarget's own collision geometry is swept along the move and stops at the first hit on a component blocking SweepChannel.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bSweepCollision = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TEnumAsByte<ECollisionChannel> SweepChannel = ECC_WorldStatic;
+
+	// Last surface under the cursor in surface mode. For impact markers.
+	UPROPERTY(BlueprintReadOnly)
+	FHitResult SurfaceHit;
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
 	bool bEnableDebugMode = false;
 
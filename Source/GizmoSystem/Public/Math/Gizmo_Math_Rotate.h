@@ -6,6 +6,7 @@
 #include "GameFramework/Actor.h"
 
 #include "Gizmo_Math_Base.h"
+#include "Debug/Gizmo_Diagnostics.h"
 
 #include "Gizmo_Math_Rotate.generated.h"
 
@@ -24,14 +25,43 @@ protected:
 
 	APlayerController* PlayerController = nullptr;
 
+	// Why the last updates were skipped. Shown on screen with bEnableDebugMode, printed by Gizmo.DumpDiagnostics.
+	FGizmoDiagnostics Diagnostics;
+
 	virtual void InitHandles();
+	virtual void LoadAssets();
+	virtual void ApplyAssets();
 
 	virtual bool Rotate_Check();
 	virtual bool Check_Visibility();
 
 	virtual void RotateSystem();
 	virtual FVector HorizontalNormal(USceneComponent* Target);
-	virtual double Rotate_XY();
+	virtual double Rotate_XY(const FVector2D& MouseDelta);
+	virtual bool Rotate_Sample(const FVector2D& ScreenPosition, double& Out_DeltaAngle);
+	virtual bool BeginGrab(const FVector2D& MousePosition);
+	virtual FVector GetRotationAxis() const;
+	virtual ESelectedAxis GetAxisEnum(const UPrimitiveComponent* Handle) const;
+	virtual void BindDelegates();
+
+	UFUNCTION()
+	virtual void OnClickedEvent(UPrimitiveComponent* TouchComponent, FKey PressedButton);
+
+	UFUNCTION()
+	virtual void OnReleasedEvent(UPrimitiveComponent* TouchComponent, FKey ReleasedButton);
+
+	// Rotation plane through the pivot. Invalid when it is seen edge-on, then the mouse delta heuristic is used instead.
+	FGizmoConstraintPlane GrabPlane;
+	FVector GrabPivot = FVector::ZeroVector;
+	FVector GrabAxis = FVector::ZeroVector;
+	ESelectedAxis GrabAxisEnum = ESelectedAxis::Null_Axis;
+
+	// Last pivot-to-cursor vector on the rotation plane. Angles are integrated sample by sample from here.
+	FVector PreviousPlaneVector = FVector::ZeroVector;
+	bool bHasPreviousPlaneVector = false;
+
+	// Accumulated rotation since grab in degrees.
+	double GrabAngle = 0;
 
 public:	
 
@@ -41,6 +71,22 @@ public:
 	// Called every frame.
 	virtual void Tick(float DeltaTime) override;
 
+	// Soft references of the handle visuals. Preload them from the class default object to hide the first spawn.
+	virtual TArray<FSoftObjectPath> GetAssetPaths() const;
+
+	// Loaded asynchronously on BeginPlay and assigned to handles which have no mesh or material of their own.
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UStaticMesh> RingMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/GizmoSystem/Meshes/SM_Gizmo_Rotate.SM_Gizmo_Rotate")));
+
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UMaterialInterface> Material_X = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/GizmoSystem/Materials/MI_Gizmo_X.MI_Gizmo_X")));
+
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UMaterialInterface> Material_Y = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/GizmoSystem/Materials/MI_Gizmo_Y.MI_Gizmo_Y")));
+
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UMaterialInterface> Material_Z = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/GizmoSystem/Materials/MI_Gizmo_Z.MI_Gizmo_Z")));
+
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (AllowPrivateAccess = "true"))
 	USceneComponent* Root = nullptr;
 
@@ -65,6 +111,7 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	bool bRotateLocal = true;
 
+	// Only used by the mouse delta fallback when the rotation plane is seen edge-on.
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	float RotateMultiplier = 5;
 
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "Gizmo_Math_Base.h"
+#include "Debug/Gizmo_Diagnostics.h"
+
+#include "Gizmo_Math_Scale.generated.h"
+
+UCLASS()
+class GIZMOSYSTEM_API AGizmoMathScale : public AActor
+{
+	GENERATED_BODY()
+
+protected:
+
+	// Called when the game starts or when spawned.
+	virtual void BeginPlay() override;
+
+	// Called when the game end or when destroyed.
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	APlayerController* PlayerController = nullptr;
+
+	// Why the last updates were skipped. Shown on screen with bEnableDebugMode, printed by Gizmo.DumpDiagnostics.
+	FGizmoDiagnostics Diagnostics;
+
+	virtual void InitHandles();
+	virtual void LoadAssets();
+	virtual void ApplyAssets();
+	virtual UStaticMeshComponent* CreateHandle(FName HandleName, const FRotator& HandleRotation, UStaticMesh* HandleMesh);
+	virtual ESelectedAxis GetAxisEnum(const UPrimitiveComponent* Handle) const;
+	virtual void ScaleSystem();
+	virtual bool Scale_Check();
+	virtual FVector Scale_Ratio();
+	virtual void Scale_Apply(const FVector& Ratio);
+	virtual void Scale_Track();
+
+	// Captures the drag state below and begins the drag on the base. False without a selected axis.
+	virtual bool BeginGrab(const FVector2D& MousePosition);
+
+	virtual void BindDelegates();
+
+	UFUNCTION()
+	virtual void OnClickedEvent(UPrimitiveComponent* TouchComponent, FKey PressedButton);
+
+	UFUNCTION()
+	virtual void OnReleasedEvent(UPrimitiveComponent* TouchComponent, FKey ReleasedButton);
+
+	// Drag state captured on grab. The ratio is always measured from here, so it does not drift.
+	FVector2D GrabMousePosition = FVector2D::ZeroVector;
+	FVector2D GrabScreenDirection = FVector2D::ZeroVector;
+	FVector GrabPivot = FVector::ZeroVector;
+	FQuat GrabFrame = FQuat::Identity;
+	ESelectedAxis GrabAxisEnum = ESelectedAxis::Null_Axis;
+
+public:
+
+	// Sets default values for this actor's properties.
+	AGizmoMathScale();
+
+	// Called every frame.
+	virtual void Tick(float DeltaTime) override;
+
+	// Soft references of the handle visuals. Preload them from the class default object to hide the first spawn.
+	virtual TArray<FSoftObjectPath> GetAssetPaths() const;
+
+	UFUNCTION(BlueprintCallable)
+	virtual void SetHandleMeshes(UStaticMesh* In_Axis_Mesh, UStaticMesh* In_Plane_Mesh, UStaticMesh* In_Center_Mesh);
+
+	// Loaded asynchronously on BeginPlay and assigned to handles which have no mesh or material of their own.
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UStaticMesh> AxisMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/GizmoSystem/Meshes/SM_Gizmo_Move_Axis.SM_Gizmo_Move_Axis")));
+
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UStaticMesh> PlaneMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/GizmoSystem/Meshes/SM_Gizmo_Move_Plane.SM_Gizmo_Move_Plane")));
+
+	// Uniform handle has no default mesh.
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UStaticMesh> CenterMesh;
+
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UMaterialInterface> Material_X = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/GizmoSystem/Materials/MI_Gizmo_X.MI_Gizmo_X")));
+
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UMaterialInterface> Material_Y = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/GizmoSystem/Materials/MI_Gizmo_Y.MI_Gizmo_Y")));
+
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UMaterialInterface> Material_Z = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/GizmoSystem/Materials/MI_Gizmo_Z.MI_Gizmo_Z")));
+
+	// Planes and the uniform handle.
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly)
+	TSoftObjectPtr<UMaterialInterface> Material_XYZ = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/GizmoSystem/Materials/MI_Gizmo_XYZ.MI_Gizmo_XYZ")));
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (AllowPrivateAccess = "true"))
+	USceneComponent* Root = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (AllowPrivateAccess = "true"))
+	UStaticMeshComponent* Axis_X = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (AllowPrivateAccess = "true"))
+	UStaticMeshComponent* Axis_Y = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (AllowPrivateAccess = "true"))
+	UStaticMeshComponent* Axis_Z = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (AllowPrivateAccess = "true"))
+	UStaticMeshComponent* Plane_XY = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (AllowPrivateAccess = "true"))
+	UStaticMeshComponent* Plane_XZ = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (AllowPrivateAccess = "true"))
+	UStaticMeshComponent* Plane_YZ = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, meta = (AllowPrivateAccess = "true"))
+	UStaticMeshComponent* Axis_XYZ = nullptr;
+
+	UPROPERTY(BlueprintReadOnly)
+	AGizmoMathBase* GizmoBase = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	UPrimitiveComponent* AxisComponent = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	ESelectedAxis AxisEnum = ESelectedAxis::Null_Axis;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
+	EScalePivot ScalePivot = EScalePivot::Gizmo_Origin;
+
+	// Scale ratio gained per pixel of cursor travel along the handle.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
+	float ScaleMultiplier = 0.01;
+
+	// Scale components are rounded to this increment. Zero disables snapping.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
+	float SnapIncrement = 0;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
+	float MinScale = 0.01;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
+	bool bEnableDebugMode = false;
+
+};
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class APlayerController;
+
+// Snapshot of the player's view used to project between world and viewport space without touching the player controller again.
+struct GIZMOSYSTEM_API FGizmoViewState
+{
+	FIntRect ViewRect;
+	FMatrix ViewProjectionMatrix = FMatrix::Identity;
+	FMatrix InvViewProjectionMatrix = FMatrix::Identity;
+	FVector ViewOrigin = FVector::ZeroVector;
+	FVector ViewDirection = FVector::ForwardVector;
+	bool bIsValid = false;
+
+	bool Capture(const APlayerController* PlayerController);
+
+	// Builds a perspective view without a player, e.g. for headless runs.
+	void Build(const FVector& Location, const FRotator& Rotation, float FOVDegrees, const FIntPoint& ViewSize);
+	bool ProjectWorldToScreen(const FVector& WorldLocation, FVector2D& Out_ScreenPosition) const;
+	bool DeprojectScreenToWorld(const FVector2D& ScreenPosition, FVector& Out_RayOrigin, FVector& Out_RayDirection) const;
+};
+
+// A world axis projected into the viewport once, so each mouse delta converts to world distance with a single dot product.
+struct GIZMOSYSTEM_API FGizmoScreenAxis
+{
+	FVector WorldAxis = FVector::ZeroVector;
+
+	// Screen direction of the axis divided by its pixels per world unit at the origin depth.
+	FVector2D ScreenStep = FVector2D::ZeroVector;
+
+	double PixelsPerUnit = 0;
+	bool bIsValid = false;
+
+	// Returns false when the axis points (almost) straight at the camera and has no usable screen direction.
+	bool Init(const FGizmoViewState& View, const FVector& Origin, const FVector& Axis);
+	double ToWorldDistance(const FVector2D& PixelDelta) const;
+};
+
+// Everything a gizmo consumes from input in one frame.
+struct GIZMOSYSTEM_API FGizmoInputFrame
+{
+	FGizmoViewState View;
+
+	// Cursor position in viewport space at the end of this frame and the previous one.
+	FVector2D MousePosition = FVector2D::ZeroVector;
+	FVector2D PreviousMousePosition = FVector2D::ZeroVector;
+
+	// Raw per-frame mouse delta, kept for the legacy heuristics.
+	FVector2D MouseDelta = FVector2D::ZeroVector;
+
+	float MouseWheel = 0;
+
+	// Every cursor position received since the previous frame in viewport space, oldest first. Last one equals MousePosition.
+	TArray<FVector2D> Samples;
+
+	// Offset from Slate desktop space to viewport space, kept from the last frame that had samples.
+	FVector2D ScreenToViewport = FVector2D::ZeroVector;
+
+	// Platform time the oldest input of this frame arrived. Zero when nothing moved.
+	double InputTime = 0;
+
+	// Samples merged by the input processor since the previous frame because its buffer was full.
+	int32 NumCoalesced = 0;
+};
+
+// Ray-plane constraint. Axis constraints intersect with the plane that contains the axis and faces the camera the most, then project onto the axis.
+struct GIZMOSYSTEM_API FGizmoConstraintPlane
+{
+	FVector Origin = FVector::ZeroVector;
+	FVector Normal = FVector::UpVector;
+
+	// Zero for plane constraints.
+	FVector Axis = FVector::ZeroVector;
+
+	bool bIsValid = false;
+
+	bool InitForAxis(const FGizmoViewState& View, const FVector& In_Origin, const FVector& In_Axis);
+	bool InitForPlane(const FVector& In_Origin, const FVector& In_Normal);
+	bool Intersect(const FVector& RayOrigin, const FVector& RayDirection, FVector& Out_Point) const;
+	bool Solve(const FGizmoViewState& View, const FVector2D& ScreenPosition, FVector& Out_Point) const;
+};
+
+// Cumulative change of a drag relative to its start. The one per-target solver shared by the gizmos, the server and remote clients.
+struct GIZMOSYSTEM_API FGizmoDragDelta
+{
+	FVector Translation = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector ScaleRatio = FVector::OneVector;
+
+	// Fixed for the whole drag.
+	FVector Pivot = FVector::ZeroVector;
+	FQuat ScaleFrame = FQuat::Identity;
+	bool bScaleAboutPivot = true;
+	double ScaleSnap = 0;
+	double MinScale = 0;
+
+	FTransform Apply(const FTransform& StartTransform) const;
+};
+
+// Signed angle in radians from A to B around Axis.
+GIZMOSYSTEM_API double GizmoSignedAngle(const FVector& A, const FVector& B, const FVector& Axis);
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Gizmo_Enums.h"
+
+class FSocket;
+
+/*
+* Messages of the local control channel. Every message is [uint32 size of the rest][uint8 type][uint32 request id][payload], little endian.
+* Transforms are 10 doubles : location, rotation quat xyzw, scale. Every value has to be finite, rotations are normalized on read. Targets are ids returned by Resolve.
+*/
+enum class EGizmoControlMessage : uint8
+{
+	// [uint16 length][utf8 path of a scene component or actor]. Ack value is the target id, 0 when not found.
+	Resolve = 1,
+
+	// [uint32 count], count x [uint32 id][transform]. World transforms. Ack value is the number applied.
+	Set_Transforms = 2,
+
+	// [uint32 count], count x [uint32 id][transform]. Location is added, rotation is applied in world space about the target, scale is multiplied.
+	Apply_Deltas = 3,
+
+	// [uint8 append][uint32 count], count x [uint32 id]. Targets of the gizmo base in the world.
+	Select = 4,
+
+	// [uint8 ESelectedAxis]. Axis of the child gizmo of the gizmo base in the world.
+	Set_Axis = 5,
+
+	// Server to client. [uint8 EGizmoControlStatus][uint32 value]. Request id is the one of the acknowledged message.
+	Ack = 128,
+};
+
+enum class EGizmoControlStatus : uint8
+{
+	Ok = 0,
+
+	// Some ids were unknown or their targets were destroyed. Value is the number applied.
+	Partial = 1,
+
+	Not_Found = 2,
+	No_Gizmo = 3,
+	Unknown_Message = 4,
+
+	// Payload does not match its type or holds a non finite or zero rotation transform. Sent by the socket thread, the message never reaches the game.
+	Malformed = 5,
+};
+
+struct FGizmoControlCommand
+{
+	EGizmoControlMessage Type = EGizmoControlMessage::Ack;
+	uint32 RequestId = 0;
+
+	// Connection the ack goes back to.
+	uint32 ClientId = 0;
+
+	FString Path;
+	TArray<uint32> Ids;
+	TArray<FTransform> Transforms;
+	ESelectedAxis Axis = ESelectedAxis::Null_Axis;
+	bool bAppend = false;
+};
+
+struct FGizmoControlAck
+{
+	uint32 ClientId = 0;
+	uint32 RequestId = 0;
+	EGizmoControlStatus Status = EGizmoControlStatus::Ok;
+	uint32 Value = 0;
+};
+
+// Encoding and decoding shared by the server and clients.
+class GIZMOSYSTEM_API FGizmoControlProtocol
+{
+public:
+
+	// Size prefix and type plus request id.
+	static constexpr int32 SizeBytes = sizeof(uint32);
+	static constexpr int32 HeaderBytes = sizeof(uint8) + sizeof(uint32);
+	static constexpr int32 TransformBytes = sizeof(double) * 10;
+
+	// Larger messages close the connection.
+	static constexpr uint32 MaxMessageBytes = 64 * 1024 * 1024;
+
+	static void WriteResolve(TArray<uint8>& Out_Buffer, uint32 RequestId, const FString& Path);
+	static void WriteTransforms(TArray<uint8>& Out_Buffer, EGizmoControlMessage Type, uint32 RequestId, TConstArrayView<uint32> Ids, TConstArrayView<FTransform> Transforms);
+	static void WriteSelect(TArray<uint8>& Out_Buffer, uint32 RequestId, TConstArrayView<uint32> Ids, bool bAppend);
+	static void WriteSetAxis(TArray<uint8>& Out_Buffer, uint32 RequestId, ESelectedAxis Axis);
+	static void WriteAck(TArray<uint8>& Out_Buffer, const FGizmoControlAck& Ack);
+
+	// Message is everything after the size prefix. Returns false when the payload does not match its type.
+	static bool ReadCommand(const uint8* Message, int32 MessageSize, FGizmoControlCommand& Out_Command);
+	static bool ReadAck(const uint8* Message, int32 MessageSize, FGizmoControlAck& Out_Ack);
+
+};
+
+/*
+* Blocking client of the control channel. Used by the benchmark as a stand-in for external tools, and as the reference for their implementation.
+*/
+class GIZMOSYSTEM_API FGizmoControlClient
+{
+public:
+
+	~FGizmoControlClient();
+
+	bool Connect(int32 Port);
+	void Close();
+	bool IsConnected() const;
+
+	// Sends the whole buffer, written with the FGizmoControlProtocol writers.
+	bool Send(const TArray<uint8>& Buffer);
+
+	// Appends every ack that arrives within TimeoutSeconds, returns once at least MinAcks have arrived.
+	int32 ReceiveAcks(TArray<FGizmoControlAck>& Out_Acks, int32 MinAcks, double TimeoutSeconds);
+
+private:
+
+	FSocket* Socket = nullptr;
+	TArray<uint8> ReceiveBuffer;
+
+};
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+
+#include "Net/Gizmo_Control_Protocol.h"
+
+#include <atomic>
+
+class FSocket;
+
+/*
+* Socket side of the local control channel. Listens on the loopback interface only, and reads and parses messages on its own thread.
+* Parsed commands reach the game thread through a lock-free queue, acks go back through a second one.
+*/
+class GIZMOSYSTEM_API FGizmoControlServer : public FRunnable
+{
+public:
+
+	virtual ~FGizmoControlServer() override;
+
+	// Zero picks a free port, see GetPort.
+	bool Start(int32 In_Port);
+
+	bool IsListening() const;
+	int32 GetPort() const;
+
+	// Game thread.
+	bool Dequeue(FGizmoControlCommand& Out_Command);
+	void SendAck(const FGizmoControlAck& Ack);
+
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+
+	struct FClient
+	{
+		uint32 Id = 0;
+		FSocket* Socket = nullptr;
+		TArray<uint8> ReceiveBuffer;
+		TArray<uint8> SendBuffer;
+	};
+
+	void AcceptClients();
+
+	// Reads everything available and queues complete messages. Returns false when the connection is gone or broke the protocol.
+	bool ReceiveFrom(FClient& Client, bool& Out_bReceived);
+	bool SendTo(FClient& Client);
+	void CloseClient(FClient& Client);
+
+	FSocket* ListenSocket = nullptr;
+	int32 Port = 0;
+
+	// Only touched by the server thread.
+	TArray<FClient> Clients;
+	uint32 NextClientId = 1;
+
+	TQueue<FGizmoControlCommand, EQueueMode::Spsc> Commands;
+	TQueue<FGizmoControlAck, EQueueMode::Spsc> Acks;
+
+	FRunnableThread* Thread = nullptr;
+	std::atomic<bool> bStopping = false;
+
+};
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "Net/Gizmo_Control_Server.h"
+
+#include "Gizmo_Control_Subsystem.generated.h"
+
+class AGizmoMathBase;
+
+/*
+* Lets external tools drive gizmo targets over a loopback socket. Messages are parsed off the game thread,
+* everything that arrived since the last tick is applied here in one pass with one transform write per target.
+* Starts on its own when "Gizmo.Control.Port" is not zero.
+*/
+UCLASS()
+class GIZMOSYSTEM_API UGizmoControlSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	TUniquePtr<FGizmoControlServer> Server;
+
+	// Keyed by the unique id of the component, which is also the id clients use.
+	TMap<uint32, TWeakObjectPtr<USceneComponent>> Targets;
+
+	TWeakObjectPtr<AGizmoMathBase> GizmoBase;
+
+	// Final transform per target of this tick. Kept between ticks so draining does not allocate.
+	TArray<TPair<USceneComponent*, FTransform>> PendingWrites;
+	TMap<USceneComponent*, int32> PendingIndices;
+	TArray<FGizmoControlAck> PendingAcks;
+	TArray<USceneComponent*> SelectScratch;
+	TArray<USceneComponent*> GizmoTargetScratch;
+
+	virtual USceneComponent* ResolvePath(const FString& Path) const;
+	virtual AGizmoMathBase* FindGizmoBase();
+	virtual FGizmoControlAck Execute(const FGizmoControlCommand& Command);
+
+	// Transform the target will have after this tick's writes so far.
+	FTransform& GetPendingTransform(USceneComponent* Target);
+
+	// Writes bypass the gizmo. When one of its targets was written, the gizmo is moved back onto its anchor.
+	void FlushWrites();
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Zero picks a free port. Only the loopback interface is bound.
+	UFUNCTION(BlueprintCallable)
+	virtual bool StartControlServer(int32 Port);
+
+	UFUNCTION(BlueprintCallable)
+	virtual void StopControlServer();
+
+	// Zero when not listening.
+	UFUNCTION(BlueprintPure)
+	virtual int32 GetControlPort() const;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+};
@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/NetSerialization.h"
+
+#include "Math/Gizmo_Math_Solver.h"
+
+#include "Gizmo_Net_Component.generated.h"
+
+// Changing part of a drag delta. Quantized and only the parts that differ from identity are sent.
+USTRUCT()
+struct GIZMOSYSTEM_API FGizmoNetDelta
+{
+	GENERATED_BODY()
+
+	FVector Translation = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector ScaleRatio = FVector::OneVector;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	static FGizmoNetDelta Interpolate(const FGizmoNetDelta& From, const FGizmoNetDelta& To, float Alpha);
+};
+
+template<>
+struct TStructOpsTypeTraits<FGizmoNetDelta> : public TStructOpsTypeTraitsBase2<FGizmoNetDelta>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+// Part of a drag delta that is fixed from grab to release. Sent once per drag.
+USTRUCT()
+struct GIZMOSYSTEM_API FGizmoNetDragSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize100 Pivot = FVector::ZeroVector;
+
+	UPROPERTY()
+	FQuat ScaleFrame = FQuat::Identity;
+
+	UPROPERTY()
+	bool bScaleAboutPivot = true;
+
+	UPROPERTY()
+	float ScaleSnap = 0;
+
+	UPROPERTY()
+	float MinScale = 0;
+};
+
+/*
+* Replicates gizmo drags. Add it to the PlayerState class, so it has an owning connection for server RPCs and is relevant to every client for multicasts.
+* The dragging client streams its cumulative delta at SendRate with unreliable RPCs. Each one replaces the last, so a lost packet only delays the target.
+* The server applies it with FGizmoDragDelta and relays it, other clients interpolate towards it. Release is reliable and confirmed to the dragging client.
+*/
+UCLASS(ClassGroup = (Gizmo), meta = (BlueprintSpawnableComponent))
+class GIZMOSYSTEM_API UGizmoNetComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	struct FDragState
+	{
+		int32 DragId = INDEX_NONE;
+		TArray<TWeakObjectPtr<USceneComponent>> Targets;
+		TArray<FTransform> StartTransforms;
+		FGizmoDragDelta Settings;
+
+		// Remote clients move Current towards Goal every tick.
+		FGizmoNetDelta Current;
+		FGizmoNetDelta Goal;
+		bool bInterpolate = false;
+	};
+
+	// Drag of this component's player, as seen on this machine.
+	FDragState Drag;
+
+	// Owning client only.
+	// Released drags waiting for ClientConfirmDrag. A rejected one puts its targets back at their start transforms.
+	TArray<FDragState> UnconfirmedDrags;
+	FGizmoNetDelta PendingDelta;
+	bool bHasPendingDelta = false;
+	double LastSendTime = 0;
+	int32 NextDragId = 0;
+
+	virtual bool IsLocallyOwned() const;
+
+	// Server. Movable, resolvable by every client and not owned by another player.
+	virtual bool CanDragTarget(const USceneComponent* Target) const;
+	virtual void StartDragState(int32 DragId, const TArray<USceneComponent*>& Targets, const FGizmoNetDragSettings& Settings);
+	virtual void ApplyDragState(const FGizmoNetDelta& Delta);
+
+	// Rejects target lists over the cap and malformed settings. Each target is checked with CanDragTarget.
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerBeginDrag(int32 DragId, const TArray<USceneComponent*>& Targets, const FGizmoNetDragSettings& Settings);
+
+	UFUNCTION(Server, Unreliable)
+	void ServerUpdateDrag(int32 DragId, const FGizmoNetDelta& Delta);
+
+	UFUNCTION(Server, Reliable)
+	void ServerEndDrag(int32 DragId, const FGizmoNetDelta& Delta);
+
+	UFUNCTION(Client, Reliable)
+	void ClientConfirmDrag(int32 DragId, bool bAccepted);
+
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastBeginDrag(int32 DragId, const TArray<USceneComponent*>& Targets, const FGizmoNetDragSettings& Settings);
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastUpdateDrag(int32 DragId, const FGizmoNetDelta& Delta);
+
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastEndDrag(int32 DragId, const FGizmoNetDelta& Delta);
+
+public:
+
+	UGizmoNetComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Owning client. Called by the gizmo base with the first delta of a drag, which carries the fixed settings.
+	virtual void BeginDrag(const TArray<USceneComponent*>& Targets, const FGizmoDragDelta& Delta);
+
+	// Owning client. Latest cumulative delta, sent on the next tick the rate allows.
+	virtual void UpdateDrag(const FGizmoDragDelta& Delta);
+
+	// Owning client. Sends the final delta reliably.
+	virtual void EndDrag();
+
+	static UGizmoNetComponent* FindForController(const APlayerController* PlayerController);
+
+	// Unreliable updates per second while dragging.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	float SendRate = 20;
+
+	// How tightly remote clients follow the dragging client. Higher is tighter but shows more of the network jitter.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	float InterpolationSpeed = 15;
+
+};
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SceneViewExtension.h"
+#include "LateUpdateManager.h"
+
+#include "Math/Gizmo_Math_Solver.h"
+
+class FGizmoInputProcessor;
+class FSceneInterface;
+
+// Constraint state a gizmo hands to the render thread once per frame.
+struct GIZMOSYSTEM_API FGizmoLateLatchParams
+{
+	bool bIsActive = false;
+
+	// Gizmo root transform as committed by the game thread this frame.
+	FTransform CommittedTransform = FTransform::Identity;
+
+	// Gizmo root location and cursor position when the drag started.
+	FVector GrabGizmoLocation = FVector::ZeroVector;
+	FVector2D GrabMousePosition = FVector2D::ZeroVector;
+
+	// Screen axis solver (local move) or ray-plane solver (world move), same as the game thread.
+	bool bUseScreenAxis = false;
+	FGizmoScreenAxis ScreenAxis;
+	FGizmoConstraintPlane Constraint;
+	FVector GrabPoint = FVector::ZeroVector;
+
+	// Maps the processor's desktop cursor position into viewport space.
+	FVector2D ScreenToViewport = FVector2D::ZeroVector;
+
+	// Used when no newer cursor position is available on the render thread.
+	FVector2D MousePosition = FVector2D::ZeroVector;
+
+	FSceneInterface* Scene = nullptr;
+};
+
+// Re-solves the gizmo placement on the render thread with the newest cursor position and moves the already submitted gizmo primitives there, like XR late latching.
+// Targets are not touched, the game thread still commits their authoritative transforms.
+class GIZMOSYSTEM_API FGizmoLateLatchExtension : public FSceneViewExtensionBase
+{
+public:
+
+	FGizmoLateLatchExtension(const FAutoRegister& AutoRegister, TSharedPtr<FGizmoInputProcessor> In_InputProcessor);
+
+	// Game thread. Component whose primitive tree is late updated and the parameters to solve with.
+	void SetParams(USceneComponent* In_GizmoRoot, const FGizmoLateLatchParams& In_Params);
+
+	virtual void SetupViewFamily(FSceneViewFamily& InViewFamily) override;
+	virtual void SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView) override;
+	virtual void BeginRenderViewFamily(FSceneViewFamily& InViewFamily) override;
+	virtual void PreRenderViewFamily_RenderThread(FRDGBuilder& GraphBuilder, FSceneViewFamily& InViewFamily) override;
+
+protected:
+
+	virtual bool IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const override;
+
+private:
+
+	FLateUpdateManager LateUpdate;
+
+	TWeakObjectPtr<USceneComponent> GizmoRoot;
+	TWeakPtr<FGizmoInputProcessor> InputProcessor;
+
+	FGizmoLateLatchParams GameThreadParams;
+	FGizmoLateLatchParams RenderThreadParams;
+
+};
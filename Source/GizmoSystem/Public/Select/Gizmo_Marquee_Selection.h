@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FGizmoViewState;
+class UPrimitiveComponent;
+
+/*
+* Rectangle selection. Bounds of all selectable primitives are gathered once per marquee into packed per-axis arrays,
+* then every update tests four boxes per register against the planes of the sub-frustum under the rectangle.
+* Boxes crossing a plane can be refined against UCustomCollision corners and static mesh triangles.
+*/
+class GIZMOSYSTEM_API FGizmoMarqueeSelection
+{
+public:
+
+	// Bounds are stored relative to Origin, so float precision holds far from the world origin.
+	void Gather(const UWorld* World, const FVector& In_Origin, TFunctionRef<bool(const UPrimitiveComponent*)> Filter);
+
+	// Primitives touching the rectangle between Start and End in viewport space.
+	int32 Select(const FGizmoViewState& View, const FVector2D& Start, const FVector2D& End, bool bRefine, TArray<UPrimitiveComponent*>& Out_Components) const;
+
+	void Reset();
+	bool IsEmpty() const;
+	int32 Num() const;
+
+	// Near and side planes of the sub-frustum, normals pointing out.
+	static bool BuildFrustum(const FGizmoViewState& View, const FVector2D& Start, const FVector2D& End, TArray<FPlane, TInlineAllocator<6>>& Out_Planes);
+
+private:
+
+	// True when the primitive's own geometry, not just its box, is on the inner side of every plane.
+	bool Refine(const UPrimitiveComponent* Component, TConstArrayView<FPlane> Planes) const;
+
+	// One entry per primitive, padded with zeros to a multiple of four.
+	TArray<float, TAlignedHeapAllocator<16>> CenterX;
+	TArray<float, TAlignedHeapAllocator<16>> CenterY;
+	TArray<float, TAlignedHeapAllocator<16>> CenterZ;
+	TArray<float, TAlignedHeapAllocator<16>> ExtentX;
+	TArray<float, TAlignedHeapAllocator<16>> ExtentY;
+	TArray<float, TAlignedHeapAllocator<16>> ExtentZ;
+
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> Components;
+	FVector Origin = FVector::ZeroVector;
+	int32 NumBounds = 0;
+};
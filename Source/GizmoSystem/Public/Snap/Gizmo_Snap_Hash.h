@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
+
+struct FGizmoViewState;
+
+struct FGizmoSnapCandidate
+{
+	FVector Location = FVector::ZeroVector;
+
+	// Distance to the query position in pixels, and along the cursor ray.
+	double ScreenDistance = 0;
+	double Depth = 0;
+
+	uint32 SourceId = 0;
+};
+
+/*
+* Uniform grid of snap points, grouped by source so a moved or removed source only touches its own cells.
+* A coarse grid counts the occupied cells of each block of cells, so queries skip empty space without probing every cell.
+* Kept twice. Updates are serialized and applied to the buffer queries are not reading, then queries move over to it and the other buffer catches up.
+* Queries never wait: while an update holds the newest buffer they read the previous one.
+*/
+class GIZMOSYSTEM_API FGizmoSnapHash
+{
+public:
+
+	explicit FGizmoSnapHash(double InCellSize = 200);
+
+	FGizmoSnapHash(const FGizmoSnapHash&) = delete;
+	FGizmoSnapHash& operator=(const FGizmoSnapHash&) = delete;
+
+	// Replaces every point of SourceId. Points are bucketed before the lock is taken.
+	void SetSource(uint32 SourceId, TConstArrayView<FVector> Points);
+	void RemoveSource(uint32 SourceId);
+	void Reset();
+
+	/*
+	* Up to MaxCandidates points within PixelRadius of ScreenPosition, nearest on screen first.
+	* Only cells inside the pixel cone around the cursor ray and inside the occupied bounds are visited, blocks of empty cells are skipped,
+	* and the walk stops once MaxCandidates are found and it is past the nearest of them.
+	*/
+	int32 QueryScreen(const FGizmoViewState& View, const FVector2D& ScreenPosition, double PixelRadius, double MaxDistance, int32 MaxCandidates, const TSet<uint32>& ExcludedSources, TArray<FGizmoSnapCandidate>& Out_Candidates) const;
+
+	int32 GetNumPoints() const;
+	double GetCellSize() const;
+
+private:
+
+	struct FEntry
+	{
+		FVector Location;
+		uint32 SourceId;
+	};
+
+	struct FBuffer
+	{
+		TMap<FIntVector, TArray<FEntry>> Cells;
+		TMap<uint32, TArray<FIntVector>> SourceCells;
+
+		// Occupied cells per block of cells.
+		TMap<FIntVector, int32> Blocks;
+		int32 NumPoints = 0;
+
+		// Cells that held a point since the buffer was last empty. Not shrunk on removal, so only ever too large.
+		FIntVector OccupiedMin = FIntVector(MAX_int32);
+		FIntVector OccupiedMax = FIntVector(MIN_int32);
+
+		mutable FRWLock Lock;
+	};
+
+	FIntVector ToCell(const FVector& Location) const;
+
+	// Applies Update to both buffers, the one queries do not read first.
+	void Write(TFunctionRef<void(FBuffer&)> Update);
+
+	static void AddEntries(FBuffer& Buffer, const FIntVector& Cell, TConstArrayView<FEntry> Entries);
+	static void RemoveSourceLocked(FBuffer& Buffer, uint32 SourceId);
+
+	FBuffer Buffers[2];
+	std::atomic<int32> ReadIndex = 0;
+	FCriticalSection WriteMutex;
+
+	double CellSize = 200;
+	double InvCellSize = 1.0 / 200;
+};
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Pipe.h"
+
+#include "Snap/Gizmo_Snap_Hash.h"
+
+#include "Gizmo_Snap_Subsystem.generated.h"
+
+class UStaticMesh;
+
+/*
+* Keeps a spatial hash of snap points for the whole world: static mesh vertices and sockets, and UCustomCollision corners.
+* Sources are gathered on the game thread, transformed and bucketed on a background pipe. Movable sources are re-queued when they move,
+* and moves that arrive while a batch is running are coalesced into the next one. Dragged sources are suspended and re-queued once on release.
+*/
+UCLASS()
+class GIZMOSYSTEM_API UGizmoSnapSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	// Local points of one mesh. After creation only the pipe touches them.
+	struct FMeshPoints
+	{
+		TArray<FVector3f> Points;
+		bool bDeduplicated = false;
+	};
+
+	struct FSourceUpdate
+	{
+		uint32 SourceId = 0;
+		bool bRemove = false;
+		FTransform Transform;
+		TSharedPtr<FMeshPoints, ESPMode::ThreadSafe> Mesh;
+		TArray<FVector> LocalPoints;
+	};
+
+	TSharedPtr<FGizmoSnapHash, ESPMode::ThreadSafe> Hash;
+	UE::Tasks::FPipe Pipe{ TEXT("GizmoSnapHash") };
+	UE::Tasks::FTask PendingTask;
+
+	TMap<TObjectKey<UStaticMesh>, TSharedPtr<FMeshPoints, ESPMode::ThreadSafe>> MeshPoints;
+	TMap<uint32, TWeakObjectPtr<USceneComponent>> Sources;
+	TSet<uint32> DirtySources;
+	TSet<uint32> RemovedSources;
+
+	// Sources of the current drag. Their moves are held back, so the pipe does not take the write lock under every drag query.
+	TSet<uint32> SuspendedSources;
+	TSet<uint32> SuspendedDirtySources;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle ActorDestroyedHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+	virtual void AddActor(AActor* Actor);
+	virtual void RemoveActor(AActor* Actor);
+	virtual void OnLevelAdded(ULevel* Level, UWorld* InWorld);
+	virtual void OnLevelRemoved(ULevel* Level, UWorld* InWorld);
+	virtual bool IsSnapSource(const USceneComponent* Component) const;
+	virtual bool GatherSource(USceneComponent* Component, FSourceUpdate& Out_Update);
+	virtual void OnSourceMoved(USceneComponent* Component, EUpdateTransformFlags Flags, ETeleportType Teleport);
+	virtual void FlushUpdates();
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	UFUNCTION(BlueprintCallable)
+	virtual void RegisterSnapComponent(USceneComponent* Component);
+
+	UFUNCTION(BlueprintCallable)
+	virtual void UnregisterSnapComponent(USceneComponent* Component);
+
+	// Re-reads the points of a registered component on the next tick, e.g. after its corners changed.
+	virtual void MarkDirty(const USceneComponent* Component);
+
+	// Holds back the updates of SourceIds until ResumeSources. Replaces the previous set, whose moved sources are re-queued.
+	virtual void SuspendSources(const TSet<uint32>& SourceIds);
+
+	// Re-queues every suspended source that moved meanwhile.
+	virtual void ResumeSources();
+
+	// Nearest snap points on screen within PixelRadius of ScreenPosition. Never waits for a running update.
+	virtual int32 FindSnapCandidates(const FGizmoViewState& View, const FVector2D& ScreenPosition, float PixelRadius, int32 MaxCandidates, const TSet<uint32>& ExcludedSources, TArray<FGizmoSnapCandidate>& Out_Candidates) const;
+
+	UFUNCTION(BlueprintPure)
+	virtual int32 GetNumSnapPoints() const;
+
+protected:
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+};
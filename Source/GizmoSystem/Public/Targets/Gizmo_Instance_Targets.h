@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+
+#include "Gizmo_Instance_Targets.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+// Instances of one instanced or hierarchical instanced static mesh component, manipulated like any other target.
+USTRUCT(BlueprintType)
+struct GIZMOSYSTEM_API FGizmoInstanceTarget
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	UInstancedStaticMeshComponent* Component = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<int32> InstanceIndices;
+};
+
+/*
+* Drag state of instance targets. Selected indices are split into runs with small gaps, and every frame each changed run gets one BatchUpdateInstancesTransforms call.
+* Collision and navigation of a component are suspended when the drag first moves one of its instances and restored on release.
+* Suspending destroys the physics bodies of every instance of the component and restoring recreates them, so a drag of a few instances
+* of a very large component pays that once on grab and once on release. A click that moves nothing pays neither.
+*/
+class GIZMOSYSTEM_API FGizmoInstanceDrag
+{
+public:
+
+	// Captures world transforms of all valid instances. Indices are sorted and merged per component.
+	void Begin(TConstArrayView<FGizmoInstanceTarget> Targets);
+
+	// Calls Solver with each instance's start transform. Components with no changed instance are not written. Returns the number of changed instances.
+	int32 Apply(TFunctionRef<FTransform(const FTransform&)> Solver);
+
+	// Writes the final transforms as a teleport and restores collision, navigation and the HISM tree.
+	void End();
+
+	bool IsEmpty() const;
+	int32 GetNumInstances() const;
+
+	// Sum of all start locations, for the selection center.
+	FVector GetStartLocationSum() const;
+
+private:
+
+	// Selected instances close enough to each other to be written with a single call.
+	struct FRun
+	{
+		// Every instance from the first to the last selected one of the run. Unselected instances in the gaps keep their transform from Begin.
+		int32 StartIndex = 0;
+		TArray<FTransform> Transforms;
+
+		// Selected instances as offsets into Transforms, and their start transforms.
+		TArray<int32> Offsets;
+		TArray<FTransform> StartTransforms;
+
+		bool bDirty = false;
+	};
+
+	struct FBatch
+	{
+		TWeakObjectPtr<UInstancedStaticMeshComponent> Component;
+
+		// Ordered by instance index. Only runs that changed are written each frame.
+		TArray<FRun> Runs;
+
+		TEnumAsByte<ECollisionEnabled::Type> CollisionEnabled = ECollisionEnabled::NoCollision;
+		bool bAffectedNavigation = false;
+		bool bWritten = false;
+	};
+
+	TArray<FBatch> Batches;
+};
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Gizmo_Enums.h"
+
+#include "Gizmo_Spline_Targets.generated.h"
+
+class USplineComponent;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FGizmoSplineCommitted, USplineComponent*, Spline);
+
+// Control points or tangent handles of one spline, manipulated like any other target.
+USTRUCT(BlueprintType)
+struct GIZMOSYSTEM_API FGizmoSplineTarget
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	USplineComponent* Component = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<int32> PointIndices;
+
+	// Tangent handles sit at the point plus the leave tangent, or minus the arrive tangent. Both tangents are kept mirrored.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	EGizmoSplineHandle Handle = EGizmoSplineHandle::Point;
+};
+
+/*
+* Drag state of spline targets. Point data is written straight into the spline curves and only auto tangents next to edited points are re-evaluated.
+* Reparameterization, UpdateSpline and anything built on the spline wait for End, which runs once per drag.
+*/
+class GIZMOSYSTEM_API FGizmoSplineDrag
+{
+public:
+
+	// Captures world space handles of all valid points.
+	void Begin(TConstArrayView<FGizmoSplineTarget> Targets);
+
+	// Calls Solver with each handle's start transform and writes the changed points. Returns how many were written.
+	int32 Apply(TFunctionRef<FTransform(const FTransform&)> Solver);
+
+	// Rebuilds each edited spline once and returns them, so dependent spline meshes can follow.
+	void End(TArray<USplineComponent*>* Out_Splines = nullptr);
+
+	int32 GetNumHandles() const;
+
+	// Sum of all start locations, for the selection center.
+	FVector GetStartLocationSum() const;
+
+	// World transform of a handle, as dragged by the gizmo.
+	static bool GetHandleTransform(const USplineComponent* Spline, int32 PointIndex, EGizmoSplineHandle Handle, FTransform& Out_Transform);
+
+private:
+
+	struct FHandle
+	{
+		int32 PointIndex = 0;
+		EGizmoSplineHandle Type = EGizmoSplineHandle::Point;
+		FTransform StartTransform;
+		FTransform Transform;
+
+		// Local space point data at drag start.
+		FVector StartArriveTangent = FVector::ZeroVector;
+		FVector StartLeaveTangent = FVector::ZeroVector;
+		FQuat StartRotation = FQuat::Identity;
+		TEnumAsByte<EInterpCurveMode> StartInterpMode = CIM_CurveAuto;
+	};
+
+	struct FBatch
+	{
+		TWeakObjectPtr<USplineComponent> Component;
+		TArray<FHandle> Handles;
+		bool bWritten = false;
+	};
+
+	TArray<FBatch> Batches;
+
+	// Reused between frames.
+	TArray<int32> DirtyPoints;
+};
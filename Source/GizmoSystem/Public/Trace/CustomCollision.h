@@ -42,6 +42,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Custom Collision")
     virtual TArray<FVector> GeneratePyramidVertices(float Height, FVector2D BaseSize);
 
+    // Outward faces of the convex hull of Corners in local space, read from the cooked collision. A point is inside when it is behind every plane.
+    void GetHullPlanes(TArray<FPlane>& Out_Planes);
+
 protected:
 
     FVector Default_Extents = FVector(50.f, 50.f, 50.f);
@@ -4,12 +4,21 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "WorldCollision.h"
 
 #include "Gizmo_Includes.h"
 #include "Gizmo_Enums.h"
+#include "Math/Gizmo_Math_Solver.h"
 
 #include "Gizmo_Trace_Move.generated.h"
 
+class AGizmoMathBase;
+
+/*
+* Move gizmo driven by asynchronous traces. Axis picking and the drag point are queried with AsyncLineTraceByChannel
+* and read on the following tick, so the game thread never waits for the physics scene.
+* Spawned by a gizmo base it moves the base's targets through the same drag delta as the math gizmos, otherwise it moves Target.
+*/
 UCLASS()
 class GIZMOSYSTEM_API AGizmoTraceMove : public AActor
 {
@@ -20,6 +29,53 @@ protected:
     virtual void BeginPlay() override;
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+    APlayerController* PlayerController = nullptr;
+
+    // View and cursor of this tick. Taken from the base's input frame when there is one.
+    FGizmoViewState View;
+    FVector2D MousePosition = FVector2D::ZeroVector;
+    bool bMouseDown = false;
+
+    // Results of traces issued with an older generation are dropped. Bumped on grab and release.
+    uint32 TraceGeneration = 0;
+    FTraceDelegate PickTraceDelegate;
+    FTraceDelegate DragTraceDelegate;
+
+    // Set by the trace delegates, consumed on the next tick.
+    bool bPickResultReady = false;
+    TWeakObjectPtr<UPrimitiveComponent> PickedAxis;
+    FVector PickedLocation = FVector::ZeroVector;
+
+    bool bDragResultHit = false;
+    FVector DragHitLocation = FVector::ZeroVector;
+
+    // Drag state captured on grab.
+    FGizmoConstraintPlane GrabConstraint;
+    FVector GrabPoint = FVector::ZeroVector;
+    FTransform GrabTargetTransform = FTransform::Identity;
+
+    // Surface point minus the ray-axis point on the last tick over a surface. Kept when the cursor leaves it, so the target does not jump.
+    FVector SurfaceOffset = FVector::ZeroVector;
+    bool bIsDragging = false;
+
+    virtual bool CaptureView();
+    virtual bool HasTarget() const;
+    virtual FTransform GetTargetTransform() const;
+    virtual FVector GetAxisVector(ESelectedAxis Axis) const;
+    virtual ESelectedAxis GetAxisEnum(const UPrimitiveComponent* Axis) const;
+    virtual void SetupAxis(UStaticMeshComponent* Axis);
+    virtual void GetQueryParams(FCollisionQueryParams& Out_Params, bool bIgnoreSelf) const;
+
+    virtual void IssuePickTrace();
+    virtual void IssueDragTrace();
+    virtual void OnPickTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+    virtual void OnDragTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+    virtual void BeginGrab();
+    virtual void UpdateDrag();
+    virtual void EndGrab();
+    virtual void Track();
+
 public:
 
     AGizmoTraceMove();
@@ -28,6 +84,7 @@ public:
     UPROPERTY(VisibleAnywhere)
     USceneComponent* Root;
 
+    // Moved when the gizmo is not spawned by a gizmo base.
     UPROPERTY(BlueprintReadWrite, EditDefaultsOnly)
     USceneComponent* Target;
 
@@ -40,4 +97,20 @@ public:
     UPROPERTY(BlueprintReadWrite, EditDefaultsOnly)
     UStaticMeshComponent* ZAxis;
 
-};
\ No newline at end of file
+    UPROPERTY(BlueprintReadOnly)
+    AGizmoMathBase* GizmoBase = nullptr;
+
+    UPROPERTY(BlueprintReadOnly)
+    ESelectedAxis AxisEnum = ESelectedAxis::Null_Axis;
+
+    // Axes overlap this channel, the drag trace is blocked by it.
+    UPROPERTY(BlueprintReadWrite, EditAnywhere)
+    TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+    UPROPERTY(BlueprintReadWrite, EditAnywhere)
+    float TraceDistance = 1000000;
+
+    UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ExposeOnSpawn = "true"))
+    bool bMoveLocal = false;
+
+};